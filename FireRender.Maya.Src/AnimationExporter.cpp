@@ -15,17 +15,65 @@
 #include <maya/MPlugArray.h>
 #include <maya/MAnimControl.h>
 
+#include <algorithm>
+#include <cmath>
+
 const int COMPONENT_COUNT_ROTATION = 4;
 const int COMPONENT_COUNT_TRANSLATION = 3;
 const int COMPONENT_COUNT_SCALE = 3;
 
 const int INPUT_PLUG_COUNT = 3;
 
+namespace
+{
+	// Angle in degrees between the rotation slerped from a to b at t and the rotation c (quaternions are x, y, z, w)
+	float SlerpAngleError(const float* a, const float* b, float t, const float* c)
+	{
+		double dot = (double)a[0] * b[0] + (double)a[1] * b[1] + (double)a[2] * b[2] + (double)a[3] * b[3];
+
+		// Shortest path, as the players interpolate
+		double sign = dot < 0.0 ? -1.0 : 1.0;
+		dot = std::min(std::fabs(dot), 1.0);
+
+		double wa = 1.0 - t;
+		double wb = t;
+
+		double theta = std::acos(dot);
+		if (theta > 1e-6)
+		{
+			double sinTheta = std::sin(theta);
+			wa = std::sin((1.0 - t) * theta) / sinTheta;
+			wb = std::sin(t * theta) / sinTheta;
+		}
+
+		double q[4];
+		double length = 0.0;
+		for (int i = 0; i < 4; ++i)
+		{
+			q[i] = wa * a[i] + wb * sign * b[i];
+			length += q[i] * q[i];
+		}
+
+		length = std::sqrt(length);
+		if (length <= 0.0)
+		{
+			return 180.0f;
+		}
+
+		double cosHalfAngle = std::fabs(q[0] * c[0] + q[1] * c[1] + q[2] * c[2] + q[3] * c[3]) / length;
+		return (float)(2.0 * std::acos(std::min(cosHalfAngle, 1.0)) * 180.0 / M_PI);
+	}
+}
+
 frw::RPRSContext g_exportContext;
 
 AnimationExporter::AnimationExporter(bool gltfExport) :
 	m_IsGLTFExport(gltfExport),
-	m_progressBars(nullptr)
+	m_progressBars(nullptr),
+	m_translationTolerance(0.0f),
+	m_rotationTolerance(0.0f),
+	m_scaleTolerance(0.0f),
+	m_resampleStep(0.0)
 {
 	if (m_IsGLTFExport)
 	{
@@ -408,24 +456,26 @@ int AnimationExporter::GetOutputComponentCount(int attrId)
 	}
 	else if (attrId == m_runtimeMoveTypeRotation)
 	{
-		return COMPONENT_COUNT_SCALE;
+		return COMPONENT_COUNT_ROTATION;
 	}
 	else if (attrId == m_runtimeMoveTypeScale)
 	{
-		return COMPONENT_COUNT_ROTATION;
+		return COMPONENT_COUNT_SCALE;
 	}
 
 	assert(false);
 	return 0;
 }
 
-void AnimationExporter::AddTimesFromCurve(const MFnAnimCurve& curve, TimeKeySet& outUniqueTimeKeySet, int attributeId)
+void AnimationExporter::AddTimesFromCurve(const MFnAnimCurve& curve, CurveKeyTimeVector& outKeyTimes, int attributeId, int attributeIndex)
 {
 	int keyCount = curve.numKeys();
 
 	MTime startTime = MAnimControl::animationStartTime();
 	MTime endTime = MAnimControl::animationEndTime();
 
+	outKeyTimes.reserve(outKeyTimes.size() + keyCount + 2);
+
 	for (int keyIndex = 0; keyIndex < keyCount; ++keyIndex)
 	{
 		MTime time = curve.time(keyIndex);
@@ -435,34 +485,27 @@ void AnimationExporter::AddTimesFromCurve(const MFnAnimCurve& curve, TimeKeySet&
 			continue;
 		}
 
-		AddOneTimePoint(time, curve, outUniqueTimeKeySet, attributeId, keyIndex);
+		AddOneTimePoint(time, curve, outKeyTimes, attributeId, attributeIndex, keyIndex);
 	}
 
 	// Add auto point for the start and end animation point
-	AddOneTimePoint(startTime, curve, outUniqueTimeKeySet, attributeId, 0);
-	AddOneTimePoint(endTime, curve, outUniqueTimeKeySet, attributeId, keyCount - 1);
+	AddOneTimePoint(startTime, curve, outKeyTimes, attributeId, attributeIndex, 0);
+	AddOneTimePoint(endTime, curve, outKeyTimes, attributeId, attributeIndex, keyCount - 1);
 }
 
-void AnimationExporter::AddOneTimePoint(const MTime time, const MFnAnimCurve& curve, TimeKeySet& outUniqueTimeKeySet, int attributeId, int keyIndex)
+void AnimationExporter::AddOneTimePoint(const MTime time, const MFnAnimCurve& curve, CurveKeyTimeVector& outKeyTimes, int attributeId, int attributeIndex, int keyIndex)
 {
-	TimeKeyStruct timeKey(time, attributeId);
-
-	TimeKeySet::iterator it = outUniqueTimeKeySet.find(timeKey);
-	if (it != outUniqueTimeKeySet.end())
-	{
-		it->AddNewAttribute(attributeId);
-	}
-	else
-	{
-		it = outUniqueTimeKeySet.insert(timeKey).first;
-	}
+	unsigned int attributeMask = 1u << attributeIndex;
 
 	// if we process rotation attribute we should as translation as well because in some complex rotations translation might be changed as well
+	// translation is always the first attribute in the export order
 	if (attributeId == m_runtimeMoveTypeRotation)
 	{
-		it->AddNewAttribute(m_runtimeMoveTypeTranslation);
+		attributeMask |= 1u;
 	}
 
+	outKeyTimes.push_back({ time, attributeMask, false });
+
 	// keys autogeneration for rotation
 	if ((attributeId == m_runtimeMoveTypeRotation) && (keyIndex > 0))
 	{
@@ -476,23 +519,232 @@ void AnimationExporter::AddOneTimePoint(const MTime time, const MFnAnimCurve& cu
 		while (currentValue < maxValue)
 		{
 			MTime additionalTimePoint = prevTime + (maxTime - prevTime) * (currentValue - minValue) / (maxValue - minValue);
-			outUniqueTimeKeySet.insert(TimeKeyStruct(additionalTimePoint, attributeId));
+			outKeyTimes.push_back({ additionalTimePoint, 1u << attributeIndex, true });
 
 			currentValue += step;
 		}
 	}
 }
 
-inline float AnimationExporter::GetValueForTime(const MPlug& plug, const MFnAnimCurve& curve, const MTime& time)
+void AnimationExporter::MergeKeyTimes(CurveKeyTimeVector& keyTimes, MergedKeyTimeVector& outMergedKeys)
+{
+	// Stable sort keeps the gathering order for keys with equal time, so the first key of each run is the one which was gathered first
+	std::stable_sort(keyTimes.begin(), keyTimes.end(), [](const CurveKeyTime& lhs, const CurveKeyTime& rhs)
+	{
+		return lhs.time < rhs.time;
+	});
+
+	outMergedKeys.clear();
+	outMergedKeys.reserve(keyTimes.size());
+
+	size_t runStart = 0;
+	while (runStart < keyTimes.size())
+	{
+		const CurveKeyTime& firstKey = keyTimes[runStart];
+
+		// Autogenerated key only creates a new key, it never extends attributes of the existing one
+		unsigned int attributeMask = firstKey.autoGenerated ? firstKey.attributeMask : 0;
+
+		size_t runEnd = runStart;
+		for (; runEnd < keyTimes.size() && !(firstKey.time < keyTimes[runEnd].time); ++runEnd)
+		{
+			if (!keyTimes[runEnd].autoGenerated)
+			{
+				attributeMask |= keyTimes[runEnd].attributeMask;
+			}
+		}
+
+		outMergedKeys.push_back({ firstKey.time, attributeMask });
+		runStart = runEnd;
+	}
+}
+
+void AnimationExporter::ResampleKeyTimes(MergedKeyTimeVector& inOutMergedKeys)
 {
-	if (!curve.object().isNull())
+	if (m_resampleStep <= 0.0 || inOutMergedKeys.empty())
 	{
-		return (float)curve.evaluate(time);
+		return;
 	}
-	else
+
+	unsigned int attributeMask = 0;
+	for (const MergedKeyTime& key : inOutMergedKeys)
+	{
+		attributeMask |= key.attributeMask;
+	}
+
+	MTime startTime = MAnimControl::animationStartTime();
+	MTime endTime = MAnimControl::animationEndTime();
+	MTime step(m_resampleStep, MTime::uiUnit());
+
+	inOutMergedKeys.clear();
+
+	for (MTime time = startTime; time < endTime; time += step)
+	{
+		inOutMergedKeys.push_back({ time, attributeMask });
+	}
+
+	inOutMergedKeys.push_back({ endTime, attributeMask });
+}
+
+void AnimationExporter::SampleTransformAtKeys(const MPlug& matrixPlug, const MergedKeyTimeVector& keys, int attributeCount, AnimationDataHolderStruct* outDataHolders)
+{
+	for (int attributeIndex = 0; attributeIndex < attributeCount; ++attributeIndex)
+	{
+		outDataHolders[attributeIndex].m_timePoints.reserve(keys.size());
+		outDataHolders[attributeIndex].m_values.reserve(keys.size() * COMPONENT_COUNT_ROTATION);
+	}
+
+	float coeff = GetSceneUnitsConversionCoefficient();
+
+	// this is just for progress reporting
+	size_t dataChunkIndex = 0;
+
+	// Transform is evaluated only once per key time and shared between all exported attributes
+	for (const MergedKeyTime& key : keys)
+	{
+		dataChunkIndex++;
+
+		if (key.attributeMask == 0)
+		{
+			continue;
+		}
+
+		MDGContext dgContext(key.time);
+
+		MObject val;
+		matrixPlug.getValue(val, dgContext);
+		MTransformationMatrix transformMatrix(MFnMatrixData(val).matrix());
+
+		float timePoint = (float)key.time.as(MTime::Unit::kSeconds);
+
+		for (int attributeIndex = 0; attributeIndex < attributeCount; ++attributeIndex)
+		{
+			if ((key.attributeMask & (1u << attributeIndex)) == 0)
+			{
+				continue;
+			}
+
+			AnimationDataHolderStruct& dataHolderStruct = outDataHolders[attributeIndex];
+			dataHolderStruct.m_timePoints.push_back(timePoint);
+
+			if (attributeIndex == 0)
+			{
+				MVector vec1 = transformMatrix.getTranslation(MSpace::kTransform);
+				//cm to m
+				dataHolderStruct.m_values.push_back((float)vec1.x * coeff);
+				dataHolderStruct.m_values.push_back((float)vec1.y * coeff);
+				dataHolderStruct.m_values.push_back((float)vec1.z * coeff);
+			}
+			else if (attributeIndex == 1)
+			{
+				MQuaternion rotation = transformMatrix.rotation();
+				dataHolderStruct.m_values.push_back((float)rotation.x);
+				dataHolderStruct.m_values.push_back((float)rotation.y);
+				dataHolderStruct.m_values.push_back((float)rotation.z);
+				dataHolderStruct.m_values.push_back((float)rotation.w);
+			}
+			else
+			{
+				double scale[3];
+				transformMatrix.getScale(scale, MSpace::kTransform);
+
+				dataHolderStruct.m_values.push_back((float)scale[0]);
+				dataHolderStruct.m_values.push_back((float)scale[1]);
+				dataHolderStruct.m_values.push_back((float)scale[2]);
+			}
+		}
+
+		if (m_progressBars != nullptr && m_progressBars->isCancelled())
+		{
+			throw ExportCancelledException();
+		}
+
+		if (dataChunkIndex % 100 == 0)
+		{
+			ReportDataChunk(dataChunkIndex, keys.size());
+		}
+	}
+}
+
+void AnimationExporter::ReduceKeys(AnimationDataHolderStruct& dataHolderStruct, size_t componentCount, bool isRotation, float tolerance)
+{
+	std::vector<float>& times = dataHolderStruct.m_timePoints;
+	std::vector<float>& values = dataHolderStruct.m_values;
+
+	size_t keyCount = times.size();
+
+	if (tolerance <= 0.0f || keyCount < 3)
+	{
+		return;
+	}
+
+	// Key can be dropped if all keys between the anchor (last kept key) and the candidate
+	// are reproduced by the interpolation of the segment within the tolerance
+	auto fitsSegment = [&](size_t anchor, size_t candidate)
+	{
+		float duration = times[candidate] - times[anchor];
+		if (duration <= 0.0f)
+		{
+			return false;
+		}
+
+		const float* anchorValues = &values[anchor * componentCount];
+		const float* candidateValues = &values[candidate * componentCount];
+
+		for (size_t key = anchor + 1; key < candidate; ++key)
+		{
+			float t = (times[key] - times[anchor]) / duration;
+			const float* keyValues = &values[key * componentCount];
+
+			if (isRotation)
+			{
+				if (SlerpAngleError(anchorValues, candidateValues, t, keyValues) > tolerance)
+				{
+					return false;
+				}
+
+				continue;
+			}
+
+			for (size_t component = 0; component < componentCount; ++component)
+			{
+				float interpolated = anchorValues[component] + (candidateValues[component] - anchorValues[component]) * t;
+
+				if (std::fabs(interpolated - keyValues[component]) > tolerance)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	};
+
+	std::vector<size_t> keptKeys;
+	keptKeys.reserve(keyCount);
+	keptKeys.push_back(0);
+
+	size_t anchor = 0;
+	for (size_t candidate = 2; candidate < keyCount; ++candidate)
+	{
+		if (!fitsSegment(anchor, candidate))
+		{
+			anchor = candidate - 1;
+			keptKeys.push_back(anchor);
+		}
+	}
+
+	keptKeys.push_back(keyCount - 1);
+
+	for (size_t index = 0; index < keptKeys.size(); ++index)
 	{
-		return plug.asFloat();
+		size_t key = keptKeys[index];
+		times[index] = times[key];
+		std::copy(values.begin() + key * componentCount, values.begin() + (key + 1) * componentCount, values.begin() + index * componentCount);
 	}
+
+	times.resize(keptKeys.size());
+	values.resize(keptKeys.size() * componentCount);
 }
 
 void AnimationExporter::AddAnimationToGLTFRPR(AnimationDataHolderStruct& gltfDataHolderStruct, int attrId)
@@ -553,23 +805,19 @@ void AnimationExporter::ApplyAnimationForTransform(const MDagPath& dagPath, Anim
 	MString groupName = GetGroupNameForDagPath(dagPath);
 
 	MFnDependencyNode depNodeTransform(dagPath.transform());
-	MFnTransform fnTransform(dagPath.transform());
 
 	const int inputPlugCount = INPUT_PLUG_COUNT; // it is always x, y, z as inputs
 
 	MStatus status;
 
-	MFnAnimCurve tempCurve;
-
-	TimeKeySet uniqueTimeKeys;
+	// Gather all animation curves of the transform first
+	std::vector<std::pair<int, MObject>> curves;
+	curves.reserve(attrCount * inputPlugCount);
 
-	// Gather Unique key points
 	MString componentNames[inputPlugCount] = { "X", "Y", "Z" };
-	for (int attributeId : attrIds)
+	for (int attributeIndex = 0; attributeIndex < attrCount; ++attributeIndex)
 	{
-		MString attributeName = GetAttributeNameById(attributeId);
-
-		MPlugArray plugArray;
+		MString attributeName = GetAttributeNameById(attrIds[attributeIndex]);
 
 		for (int i = 0; i < inputPlugCount; ++i)
 		{
@@ -581,88 +829,44 @@ void AnimationExporter::ApplyAnimationForTransform(const MDagPath& dagPath, Anim
 				continue;
 			}
 
-			plugArray.append(plug);
 			MObjectArray curveObj;
 
 			if (MAnimUtil::findAnimation(plug, curveObj, &status))
 			{
-				tempCurve.setObject(curveObj[0]);
-				AddTimesFromCurve(tempCurve, uniqueTimeKeys, attributeId);
+				curves.emplace_back(attributeIndex, curveObj[0]);
 			}
 		}
 	}
 
-	MPlug matrixPlug = depNodeTransform.findPlug("matrix", &status);
-
-	size_t keyCount = uniqueTimeKeys.size();
-
-	// this is just for progress reporting
-	size_t dataChunkIndex = 0;
+	// Gather key times of all curves into one vector and merge them
+	CurveKeyTimeVector keyTimes;
+	MFnAnimCurve tempCurve;
 
-	// Export necessary attributes
-	for (int attributeId : attrIds)
+	for (const auto& curve : curves)
 	{
-		dataHolder.emplace(dataHolder.end());
-		AnimationDataHolderStruct& dataHolderStruct = dataHolder.back();
-
-		for (TimeKeySet::iterator it = uniqueTimeKeys.begin(); it != uniqueTimeKeys.end(); it++)
-		{
-			dataChunkIndex++;
-
-			if (!it->DoesAttributeIdPresent(attributeId))
-			{
-				continue;
-			}
-
-			MTime time = it->GetTime();
-			MDGContext dgContext(time);
-
-			MMatrix newMatrix;
-			MObject val;
-
-			matrixPlug.getValue(val, dgContext);
-			newMatrix = MFnMatrixData(val).matrix();
+		tempCurve.setObject(curve.second);
+		AddTimesFromCurve(tempCurve, keyTimes, attrIds[curve.first], curve.first);
+	}
 
-			MTransformationMatrix transformMatrix(newMatrix);
+	MergedKeyTimeVector uniqueTimeKeys;
+	MergeKeyTimes(keyTimes, uniqueTimeKeys);
+	ResampleKeyTimes(uniqueTimeKeys);
 
-			dataHolderStruct.m_timePoints.push_back((float)it->GetTime().as(MTime::Unit::kSeconds));
+	// Evaluate transform once per key for all attributes
+	size_t firstDataHolderIndex = dataHolder.size();
+	dataHolder.resize(firstDataHolderIndex + attrCount);
 
-			if (attributeId == m_runtimeMoveTypeTranslation)
-			{
-				MVector vec1 = transformMatrix.getTranslation(MSpace::kTransform);
-				//cm to m
-				dataHolderStruct.m_values.push_back((float)vec1.x * GetSceneUnitsConversionCoefficient());
-				dataHolderStruct.m_values.push_back((float)vec1.y * GetSceneUnitsConversionCoefficient());
-				dataHolderStruct.m_values.push_back((float)vec1.z * GetSceneUnitsConversionCoefficient());
-			}
-			else if (attributeId == m_runtimeMoveTypeRotation)
-			{
-				MQuaternion rotation = transformMatrix.rotation();
-				dataHolderStruct.m_values.push_back((float)rotation.x);
-				dataHolderStruct.m_values.push_back((float)rotation.y);
-				dataHolderStruct.m_values.push_back((float)rotation.z);
-				dataHolderStruct.m_values.push_back((float)rotation.w);
-			}
-			else if (attributeId == m_runtimeMoveTypeScale)
-			{
-				double scale[3];
-				transformMatrix.getScale(scale, MSpace::kTransform);
-
-				dataHolderStruct.m_values.push_back((float)scale[0]);
-				dataHolderStruct.m_values.push_back((float)scale[1]);
-				dataHolderStruct.m_values.push_back((float)scale[2]);
-			}
+	MPlug matrixPlug = depNodeTransform.findPlug("matrix", &status);
+	SampleTransformAtKeys(matrixPlug, uniqueTimeKeys, attrCount, &dataHolder[firstDataHolderIndex]);
 
-			if (m_progressBars != nullptr && m_progressBars->isCancelled())
-			{
-				throw ExportCancelledException();
-			}
+	// Export necessary attributes
+	for (int attributeIndex = 0; attributeIndex < attrCount; ++attributeIndex)
+	{
+		int attributeId = attrIds[attributeIndex];
+		AnimationDataHolderStruct& dataHolderStruct = dataHolder[firstDataHolderIndex + attributeIndex];
 
-			if (dataChunkIndex % 100 == 0)
-			{
-				ReportDataChunk(dataChunkIndex, attrCount * uniqueTimeKeys.size());
-			}
-		}
+		const float tolerances[attrCount] = { m_translationTolerance, m_rotationTolerance, m_scaleTolerance };
+		ReduceKeys(dataHolderStruct, GetOutputComponentCount(attributeId), attributeIndex == 1, tolerances[attributeIndex]);
 
 		dataHolderStruct.groupName = groupName;
 
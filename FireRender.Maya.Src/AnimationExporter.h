@@ -28,48 +28,26 @@ class ExportCancelledException
 
 };
 
-class TimeKeyStruct
+// Key time gathered from one animation curve.
+// attributeMask holds one bit per exported attribute (bit index is the position of the attribute in the export order)
+struct CurveKeyTime
 {
-public:
-	TimeKeyStruct(MTime time, int attributeId) : m_Time(time)
-	{
-		m_AttributeId.insert(attributeId);
-	}
-
-	bool operator == (const TimeKeyStruct& rhs) const
-	{
-		return m_Time == rhs.m_Time;
-	}
-
-	bool operator < (const TimeKeyStruct& rhs) const
-	{
-		return m_Time < rhs.m_Time;
-	}
-
-
-	// Make modifier as const because of use of mutable m_AttributeId member. It is needed because we need to modify it in a "std::set" container
-	void AddNewAttribute(int attributeId) const
-	{
-		m_AttributeId.insert(attributeId);
-	}
+	MTime time;
+	unsigned int attributeMask;
 
-	bool DoesAttributeIdPresent(int attributeId) const
-	{
-		return m_AttributeId.find(attributeId) != m_AttributeId.end();
-	}
-
-	MTime GetTime() const { return m_Time; }
-	const std::set<int>& GetAttributeSetRef() const { return m_AttributeId; }
+	// Additional keys generated for rotation don't add attributes to a key which was already gathered at the same time
+	bool autoGenerated;
+};
 
-private:
-	MTime m_Time;
+typedef std::vector<CurveKeyTime> CurveKeyTimeVector;
 
-	// Use set of attribute Ids because  RPRGLTF_ANIMATION_MOVEMENTTYPE_TRANSLATION, 
-	// RPRGLTF_ANIMATION_MOVEMENTTYPE_ROTATION, RPRGLTF_ANIMATION_MOVEMENTTYPE_SCALE cannot be combined in a flag mask				
-	mutable std::set<int> m_AttributeId;
+struct MergedKeyTime
+{
+	MTime time;
+	unsigned int attributeMask;
 };
 
-typedef std::set<TimeKeyStruct> TimeKeySet;
+typedef std::vector<MergedKeyTime> MergedKeyTimeVector;
 
 class AnimationExporter
 {
@@ -83,6 +61,18 @@ public:
 
 	void Export(FireRenderContext& context, MDagPathArray* renderableCamera, frw::RPRSContext exportContext);
 
+	// Max allowed deviation of the interpolated value from the dropped key, 0 - keep all keys of the channel.
+	// Translation is in meters, rotation is the angle in degrees between the slerped and the dropped rotation, scale is unitless
+	void SetKeyReductionTolerances(float translation, float rotationDegrees, float scale)
+	{
+		m_translationTolerance = translation;
+		m_rotationTolerance = rotationDegrees;
+		m_scaleTolerance = scale;
+	}
+
+	// Resample animation with fixed step (in frames) instead of using curve keys. 0 - use curve keys
+	void SetResampleStep(double frameStep) { m_resampleStep = frameStep; }
+
 private:
 	struct AnimationDataHolderStruct
 	{
@@ -111,13 +101,18 @@ private:
 	void AssignCameras(DataHolderStruct& dataHolder, FireRenderContext& context);
 	void AssignMeshesAndLights(FireRenderContext& context);
 
-	// addAdditionalKeys param means that we need to add additional keys for Rotation, 
-	void AddTimesFromCurve(const MFnAnimCurve& curve, TimeKeySet& outUniqueTimeKeySet, int attributeId);
+	void AddTimesFromCurve(const MFnAnimCurve& curve, CurveKeyTimeVector& outKeyTimes, int attributeId, int attributeIndex);
+	void AddOneTimePoint(const MTime time, const MFnAnimCurve& curve, CurveKeyTimeVector& outKeyTimes, int attributeId, int attributeIndex, int keyIndex);
+
+	// Sorts gathered key times and merges keys with equal time into one key
+	void MergeKeyTimes(CurveKeyTimeVector& keyTimes, MergedKeyTimeVector& outMergedKeys);
+	void ResampleKeyTimes(MergedKeyTimeVector& inOutMergedKeys);
 
-	void AddOneTimePoint(const MTime time, const MFnAnimCurve& curve, TimeKeySet& outUniqueTimeKeySet, int attributeId, int keyIndex);
+	void SampleTransformAtKeys(const MPlug& matrixPlug, const MergedKeyTimeVector& keys, int attributeCount, AnimationDataHolderStruct* outDataHolders);
+	// Rotation keys are quaternions interpolated with slerp, other channels are interpolated linearly
+	void ReduceKeys(AnimationDataHolderStruct& dataHolderStruct, size_t componentCount, bool isRotation, float tolerance);
 
 	int GetOutputComponentCount(int attrId);
-	inline float GetValueForTime(const MPlug& plug, const MFnAnimCurve& curve, const MTime& time);
 
 	void AddAnimationToGLTFRPR(AnimationDataHolderStruct& gltfDataHolderStruct, int attrId);
 	void AddAnimationToRPRS(AnimationDataHolderStruct& gltfDataHolderStruct, int attrId);
@@ -141,6 +136,11 @@ private:
 	RenderProgressBars* m_progressBars;
 	bool m_IsGLTFExport;
 
+	float m_translationTolerance;
+	float m_rotationTolerance;
+	float m_scaleTolerance;
+	double m_resampleStep;
+
 	DataHolderStruct m_dataHolder;
 
 	int (*m_pFunc_AddExtraCamera) (rpr_camera extraCam);
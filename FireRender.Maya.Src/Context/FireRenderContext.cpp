@@ -43,6 +43,10 @@ limitations under the License.
 #include "FireRenderThread.h"
 #include "FireRenderMaterialSwatchRender.h"
 #include "CompositeWrapper.h"
+#include "PixelKernels.h"
+#include "Tracing.h"
+#include "SyncStats.h"
+#include "Volumes/VDBGridCache.h"
 #include <InstancerMASH.h>
 
 #include <deque>
@@ -97,6 +101,7 @@ FireRenderContext::FireRenderContext() :
 	m_lastRenderResultState(NOT_SET),
 	m_polycountLastRender(0),
 	m_currentIteration(0),
+	m_currentIterationStep(0),
 	m_currentFrame(0),
 	m_progress(0),
 	m_interactive(false),
@@ -425,12 +430,19 @@ void FireRenderContext::updateLimitsFromGlobalData(const FireRenderGlobalsData &
 	setCompletionCriteria(params);
 }
 
+void FireRenderContext::updateVDBGridCacheSize(const FireRenderGlobalsData& globalData)
+{
+	// the cache is shared by all contexts, the last read setting is used
+	VDBGridCache::GetInstance().SetMaxSizeInBytes(size_t(globalData.vdbGridCacheSize) * 1024 * 1024);
+}
+
 bool FireRenderContext::buildScene(bool isViewport, bool glViewport, bool freshen)
 {
 	MAIN_THREAD_ONLY;
 	DebugPrint("FireRenderContext::buildScene()");
 
 	m_globals.readFromCurrentScene();
+	updateVDBGridCacheSize(m_globals);
 
 	// Backdoor for enabling aovs in IPR/Viewport
 	if (isInteractive())
@@ -1140,10 +1152,16 @@ void FireRenderContext::UpdateCompletionCriteriaForSwatch()
 	setCompletionCriteria(completionParams);
 }
 
+int FireRenderContext::GetRenderedIterationCount(float renderCallProgress) const
+{
+	return m_currentIteration + (int)(std::min(std::max(renderCallProgress, 0.0f), 1.0f) * m_currentIterationStep);
+}
+
 void FireRenderContext::render(bool lock)
 {
 	RPR_THREAD_ONLY;
 	LOCKMUTEX((lock ? this : nullptr));
+	RPR_TRACE_ZONE("Render");
 
 	auto context = scope.Context();
 
@@ -1203,6 +1221,7 @@ void FireRenderContext::render(bool lock)
 
 	context.SetParameter(RPR_CONTEXT_ITERATIONS, iterationStep);
 	context.SetParameter(RPR_CONTEXT_FRAMECOUNT, m_currentFrame);
+	m_currentIterationStep = iterationStep;
 
 	ContextWorkProgressData progressData;
 
@@ -1235,6 +1254,7 @@ void FireRenderContext::render(bool lock)
 	}
 
 	m_currentIteration += iterationStep;
+	m_currentIterationStep = 0;
 	m_currentFrame++;
 
 	m_cameraAttributeChanged = false;
@@ -1811,6 +1831,7 @@ RV_PIXEL* FireRenderContext::readFrameBufferSimple(ReadFrameBufferRequestParams&
 void FireRenderContext::readFrameBuffer(ReadFrameBufferRequestParams& params)
 {
 	RPR_THREAD_ONLY;
+	RPR_TRACE_ZONE("Read frame buffer");
 
 	RV_PIXEL* data = readFrameBufferSimple(params);
 
@@ -1824,8 +1845,8 @@ void FireRenderContext::readFrameBuffer(ReadFrameBufferRequestParams& params)
 
 	// Copy the region from the temporary
 	// buffer into supplied pixel memory.
-	// _TODO Investigate if "|| IsDenoiserCreated()" is really necessary?  
-	if (params.UseTempData() || (IsDenoiserCreated()))
+	// Full frame read directly into supplied memory doesn't need a copy.
+	if (data != params.pixels)
 	{
 		copyPixels(params.pixels, data, params.width, params.height, params.region);
 	}
@@ -1848,22 +1869,14 @@ void FireRenderContext::copyPixels(RV_PIXEL* dest, RV_PIXEL* source,
 	const RenderRegion& region) const
 {
 	RPR_THREAD_ONLY;
-	// Get region dimensions.
-	unsigned int regionWidth = region.getWidth();
-	unsigned int regionHeight = region.getHeight();
 
-	for (unsigned int y = 0; y < regionHeight; y++)
-	{
-		unsigned int destIndex = y * regionWidth;
-				
-		unsigned int sourceIndex = 
-			(sourceHeight - (region.top - y) - 1) * sourceWidth + region.left;
-
-		memcpy(&dest[destIndex], &source[sourceIndex], sizeof(RV_PIXEL) * regionWidth);
-	}
+	PixelKernels::CopyRegion((float*)dest, (const float*)source, sourceWidth, sourceHeight, region);
 
 #ifdef _DEBUG
 #ifdef DUMP_PIXELS_SOURCE
+	unsigned int regionWidth = region.getWidth();
+	unsigned int regionHeight = region.getHeight();
+
 	if (debugDump) {
 		static int debugDumpIdx = 0;
 		std::vector<RV_PIXEL> sourcePixels;
@@ -1906,13 +1919,7 @@ void FireRenderContext::combineWithOpacity(RV_PIXEL* pixels, unsigned int size,
 {
 	if (opacityPixels != NULL)
 	{
-		float alpha = 0.0f;
-		for (unsigned int i = 0; i < size; i++)
-		{
-			alpha = opacityPixels[i].r;
-
-			pixels[i].a = alpha;
-		}
+		PixelKernels::MergeOpacity((float*)pixels, (const float*)opacityPixels, size);
 	}
 }
 
@@ -2180,7 +2187,10 @@ void FireRenderContext::updateFromGlobals(bool applyLock)
     
 	auto createFlags = FireMaya::Options::GetContextDeviceFlags(m_RenderType);
 
+	unsigned int previousEnvironmentImageMaxWidth = environmentImageMaxWidth();
+
 	m_globals.readFromCurrentScene();
+	updateVDBGridCacheSize(m_globals);
 	setupContextContourMode(m_globals, createFlags);
 	setupContextHybridParams(m_globals);
 	setupContextAirVolume(m_globals);
@@ -2190,6 +2200,16 @@ void FireRenderContext::updateFromGlobals(bool applyLock)
 	updateLimitsFromGlobalData(m_globals);
 	updateMotionBlurParameters(m_globals);
 
+	// Environment images are generated or loaded again with the new resolution
+	if (previousEnvironmentImageMaxWidth != environmentImageMaxWidth())
+	{
+		if (iblLight)
+			setDirtyObject(iblLight);
+
+		if (skyLight)
+			setDirtyObject(skyLight);
+	}
+
 	m_camera.setType(m_globals.cameraType);
 
 	m_globalsChanged = false;
@@ -2589,6 +2609,9 @@ FireRenderSky* FireRenderContext::CreateSky(const MDagPath& dagPath)
 void FireRenderContext::setDirty()
 {
 	m_dirty = true;
+
+	// render loops wait for changes
+	FireRenderThread::Wake();
 }
 
 
@@ -2714,6 +2737,8 @@ bool FireRenderContext::Freshen(bool lock, std::function<bool()> cancelled)
 
 	LOCKFORUPDATE((lock ? this : nullptr));
 
+	RPR_TRACE_ZONE("Sync");
+
 	m_inRefresh = true;
 
 	updateFromGlobals(false /*applyLock*/);
@@ -2754,6 +2779,7 @@ bool FireRenderContext::Freshen(bool lock, std::function<bool()> cancelled)
 
 	std::deque<std::shared_ptr<FireRenderObject> > meshesToReload; // meshes which would be pre-processed
 	std::deque<std::shared_ptr<FireRenderObject> > meshesToFreshen; // meshes which would be freshened
+	std::deque<std::shared_ptr<FireRenderObject> > physLightsToFreshen; // physical lights which would be freshened in a batch
 
 	while (!m_dirtyObjects.empty())
 	{
@@ -2808,10 +2834,24 @@ bool FireRenderContext::Freshen(bool lock, std::function<bool()> cancelled)
 				continue;
 			}
 
+			if (dynamic_cast<FireRenderPhysLight*>(ptr.get()) != nullptr)
+			{
+				physLightsToFreshen.emplace_back() = ptr;
+
+				continue;
+			}
+
 			DebugPrint("Freshing object");
 
 			UpdateTimeAndTriggerProgressCallback(syncProgressData, ProgressType::ObjectPreSync);
-			ptr->Freshen(shouldCalculateHash);
+			{
+				Tracing::Zone zone("Freshen object");
+				if (zone.IsActive())
+					zone.SetDetail(MFnDependencyNode(ptr->Object()).name().asUTF8());
+
+				SyncStats::ObjectSync objectSync(*ptr, true);
+				ptr->Freshen(shouldCalculateHash);
+			}
 
 			syncProgressData.currentIndex++;
 			UpdateTimeAndTriggerProgressCallback(syncProgressData, ProgressType::ObjectSyncComplete);
@@ -2823,6 +2863,38 @@ bool FireRenderContext::Freshen(bool lock, std::function<bool()> cancelled)
 		}
 	}
 
+	// Lights with identical attributes, like the fixtures of a stadium, share the light data read for the first of them
+	if (physLightsToFreshen.size() > 1)
+	{
+		m_lightDataBatch = std::make_unique<std::map<size_t, PhysicalLightData>>();
+	}
+
+	for (auto it = physLightsToFreshen.begin(); it != physLightsToFreshen.end(); ++it)
+	{
+		FireRenderObject* pLight = it->get();
+
+		UpdateTimeAndTriggerProgressCallback(syncProgressData, ProgressType::ObjectPreSync);
+		{
+			Tracing::Zone zone("Freshen light");
+			if (zone.IsActive())
+				zone.SetDetail(MFnDependencyNode(pLight->Object()).name().asUTF8());
+
+			SyncStats::ObjectSync objectSync(*pLight, true);
+			pLight->Freshen(shouldCalculateHash);
+		}
+
+		syncProgressData.currentIndex++;
+		UpdateTimeAndTriggerProgressCallback(syncProgressData, ProgressType::ObjectSyncComplete);
+
+		if (cancelled())
+		{
+			m_lightDataBatch.reset();
+			return false;
+		}
+	}
+
+	m_lightDataBatch.reset();
+
 	const bool isDeformationMotionBlurEnabled = motionBlur() && IsDeformationMotionBlurEnabled() && !isInteractive();
 	const unsigned int motionSamplesCount = isDeformationMotionBlurEnabled ? motionSamples() : 1;
 
@@ -2841,6 +2913,11 @@ bool FireRenderContext::Freshen(bool lock, std::function<bool()> cancelled)
 				continue;
 			}
 
+			Tracing::Zone zone("Reload mesh");
+			if (zone.IsActive())
+				zone.SetDetail(MFnDependencyNode(it->get()->Object()).name().asUTF8());
+
+			SyncStats::ObjectSync objectSync(*it->get(), false);
 			const bool success = it->get()->ReloadMesh(currentSampeIdx);
 			if (success && (currentSampeIdx == 0))
 			{
@@ -2867,7 +2944,14 @@ bool FireRenderContext::Freshen(bool lock, std::function<bool()> cancelled)
 			continue;
 
 		UpdateTimeAndTriggerProgressCallback(syncProgressData, ProgressType::ObjectPreSync);
-		pMesh->Freshen(shouldCalculateHash);
+		{
+			Tracing::Zone zone("Freshen mesh");
+			if (zone.IsActive())
+				zone.SetDetail(MFnDependencyNode(pMesh->Object()).name().asUTF8());
+
+			SyncStats::ObjectSync objectSync(*pMesh, true);
+			pMesh->Freshen(shouldCalculateHash);
+		}
 		syncProgressData.currentIndex++;
 		UpdateTimeAndTriggerProgressCallback(syncProgressData, ProgressType::ObjectSyncComplete);
 	}
@@ -2894,6 +2978,7 @@ bool FireRenderContext::Freshen(bool lock, std::function<bool()> cancelled)
 	m_inRefresh = false;
 
 	m_needRedraw = true;
+	FireRenderThread::Wake();
 
 	return true;
 }
@@ -2907,6 +2992,8 @@ void FireRenderContext::SetState(StateEnum newState)
 
 	m_state = newState;
 
+	FireRenderThread::Wake();
+
 	if (m_state == StateEnum::StateExiting)
 	{
 		ContextWorkProgressData data;
@@ -2969,6 +3056,11 @@ float FireRenderContext::motionBlurCameraExposure() const
 	return m_motionBlurCameraExposure;
 }
 
+unsigned int FireRenderContext::environmentImageMaxWidth() const
+{
+	return isInteractive() ? m_globals.viewportEnvironmentResolution : 0;
+}
+
 unsigned int FireRenderContext::motionSamples() const
 {
 	return m_motionSamples;
@@ -2978,7 +3070,10 @@ void FireRenderContext::setCameraAttributeChanged(bool value)
 {
 	m_cameraAttributeChanged = value;
 	if (value)
+	{
 		m_restartRender = true;
+		FireRenderThread::Wake();
+	}
 }
 
 void FireRenderContext::setCompletionCriteria(const CompletionCriteriaParams& completionCriteriaParams)
@@ -3408,6 +3503,8 @@ void FireRenderContext::ForEachFramebuffer(
 
 std::vector<float> FireRenderContext::DenoiseAndUpscaleForViewport()
 {
+	RPR_TRACE_ZONE("Denoise and upscale");
+
 	bool useRAMBuffer = true;
 	RenderRegion region = RenderRegion(m_width, m_height);
 
@@ -3520,13 +3617,16 @@ bool FireRenderContext::TonemapIntoRAM()
 
 std::vector<float> FireRenderContext::DenoiseIntoRAM()
 {
+	RPR_TRACE_ZONE("Denoise");
+
 	bool shouldDenoise = IsDenoiserEnabled() &&
 		((m_RenderType == RenderType::ProductionRender) || (m_RenderType == RenderType::IPR));
 
 	if (!shouldDenoise)
 		return std::vector<float>();
 
-	bool useRAMBuffer = ShouldForceRAMDenoiser();
+	// IPR region is denoised from RAM, so denoiser input matches the region instead of the whole frame buffer
+	bool useRAMBuffer = ShouldForceRAMDenoiser() || (useRegion() && (m_RenderType == RenderType::IPR));
 
 	// setup params
 	RenderRegion tempRegion;
@@ -169,6 +169,7 @@ public:
 	// Build the scene from the current Maya scene attaching all the callbacks needed
 	void updateLimits(bool animation = false);
 	void updateLimitsFromGlobalData(const FireRenderGlobalsData& globalData, bool animation = false, bool batch = false);
+	void updateVDBGridCacheSize(const FireRenderGlobalsData& globalData);
 
 	bool buildScene(bool isViewport = false, bool glViewport = false, bool freshen = true);
 
@@ -471,6 +472,9 @@ public:
 	// Check if the context is dirty
 	bool isDirty();
 
+	// Check if the camera was changed since the last refresh
+	bool isCameraDirty() const { return m_cameraDirty; }
+
 	// refresh/rebuild anything we require
 	bool Freshen(bool lock = true,
 		std::function<bool()> cancelled = [] { return false; });
@@ -521,6 +525,9 @@ public:
 
 	unsigned int motionSamples() const;
 
+	/** Maximum width of the sky and IBL images, the viewport and IPR use preview resolution. Zero if not limited. */
+	unsigned int environmentImageMaxWidth() const;
+
 	// State flag of the renderer
 	StateEnum GetState() const { return m_state; }
 	void SetState(StateEnum newState);
@@ -698,6 +705,11 @@ public:
 
 	int GetSamplesPerUpdate() const { return m_samplesPerUpdate; }
 
+	// Iterations of the current frame including the part of the running render call done so far.
+	// Northstar reports progress of the running call from the render update callback,
+	// m_currentIteration is advanced only when the call returns
+	int GetRenderedIterationCount(float renderCallProgress) const;
+
 	void ResetRAMBuffers(void);
   
 	const FireRenderGlobalsData& Globals(void) const { return m_globals; }
@@ -836,6 +848,9 @@ private:
 	/** Mutex used for disabling simultaneous access to dirty objects list. */
 	std::mutex m_dirtyMutex;
 
+	/** Light data of physical lights by attributes hash, while dirty physical lights are freshened in a batch. */
+	std::unique_ptr<std::map<size_t, PhysicalLightData>> m_lightDataBatch;
+
 	/** Holds current globals state obtained in previous refresh call. */
 	FireRenderGlobalsData m_globals;
 
@@ -904,6 +919,7 @@ public:
 	MObject skyTransformObject = MObject();
 
 	FireMaya::Scope& GetScope() { return scope; }
+	std::map<size_t, PhysicalLightData>* GetLightDataBatch() { return m_lightDataBatch.get(); }
 	frw::Scene GetScene() { return scope.Scene(); }
 	frw::Context GetContext() { return scope.Context(); }
 	const frw::Context GetContext() const { return scope.Context(); }
@@ -960,6 +976,7 @@ public:
 	CompletionCriteriaParams m_completionCriteriaParams;
 
 	int	m_currentIteration;
+	int	m_currentIterationStep;
 	rpr_uint m_currentFrame;
 	int	m_progress;
 	std::chrono::time_point<std::chrono::system_clock> m_lastRenderStartTime;
@@ -16,6 +16,8 @@ limitations under the License.
 #include "VRay.h"
 #include "Context/FireRenderContext.h"
 #include "MayaStandardNodesSupport/NodeConverterUtil.h"
+#include "Tracing.h"
+#include "SyncStats.h"
 
 #include <maya/MImage.h>
 #include <maya/MPlugArray.h>
@@ -28,6 +30,7 @@ limitations under the License.
 #include <maya/MImageFileInfo.h>
 #include <FireRenderLayeredTextureUtils.h>
 #include <exception>
+#include <imageio.h>
 
 #ifdef MAYA2017
 #include "maya/MColorManagementUtilities.h"
@@ -877,24 +880,175 @@ frw::Image FireMaya::Scope::GetTiledImage(MString texturePath,
 	return retImage;
 }
 
-frw::Image FireMaya::Scope::GetImage(MString texturePath, MString colorSpace, const MString& ownerNodeName) const
+namespace
+{
+	/** Read the rows [y0, y1) of the image as float, tiled files are read by whole tiles. */
+	bool ReadImageRows(OIIO::ImageInput& input, const OIIO::ImageSpec& spec, int y0, int y1, int channels, float* data)
+	{
+		if (spec.tile_width > 0)
+		{
+			return input.read_tiles(spec.x, spec.x + spec.width, spec.y + y0, spec.y + y1, spec.z, spec.z + 1,
+				0, channels, OIIO::TypeDesc::FLOAT, data);
+		}
+
+		return input.read_scanlines(spec.y + y0, spec.y + y1, spec.z, 0, channels, OIIO::TypeDesc::FLOAT, data);
+	}
+
+	/**
+	 * Decode the image file downsampled by an integer factor, so it's not wider than maxWidth.
+	 * The file is read by strips of rows and box filtered on the fly, the full resolution image is never created.
+	 * Returns null if the image is already small enough or can't be read, 8 bit images stay 8 bit, others become float.
+	 */
+	frw::Image LoadPreviewImage(frw::Context context, const std::string& fileName, unsigned int maxWidth)
+	{
+		OIIO::ImageInput* input = OIIO::ImageInput::create(fileName);
+		if (!input)
+			return frw::Image();
+
+		frw::Image preview;
+
+		OIIO::ImageSpec spec;
+		if (input->open(fileName, spec) && spec.width > int(maxWidth) && spec.height > 0 && spec.depth <= 1)
+		{
+			size_t sourceWidth = spec.width;
+			size_t sourceHeight = spec.height;
+			int channels = spec.nchannels >= 3 ? std::min(spec.nchannels, 4) : 1;
+
+			size_t factor = (sourceWidth + maxWidth - 1) / maxWidth;
+			size_t width = (sourceWidth + factor - 1) / factor;
+			size_t height = (sourceHeight + factor - 1) / factor;
+
+			// Strips are made of whole boxes and whole rows of tiles
+			size_t stripRows = spec.tile_height > 0 ? factor * spec.tile_height : factor;
+
+			std::vector<float> strip(stripRows * sourceWidth * channels);
+			std::vector<float> pixels(width * height * channels, 0.0f);
+
+			bool success = true;
+			for (size_t y0 = 0; y0 < sourceHeight && success; y0 += stripRows)
+			{
+				size_t y1 = std::min(y0 + stripRows, sourceHeight);
+				success = ReadImageRows(*input, spec, int(y0), int(y1), channels, strip.data());
+
+				for (size_t sy = y0; sy < y1 && success; sy++)
+				{
+					const float* source = strip.data() + (sy - y0) * sourceWidth * channels;
+					float* dest = pixels.data() + (sy / factor) * width * channels;
+
+					for (size_t sx = 0; sx < sourceWidth; sx++)
+					{
+						for (int c = 0; c < channels; c++)
+						{
+							dest[(sx / factor) * channels + c] += source[sx * channels + c];
+						}
+					}
+				}
+			}
+
+			if (success)
+			{
+				// Boxes at the right and the bottom border may be smaller
+				for (size_t y = 0; y < height; y++)
+				{
+					size_t boxHeight = std::min((y + 1) * factor, sourceHeight) - y * factor;
+
+					for (size_t x = 0; x < width; x++)
+					{
+						size_t boxWidth = std::min((x + 1) * factor, sourceWidth) - x * factor;
+						float scale = 1.0f / float(boxWidth * boxHeight);
+
+						float* pixel = pixels.data() + (y * width + x) * channels;
+						for (int c = 0; c < channels; c++)
+						{
+							pixel[c] *= scale;
+						}
+					}
+				}
+
+				rpr_image_desc desc = {};
+				desc.image_width = rpr_uint(width);
+				desc.image_height = rpr_uint(height);
+
+				if (spec.format == OIIO::TypeDesc::UINT8)
+				{
+					std::vector<uint8_t> bytes(pixels.size());
+					for (size_t i = 0; i < pixels.size(); i++)
+					{
+						bytes[i] = uint8_t(std::min(std::max(pixels[i], 0.0f), 1.0f) * 255.0f + 0.5f);
+					}
+
+					desc.image_row_pitch = desc.image_width * channels;
+					preview = frw::Image(context, { rpr_uint(channels), RPR_COMPONENT_TYPE_UINT8 }, desc, bytes.data());
+				}
+				else
+				{
+					desc.image_row_pitch = desc.image_width * channels * sizeof(float);
+					preview = frw::Image(context, { rpr_uint(channels), RPR_COMPONENT_TYPE_FLOAT32 }, desc, pixels.data());
+				}
+			}
+		}
+
+		input->close();
+		delete input;
+
+		return preview;
+	}
+}
+
+frw::Image FireMaya::Scope::GetImage(MString texturePath, MString colorSpace, const MString& ownerNodeName, unsigned int maxWidth) const
 {
 	if (texturePath.length() == 0)
 	{
 		return NULL;
 	}
 
+	if (maxWidth > 0)
+	{
+		std::string previewKey = (texturePath + ":" + colorSpace).asUTF8() + ":" + std::to_string(maxWidth);
+
+		auto it = m->imageCache.find(previewKey);
+		if (it != m->imageCache.end())
+		{
+			SyncStats::AddImage(previewKey, it->second);
+			return it->second;
+		}
+
+		Tracing::Zone zone("Load preview image");
+		if (zone.IsActive())
+			zone.SetDetail(texturePath.asUTF8());
+
+		std::string processedTexturePath = ProcessEnvVarsInFilePath<std::string, char>(texturePath.asChar());
+
+		// Small images and files OpenImageIO can't read are used at full resolution
+		frw::Image preview = LoadPreviewImage(m->context, processedTexturePath, maxWidth);
+		if (!preview)
+			return GetImage(texturePath, colorSpace, ownerNodeName);
+
+		preview.SetName(texturePath.asUTF8());
+
+		m->imageCache[previewKey] = preview;
+		SyncStats::AddImage(previewKey, preview);
+		return preview;
+	}
+
 	std::string key = (texturePath + ":" + colorSpace).asUTF8();
 
 	auto it = m->imageCache.find(key);
 	if (it != m->imageCache.end())
+	{
+		SyncStats::AddImage(key, it->second);
 		return it->second;
+	}
 
 	frw::Image retImage = FireRenderThread::RunOnMainThread<frw::Image>([this, texturePath, key, colorSpace, ownerNodeName]() -> frw::Image
 	{
 		MAIN_THREAD_ONLY; // MTextureManager will not work in other threads
 		DebugPrint("Loading Image: %s in colorSpace: %s", texturePath.asUTF8(), colorSpace.asUTF8());
 
+		Tracing::Zone zone("Load image");
+		if (zone.IsActive())
+			zone.SetDetail(texturePath.asUTF8());
+
 		std::string processedTexturePath = ProcessEnvVarsInFilePath<std::string, char>(texturePath.asChar());
 
 		frw::Image image;
@@ -919,6 +1073,8 @@ frw::Image FireMaya::Scope::GetImage(MString texturePath, MString colorSpace, co
 		return image;
 	});
 
+	SyncStats::AddImage(key, retImage);
+
 	return retImage;
 }
 
@@ -1879,7 +2035,10 @@ frw::Shader FireMaya::Scope::GetCachedVolumeShader(const NodeId& id) const
 void FireMaya::Scope::SetCachedShader(const NodeId& id, frw::Shader shader)
 {
 	if (!shader)
+	{
 		m->shaderMap.erase(id);
+		m->shaderImageKeys.erase(id);
+	}
 	else
 		m->shaderMap[id] = shader;
 }
@@ -1899,6 +2058,66 @@ void FireMaya::Scope::ClearCachedShaderIds(const NodeId& lightId)
 	m->lightShaderMap.erase(lightId);
 }
 
+frw::Shape FireMaya::Scope::GetCachedAreaLightShape(int shapeType) const
+{
+	auto it = m->areaLightShapeMap.find(shapeType);
+
+	if (it != m->areaLightShapeMap.end())
+		return it->second;
+
+	return nullptr;
+}
+
+void FireMaya::Scope::SetCachedAreaLightShape(int shapeType, frw::Shape shape) const
+{
+	if (!shape)
+		m->areaLightShapeMap.erase(shapeType);
+	else
+		m->areaLightShapeMap[shapeType] = shape;
+}
+
+frw::Shader FireMaya::Scope::GetEmissiveShader(const frw::Value& color, float intensity, size_t colorInputHash)
+{
+	frw::MaterialSystem materialSystem = MaterialSystem();
+
+	// Constant colors are keyed by the emission, textures by their nodes and the intensity
+	std::pair<size_t, std::array<float, 3>> key;
+
+	if (color.IsFloat())
+	{
+		key = { 0, { color.GetX() * intensity, color.GetY() * intensity, color.GetZ() * intensity } };
+	}
+	else if (colorInputHash != 0)
+	{
+		key = { colorInputHash, { intensity, intensity, intensity } };
+	}
+	else
+	{
+		frw::EmissiveShader shader(materialSystem);
+		shader.SetColor(color * intensity);
+		return shader;
+	}
+
+	auto it = m->emissiveShaderMap.find(key);
+	if (it != m->emissiveShaderMap.end())
+		return it->second;
+
+	// Drop shaders which are not used by any light anymore (referenced by the cache only)
+	for (auto shaderIt = m->emissiveShaderMap.begin(); shaderIt != m->emissiveShaderMap.end();)
+	{
+		if (shaderIt->second.UseCount() == 1)
+			shaderIt = m->emissiveShaderMap.erase(shaderIt);
+		else
+			++shaderIt;
+	}
+
+	frw::EmissiveShader shader(materialSystem);
+	shader.SetColor(color * intensity);
+	m->emissiveShaderMap[key] = shader;
+
+	return shader;
+}
+
 void FireMaya::Scope::SetCachedVolumeShader(const NodeId& id, frw::Shader shader)
 {
 	if (!shader)
@@ -1969,6 +2188,17 @@ frw::Shader FireMaya::Scope::GetShader(MObject node, const FireRenderMeshCommon*
 	bool shdrNotDirty = !shader.IsDirty();
 	if (!forceUpdate && shader.IsValid() && !shader.IsDirty())
 	{
+		// The object uses the images of the cached shader too
+		if (SyncStats::IsEnabled())
+		{
+			for (const std::string& key : m->shaderImageKeys[shaderId])
+			{
+				auto it = m->imageCache.find(key);
+				if (it != m->imageCache.end())
+					SyncStats::AddImage(key, it->second);
+			}
+		}
+
 		return shader;
 	}
 
@@ -1986,10 +2216,12 @@ frw::Shader FireMaya::Scope::GetShader(MObject node, const FireRenderMeshCommon*
 	m->m_pLastLinkedLight = MObject::kNullObj;
 
 	// create now
+	SyncStats::ImageKeyCapture imageKeys;
 	shader = ParseShader(node);
 	if (shader.IsValid())
 	{
 		SetCachedShader(shaderId, shader);
+		m->shaderImageKeys[shaderId] = imageKeys.GetKeys();
 		shader.SetDirty(false);
 
 		if (m->m_pLastLinkedLight != MObject::kNullObj)
@@ -2227,6 +2459,7 @@ FireMaya::Scope::Data::~Data()
 
 	// delete shaders
 	shaderMap.clear();
+	shaderImageKeys.clear();
 	lightShaderMap.clear();
 
 	// everything else destroyed automatically
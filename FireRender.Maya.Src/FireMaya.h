@@ -23,6 +23,8 @@ limitations under the License.
 #include <maya/MNodeMessage.h>
 #include "Context/FireRenderContextIFace.h"
 
+#include <array>
+
 class FireRenderMeshCommon;
 
 namespace FireMaya
@@ -208,11 +210,14 @@ namespace FireMaya
 
 			std::map<NodeId, frw::Shader> volumeShaderMap;
 			std::map<NodeId, frw::Shader> shaderMap;
+			std::map<NodeId, std::vector<std::string>> shaderImageKeys; // image cache keys used by the cached shaders, for the sync statistics
 			std::multimap<NodeId, NodeId> lightShaderMap; // shaderId = lightShaderMap[lightNodeId]
 			std::map<NodeId, frw::Value> valueMap;
 			std::map<NodeId, MCallbackId> m_nodeDirtyCallbacks;
 			std::map<NodeId, MCallbackId> m_AttributeChangedCallbacks;
 			std::map<std::string, frw::Image> imageCache;
+			std::map<int, frw::Shape> areaLightShapeMap; // area light meshes by shape type, never attached to the scene, lights use their instances
+			std::map<std::pair<size_t, std::array<float, 3>>, frw::Shader> emissiveShaderMap; // area light emissive shaders by color input hash and emission, shared by lights
 
 			FireRenderMeshCommon const* m_pCurrentlyParsedMesh; // is not supposed to keep any data outside of during mesh parsing 
 			MObject m_pLastLinkedLight; // is not supposed to keep any data outside of during mesh parsing 
@@ -294,7 +299,8 @@ namespace FireMaya
 		frw::Shader GetVolumeShader( MObject ob, bool forceUpdate = false );
 		frw::Shader GetVolumeShader( MPlug ob );
 
-		frw::Image GetImage(MString path, MString colorSpace, const MString& ownerNodeName) const;
+		/** Image from the file. If maxWidth isn't zero, the image is downsampled to fit it (interactive preview). */
+		frw::Image GetImage(MString path, MString colorSpace, const MString& ownerNodeName, unsigned int maxWidth = 0) const;
 
 		frw::Image GetTiledImage(MString texturePath, 
 			int viewWidth, int viewHeight,
@@ -339,6 +345,14 @@ namespace FireMaya
 		void SetCachedShaderId(const NodeId& lightId, NodeId& shaderId);// shaderId = lightShaderMap[lightNodeId]
 		void ClearCachedShaderIds(const NodeId& lightId);
 
+		// Prototype mesh of the area light shape, identical area lights are instances of it
+		frw::Shape GetCachedAreaLightShape(int shapeType) const;
+		void SetCachedAreaLightShape(int shapeType, frw::Shape shape) const;
+
+		// Emissive shader of the color multiplied by intensity, shared by all lights with the same emission. Shader shouldn't be modified by the caller.
+		// Textured colors are shared by the hash of their input nodes, textures without the hash get a new shader
+		frw::Shader GetEmissiveShader(const frw::Value& color, float intensity, size_t colorInputHash);
+
 		void Reset();
 		void Init(rpr_context handle, bool destroyMaterialSystemOnDelete = true, bool createScene = true);
 		void CreateScene(void);
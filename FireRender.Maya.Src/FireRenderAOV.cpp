@@ -18,34 +18,52 @@ limitations under the License.
 #include "RenderStamp.h"
 
 #include "RenderViewUpdater.h"
+#include "PixelKernels.h"
+#include "Tracing.h"
 
 #include <maya/MCommonSystemUtils.h>
 #include <maya/MViewport2Renderer.h>
 #include <maya/MGlobal.h>
 
 #include <ostream>
+#include <algorithm>
 
 
 void PixelBuffer::resize(size_t newCount)
 {
 	size_t newSize = sizeof(RV_PIXEL) * newCount;
-	if (newSize != m_size)
+	if (newSize == m_size)
 	{
-		void * newBuffer = nullptr;
-#ifdef WIN32
-		newBuffer = _aligned_realloc(m_pBuffer, newSize, 128);
-#else
-		newBuffer = malloc(newSize);
-		if(m_pBuffer)
-		{
-			free(m_pBuffer);
-			m_pBuffer = nullptr;
-		}
-#endif
+		return;
+	}
+
+	if (newSize == 0)
+	{
+		reset();
+		return;
+	}
 
-		m_pBuffer = static_cast<RV_PIXEL*>(newBuffer);
+	// Fits in the current block, no need to re-allocate
+	if (newSize <= m_capacity)
+	{
 		m_size = newSize;
+		return;
 	}
+
+	size_t newCapacity = 0;
+	void * newBuffer = PixelBufferPool::GetInstance().Acquire(newSize, newCapacity);
+
+	// keep content like realloc does
+	if (m_pBuffer && newBuffer)
+	{
+		memcpy(newBuffer, m_pBuffer, std::min(m_size, newSize));
+	}
+
+	reset();
+
+	m_pBuffer = static_cast<RV_PIXEL*>(newBuffer);
+	m_size = newBuffer ? newSize : 0;
+	m_capacity = newCapacity;
 }
 
 void PixelBuffer::overwrite(const RV_PIXEL* input, const RenderRegion& region, unsigned int totalHeight, unsigned int totalWidth, int aov_id /*= 0*/)
@@ -59,20 +77,8 @@ void PixelBuffer::overwrite(const RV_PIXEL* input, const RenderRegion& region, u
 	if (region.right > totalWidth)
 		return;
 
-	// Get region dimensions.
-	unsigned int regionWidth = region.getWidth();
-	unsigned int regionHeight = region.getHeight();
-
 	// copy line by line
-	for (unsigned int y = 0; y < regionHeight; y++)
-	{
-		unsigned int inputIndex = y * regionWidth;
-
-		unsigned int destShiftY = y + totalHeight - region.top - 1;
-		unsigned int destIndex = region.left + (destShiftY) * totalWidth;
-
-		memcpy(&m_pBuffer[destIndex], &input[inputIndex], sizeof(RV_PIXEL) * regionWidth);
-	}
+	PixelKernels::PasteRegion((float*)m_pBuffer, (const float*)input, totalWidth, totalHeight, region);
 
 #ifdef _DEBUG
 #ifdef DUMP_PIXELS_PIXELBUFF
@@ -326,6 +332,10 @@ bool FireRenderAOV::writeToFile(FireRenderContext& context, const MString& fileP
 	if (!active || !pixels || m_region.isZeroArea())
 		return false;
 
+	Tracing::Zone zone("Write file");
+	if (zone.IsActive())
+		zone.SetDetail(filePath.asUTF8());
+
 	// do not write Shading normal, Object ID, Material Index, and UV for contour as they are overwritten per iteration
 	bool isContour = context.Globals().contourIsEnabled;
 	if (isContour && (id == RPR_AOV_MATERIAL_ID || id == RPR_AOV_SHADING_NORMAL || id == RPR_AOV_OBJECT_ID || id == RPR_AOV_UV))
@@ -14,6 +14,7 @@ limitations under the License.
 #include <maya/MString.h>
 #include "RenderRegion.h"
 #include "RenderStamp.h"
+#include "PixelBufferPool.h"
 #include <memory>
 
 // Maya 2015 has min/max defined, what prevents imageio.h from being compiled
@@ -36,11 +37,13 @@ struct AOVDescription
 };
 
 /** Automated handler for RV_PIXEL data.
-	Uses aligned memory manager and prevents unnecessary re-allocations */
+	Memory comes from the shared PixelBufferPool. Shrinking or resizing
+	within the allocated capacity doesn't re-allocate */
 class PixelBuffer
 {
 	RV_PIXEL * m_pBuffer;
 	size_t m_size;
+	size_t m_capacity;
 	size_t m_width;
 	size_t m_height;
 
@@ -48,6 +51,7 @@ public:
 	PixelBuffer() 
 		:	m_pBuffer(nullptr)
 		,	m_size(0)
+		,	m_capacity(0)
 		,	m_width(0)
 		,	m_height(0)
 	{
@@ -98,18 +102,20 @@ public:
 		resize(width*height);
 	}
 
+	size_t capacity() const
+	{
+		return m_capacity;
+	}
+
 	void reset()
 	{
 		if (m_pBuffer)
 		{
-#ifdef WIN32
-			_aligned_free(m_pBuffer);
-#else
-			free(m_pBuffer);
-#endif
+			PixelBufferPool::GetInstance().Release(m_pBuffer, m_capacity);
 		}
 		m_pBuffer = nullptr;
 		m_size = 0;
+		m_capacity = 0;
 	}
 
 	void overwrite(const RV_PIXEL* input, const RenderRegion& region, unsigned int totalHeight, unsigned int totalWidth, int aov_id = 0);
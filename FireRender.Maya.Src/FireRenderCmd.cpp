@@ -30,11 +30,14 @@ limitations under the License.
 #include <maya/MPlugArray.h>
 #include <maya/MArgList.h>
 #include <maya/MAnimControl.h>
+#include <maya/MDoubleArray.h>
+#include <maya/MStringArray.h>
 #include <maya/MFileIO.h>
 #include <maya/MRenderUtil.h>
 #include <maya/MCommonSystemUtils.h>
 
 #include <iomanip>
+#include <map>
 #include <regex>
 
 #include <maya/MIOStream.h>
@@ -46,6 +49,11 @@ limitations under the License.
 #include "FireRenderThread.h"
 #include "RenderStampUtils.h"
 #include "FireRenderImageUtil.h"
+#include "PixelBufferPool.h"
+#include "FireRenderViewport.h"
+#include "SwatchCache.h"
+#include "Tracing.h"
+#include "SyncStats.h"
 
 #include "Context/ContextCreator.h"
 
@@ -96,6 +104,18 @@ MSyntax FireRenderCmd::newSyntax()
 	CHECK_MSTATUS(syntax.addFlag(kWaitForIt, kWaitForItLong, MSyntax::kNoArg));
 	CHECK_MSTATUS(syntax.addFlag(kWaitForItTwoStep, kWaitForItTwoStepLong, MSyntax::kNoArg));
 	CHECK_MSTATUS(syntax.addFlag(kExportsGLTF, kExportsGLTFLong, MSyntax::kBoolean));
+	CHECK_MSTATUS(syntax.addFlag(kPixelBufferStats, kPixelBufferStatsLong, MSyntax::kNoArg));
+	CHECK_MSTATUS(syntax.addFlag(kViewportLatency, kViewportLatencyLong, MSyntax::kNoArg));
+	CHECK_MSTATUS(syntax.addFlag(kResetViewportLatency, kResetViewportLatencyLong, MSyntax::kNoArg));
+	CHECK_MSTATUS(syntax.addFlag(kClearSwatchCache, kClearSwatchCacheLong, MSyntax::kNoArg));
+	CHECK_MSTATUS(syntax.addFlag(kIprTimingsFlag, kIprTimingsFlagLong, MSyntax::kNoArg));
+	CHECK_MSTATUS(syntax.addFlag(kTimelineFlag, kTimelineFlagLong, MSyntax::kString));
+	CHECK_MSTATUS(syntax.addFlag(kTimelinePerFrameFlag, kTimelinePerFrameFlagLong, MSyntax::kBoolean));
+	CHECK_MSTATUS(syntax.addFlag(kSyncStats, kSyncStatsLong, MSyntax::kNoArg));
+	CHECK_MSTATUS(syntax.addFlag(kSyncStatsSortBy, kSyncStatsSortByLong, MSyntax::kString));
+	CHECK_MSTATUS(syntax.addFlag(kSyncStatsJson, kSyncStatsJsonLong, MSyntax::kString));
+	CHECK_MSTATUS(syntax.addFlag(kResetSyncStats, kResetSyncStatsLong, MSyntax::kNoArg));
+	CHECK_MSTATUS(syntax.addFlag(kSyncStatsEnabled, kSyncStatsEnabledLong, MSyntax::kBoolean));
 
 	return syntax;
 }
@@ -115,6 +135,56 @@ MStatus FireRenderCmd::doIt(const MArgList & args)
 	{
 		return exportsGLTF(argData);
 	}
+	else if (argData.isFlagSet(kPixelBufferStats))
+	{
+		return pixelBufferStats();
+	}
+	else if (argData.isFlagSet(kViewportLatency))
+	{
+		return viewportLatency();
+	}
+	else if (argData.isFlagSet(kResetViewportLatency))
+	{
+		FireRenderViewport::ResetLatencyStats();
+		return MS::kSuccess;
+	}
+	else if (argData.isFlagSet(kTimelineFlag))
+	{
+		return updateTimeline(argData);
+	}
+	else if (argData.isFlagSet(kSyncStats))
+	{
+		return syncStats(argData);
+	}
+	else if (argData.isFlagSet(kSyncStatsJson))
+	{
+		MString path;
+		MStatus status = argData.getFlagArgument(kSyncStatsJson, 0, path);
+		if (status != MS::kSuccess)
+			return status;
+
+		return SyncStats::GetInstance().WriteJson(path.asUTF8()) ? MS::kSuccess : MS::kFailure;
+	}
+	else if (argData.isFlagSet(kResetSyncStats))
+	{
+		SyncStats::GetInstance().Clear();
+		return MS::kSuccess;
+	}
+	else if (argData.isFlagSet(kSyncStatsEnabled))
+	{
+		bool enabled = false;
+		MStatus status = argData.getFlagArgument(kSyncStatsEnabled, 0, enabled);
+		if (status != MS::kSuccess)
+			return status;
+
+		SyncStats::SetEnabled(enabled);
+		return MS::kSuccess;
+	}
+	else if (argData.isFlagSet(kClearSwatchCache))
+	{
+		SwatchCache::GetInstance().Clear();
+		return MS::kSuccess;
+	}
 	else if (argData.isFlagSet(kOpenFolder))
 	{
 		MString path;
@@ -279,6 +349,8 @@ MStatus FireRenderCmd::renderFrame(const MArgDatabase& argData)
 			});
 		}
 
+		Tracing::EndFrame(frame);
+
 		// Perform clean up operations.
 		MRenderView::endRender();
 
@@ -382,6 +454,25 @@ MStatus FireRenderCmd::renderIpr(const MArgDatabase& args)
 			return MStatus::kSuccess;
 		}
 
+		// Return render time split: iterations, display refreshes, render, readback and
+		// render view update time in milliseconds, current display refresh interval in milliseconds.
+		if (args.isFlagSet(kIprTimingsFlag))
+		{
+			IprTimingStats stats = s_ipr ? s_ipr->getTimingStats() : IprTimingStats();
+
+			MDoubleArray result;
+			result.append((double)stats.iterationCount);
+			result.append((double)stats.refreshCount);
+			result.append(stats.renderMs);
+			result.append(stats.readbackMs);
+			result.append(stats.uiMs);
+			result.append(stats.refreshIntervalMs);
+
+			setResult(result);
+
+			return MStatus::kSuccess;
+		}
+
 		// Update the render region.
 		if (args.isFlagSet(kRegionFlag) && s_ipr)
 		{
@@ -567,6 +658,8 @@ MStatus FireRenderCmd::renderBatch(const MArgDatabase& args)
 				// Save the frame to file.
 				aovs.writeToFile(context, filePath, settings.imageFormat);
 
+				Tracing::EndFrame(frame);
+
 				// Execute the post frame command if there is one.
 				MGlobal::executeCommand(settings.postRenderMel);
 			}
@@ -629,6 +722,109 @@ MStatus FireRenderCmd::exportsGLTF(const MArgDatabase& argData)
 	return status;
 }
 
+MStatus FireRenderCmd::pixelBufferStats()
+{
+	PixelBufferPoolStats stats = PixelBufferPool::GetInstance().GetStats();
+
+	// doubles are used because byte counts may not fit into int
+	MDoubleArray result;
+	result.append((double)stats.allocationCount);
+	result.append((double)stats.poolHitCount);
+	result.append((double)stats.systemAllocationCount);
+	result.append((double)stats.bytesInUse);
+	result.append((double)stats.bytesCached);
+	result.append((double)stats.peakBytesInUse);
+
+	setResult(result);
+
+	return MS::kSuccess;
+}
+
+MStatus FireRenderCmd::viewportLatency()
+{
+	ViewportLatencyStats stats = FireRenderViewport::GetLatencyStats();
+
+	MDoubleArray result;
+	result.append((double)stats.sampleCount);
+	result.append(stats.lastMs);
+	result.append(stats.averageMs);
+	result.append(stats.maxMs);
+
+	setResult(result);
+
+	return MS::kSuccess;
+}
+
+MStatus FireRenderCmd::updateTimeline(const MArgDatabase& argData)
+{
+	MString path;
+	MStatus status = argData.getFlagArgument(kTimelineFlag, 0, path);
+	if (status != MS::kSuccess)
+		return status;
+
+	if (path.length() == 0)
+	{
+		Tracing::Stop();
+		return MS::kSuccess;
+	}
+
+	bool perFrame = false;
+	if (argData.isFlagSet(kTimelinePerFrameFlag))
+		argData.getFlagArgument(kTimelinePerFrameFlag, 0, perFrame);
+
+	Tracing::Start(path.asUTF8(), perFrame);
+
+	return MS::kSuccess;
+}
+
+MStatus FireRenderCmd::syncStats(const MArgDatabase& argData)
+{
+	SyncStats::SortKey sortKey = SyncStats::SortKey::TotalTime;
+
+	if (argData.isFlagSet(kSyncStatsSortBy))
+	{
+		MString sortBy;
+		argData.getFlagArgument(kSyncStatsSortBy, 0, sortBy);
+
+		static const std::map<std::string, SyncStats::SortKey> sortKeys =
+		{
+			{ "totalTime", SyncStats::SortKey::TotalTime },
+			{ "lastTime", SyncStats::SortKey::LastTime },
+			{ "triangles", SyncStats::SortKey::Triangles },
+			{ "textureBytes", SyncStats::SortKey::TextureBytes },
+			{ "syncCount", SyncStats::SortKey::SyncCount },
+			{ "name", SyncStats::SortKey::Name },
+		};
+
+		auto it = sortKeys.find(sortBy.asUTF8());
+		if (it == sortKeys.end())
+		{
+			MGlobal::displayError("Unknown sync statistics sort key: " + sortBy);
+			return MS::kInvalidParameter;
+		}
+
+		sortKey = it->second;
+	}
+
+	MStringArray result;
+	for (const ObjectSyncStats& stats : SyncStats::GetInstance().GetStats(sortKey))
+	{
+		char numbers[256];
+		snprintf(numbers, sizeof(numbers), "%.3f\t%.3f\t%llu\t%llu\t%u", stats.lastSyncMs, stats.totalSyncMs,
+			(unsigned long long) stats.triangleCount, (unsigned long long) stats.textureBytes, stats.syncCount);
+
+		std::string row = stats.name + "\t" + stats.nodeType + "\t" + stats.renderType + "\t" + numbers;
+
+		MString rowStr;
+		rowStr.setUTF8(row.c_str());
+		result.append(rowStr);
+	}
+
+	setResult(result);
+
+	return MS::kSuccess;
+}
+
 // -----------------------------------------------------------------------------
 MString FireRenderCmd::getOutputFilePath(const MCommonRenderSettingsData& settings,
 	 int frame, const MString& camera, bool preview) const
@@ -106,6 +106,22 @@ private:
 	/** Enables or disables gltf export */
 	MStatus exportsGLTF(const MArgDatabase& argData);
 
+	/** Returns pixel buffer pool statistics: allocations, pool hits, system allocations, bytes in use, bytes cached, peak bytes in use */
+	MStatus pixelBufferStats();
+
+	/** Returns viewport camera change to pixels latency: sample count, last, average and max latency in milliseconds */
+	MStatus viewportLatency();
+
+	/** Starts timeline tracing into the Chrome trace file, empty path stops it and writes the file */
+	MStatus updateTimeline(const MArgDatabase& argData);
+
+	/**
+	 * Returns per object sync statistics, one tab separated row per object: name, node type, render type,
+	 * last sync ms, total sync ms, triangles, texture bytes, sync count. Sorted by the total time or
+	 * by -syncStatsSortBy totalTime|lastTime|triangles|textureBytes|syncCount|name
+	 */
+	MStatus syncStats(const MArgDatabase& argData);
+
 	/** Get the output file path, with an optional frame for multi-frame renders. */
 	MString getOutputFilePath(const MCommonRenderSettingsData& settings,
 		 int frame, const MString& camera, bool preview) const;
@@ -181,4 +197,28 @@ private:
 #define kWaitForItTwoStepLong "-waitForItTwo"
 #define kExportsGLTF "-eg"
 #define kExportsGLTFLong "-exportsGLTF"
+#define kPixelBufferStats "-pbs"
+#define kPixelBufferStatsLong "-pixelBufferStats"
+#define kViewportLatency "-vpl"
+#define kViewportLatencyLong "-viewportLatency"
+#define kResetViewportLatency "-rvl"
+#define kResetViewportLatencyLong "-resetViewportLatency"
+#define kClearSwatchCache "-csc"
+#define kClearSwatchCacheLong "-clearSwatchCache"
+#define kIprTimingsFlag "-ipt"
+#define kIprTimingsFlagLong "-iprTimings"
+#define kTimelineFlag "-tl"
+#define kTimelineFlagLong "-timeline"
+#define kTimelinePerFrameFlag "-tlf"
+#define kTimelinePerFrameFlagLong "-timelinePerFrame"
+#define kSyncStats "-sst"
+#define kSyncStatsLong "-syncStats"
+#define kSyncStatsSortBy "-ssb"
+#define kSyncStatsSortByLong "-syncStatsSortBy"
+#define kSyncStatsJson "-ssj"
+#define kSyncStatsJsonLong "-syncStatsJson"
+#define kResetSyncStats "-rss"
+#define kResetSyncStatsLong "-resetSyncStats"
+#define kSyncStatsEnabled "-sse"
+#define kSyncStatsEnabledLong "-syncStatsEnabled"
 
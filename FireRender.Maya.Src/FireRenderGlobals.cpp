@@ -65,6 +65,7 @@ namespace
 		MObject RaycastEpsilon;
 		MObject EnableOOC;
 		MObject TexCacheSize;
+		MObject VdbGridCacheSize;
 
 		MObject AAFilter;
 		MObject AAGridSize;
@@ -217,6 +218,7 @@ namespace
 		MObject thumbnailIterCount;
 		MObject renderMode;
 		MObject motionBlur;
+		MObject environmentResolution;
 
 		// Other tabs
 		MObject completionCriteriaHours;
@@ -391,6 +393,13 @@ MStatus FireRenderGlobals::initialize()
 	nAttr.setSoftMax(8192);
 	nAttr.setMax(100000);
 
+	// Size of the converted vdb grids kept for all volumes (MB), least recently used grids are dropped first
+	Attribute::VdbGridCacheSize = nAttr.create("vdbGridCacheSize", "vgcs", MFnNumericData::kInt, 2048, &status);
+	MAKE_INPUT(nAttr);
+	nAttr.setMin(0);
+	nAttr.setSoftMax(16384);
+	nAttr.setMax(1000000);
+
 	Attribute::ibl = mAttr.create("imageBasedLighting", "ibl");
 	MAKE_INPUT(mAttr);
 
@@ -584,6 +593,7 @@ MStatus FireRenderGlobals::initialize()
 	CHECK_MSTATUS(addAttribute(Attribute::RaycastEpsilon));
 	CHECK_MSTATUS(addAttribute(Attribute::EnableOOC));
 	CHECK_MSTATUS(addAttribute(Attribute::TexCacheSize));
+	CHECK_MSTATUS(addAttribute(Attribute::VdbGridCacheSize));
 	CHECK_MSTATUS(addAttribute(Attribute::AAFilter));
 	CHECK_MSTATUS(addAttribute(Attribute::AAGridSize));
 	CHECK_MSTATUS(addAttribute(Attribute::ibl));
@@ -1308,6 +1318,13 @@ void FireRenderGlobals::createViewportAttributes()
 	MAKE_INPUT(nAttr);
 	CHECK_MSTATUS(addAttribute(ViewportRenderAttributes::motionBlur));
 
+	// Maximum width of the sky and IBL images in the viewport and IPR, 0 for the full resolution
+	ViewportRenderAttributes::environmentResolution = nAttr.create("environmentResolutionViewport", "verv", MFnNumericData::kInt, 1024, &status);
+	MAKE_INPUT(nAttr);
+	nAttr.setMin(0);
+	nAttr.setSoftMax(4096);
+	CHECK_MSTATUS(addAttribute(ViewportRenderAttributes::environmentResolution));
+
 	ViewportRenderAttributes::adaptiveThresholdViewport = nAttr.create("adaptiveThresholdViewport", "atv", MFnNumericData::kFloat, 0.05, &status);
 	MAKE_INPUT(nAttr);
 	nAttr.setMin(0.0);
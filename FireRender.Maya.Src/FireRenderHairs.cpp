@@ -13,8 +13,10 @@ limitations under the License.
 #include "FireRenderObjects.h"
 #include "Context/FireRenderContext.h"
 #include "FireRenderUtils.h"
+#include "HairCurvesBuilder.h"
 
 #include <float.h>
+#include <climits>
 #include <array>
 #include <algorithm>
 #include <vector>
@@ -248,76 +250,6 @@ void FireRenderHair::ApplyTransform(void)
 	}
 }
 
-/* from RadeonProRender.h :
-	*  A rpr_curve is a set of curves
-	*  A curve is a set of segments
-	*  A segment is always composed of 4 3D points
-*/
-const unsigned int PointsPerSegment = 4;
-
-void ProcessHairPoints(
-	std::vector<rpr_uint>& outCurveIndicesData,
-	unsigned int offset,
-	unsigned int length
-)
-{
-	rpr_uint currIdx = offset;
-	for (unsigned int idx = 0; idx < length; idx++)
-	{
-		outCurveIndicesData.push_back(currIdx++);
-
-		// duplicate index of last point in segment if necessary
-		if (outCurveIndicesData.size() % PointsPerSegment != 0)
-			continue;
-
-		if (idx < (length - 1))
-			outCurveIndicesData.push_back(outCurveIndicesData.back());
-	}
-}
-
-void ProcessHairTail(std::vector<rpr_uint>& outCurveIndicesData)
-{
-	// Number of points that should be added 
-	unsigned int tail = outCurveIndicesData.size() % PointsPerSegment;
-	if (tail != 0)
-		tail = PointsPerSegment - tail;
-
-	// Extend data indices array if necessary 
-	// Segment of RPR curve should always be composed of 4 3D points
-	for (unsigned int idx = 0; idx < tail; idx++)
-	{
-		outCurveIndicesData.push_back(outCurveIndicesData.back());
-	}
-}
-
-template <typename T>
-void ProcessHairWidth(
-	std::vector<float>& outRadiuses,
-	const T* width,
-	const std::vector<rpr_uint>& curveIndicesData)
-{
-	// ensure correct inputs
-	assert(width != nullptr);
-	assert(curveIndicesData.size() % PointsPerSegment == 0);
-
-	const unsigned int segmentsInCurve = (unsigned int)(curveIndicesData.size()) / PointsPerSegment;
-
-	// N = 2*(number of segments)
-	// In RPR we set 2 widths per segment (segment is 4 points)
-	for (unsigned int idx = 0; idx < segmentsInCurve; ++idx)
-	{
-		// bottom circle
-		rpr_uint controlPointIdx = curveIndicesData[idx * PointsPerSegment];
-		float radius = (float)width[controlPointIdx] * 0.5f;
-		outRadiuses.push_back(radius);
-
-		// top circle
-		controlPointIdx = curveIndicesData[idx * PointsPerSegment + (PointsPerSegment - 1)];
-		radius = (float)width[controlPointIdx] * 0.5f;
-		outRadiuses.push_back(radius);
-	}
-}
-
 std::tuple<unsigned int, unsigned int> GetHairLengthOffset(const XGenSplineAPI::XgItSpline& splineIt, unsigned int currCurveIdx)
 {
 	// find length of current segment and its offset in data arrays
@@ -330,117 +262,77 @@ std::tuple<unsigned int, unsigned int> GetHairLengthOffset(const XGenSplineAPI::
 	return std::make_tuple(length, offset);
 }
 
-struct CurvesBatchData
+// Hash of everything the curve of strands [firstStrand, endStrand) is built from
+HashValue GetChunkHash(const HairStrandsSource& source, size_t firstStrand, size_t endStrand)
 {
-	std::vector<rpr_uint> m_indicesData;
-	std::vector<int> m_numPointsPerSegment;
-	std::vector<float> m_radiuses; // width
-	std::vector<float> m_uvCoord;
-	unsigned int m_pointCount;
-	const float* m_points;
-
-	CurvesBatchData(void)
-		: m_indicesData()
-		, m_numPointsPerSegment()
-		, m_radiuses() // In RPR we set 2 widths per segment (segment is 4 points)
-		, m_uvCoord() // RPR accepts only one UV pair per curve
-		, m_pointCount(0) // splineIt.vertexCount() returns wrong number - it returns number of vertexes used, not size of vertex array, which is different number when density mask is used
-		, m_points(nullptr)
-	{}
-
-	using IHair = Ephere::Plugins::Ornatrix::IHair;
-	void Init(const std::shared_ptr<IHair>& sourceHair)
-	{
-		m_pointCount = sourceHair->GetVertexCount();
-		m_indicesData.reserve(m_pointCount * 2);
+	unsigned int firstPoint = 0;
+	unsigned int endPoint = 0;
+	source.GetPointRange(firstStrand, endStrand, firstPoint, endPoint);
 
-		int curveCount = sourceHair->GetStrandCount();
-		m_uvCoord.reserve(curveCount * 2);
-		m_numPointsPerSegment.reserve(curveCount);
-		m_radiuses.reserve(m_pointCount);
-	}
+	HashValue hash;
+	hash << (endStrand - firstStrand);
 
-	void Init(const XGenSplineAPI::XgItSpline& splineIt)
+	for (size_t strandIdx = firstStrand; strandIdx < endStrand; ++strandIdx)
 	{
-		m_points = splineIt.positions(0)->getValue();
-
-		const unsigned int  curveCount = splineIt.primitiveCount();
+		hash << source.lengths[strandIdx];
 
-		m_indicesData.reserve(splineIt.vertexCount() * 2);
-		m_numPointsPerSegment.reserve(curveCount);
-		m_radiuses.reserve(splineIt.vertexCount()); // array of N float. If curve is not tapered, N = curveCount. If curve is tapered, N = 2*(number of segments)
-		m_uvCoord.reserve(2 * curveCount);
+		if (source.lengths[strandIdx] > 0)
+			hash << (source.offsets[strandIdx] - firstPoint);
 	}
 
-	void Init(MRenderLineArray& mainLines)
-	{
-		int curveCount = mainLines.length();
-		for (int idx = 0; idx < curveCount; ++idx)
-		{
-			MStatus status;
-			MRenderLine renderLine = mainLines.renderLine(idx, &status);
-			MVectorArray lineVtxs = renderLine.getLine();
-			m_pointCount += lineVtxs.length();
-		}
+	int pointCount = (int)(endPoint - firstPoint);
+	hash.Append(source.points + (size_t)firstPoint * 3, pointCount * 3);
+	hash.Append(source.width + firstPoint, pointCount);
 
-		m_indicesData.reserve(m_pointCount * 2);
-		m_numPointsPerSegment.reserve(curveCount);
-		m_radiuses.reserve(m_pointCount); // array of N float. If curve is not tapered, N = curveCount. If curve is tapered, N = 2*(number of segments)
-		m_uvCoord.reserve(2 * curveCount);
-	}
-
-	frw::Curve CreateRPRCurve(frw::Context& currContext)
+	if (source.uvCoord != nullptr)
 	{
-		return currContext.CreateCurve(m_pointCount, m_points,
-			sizeof(float) * 3, m_indicesData.size(), (rpr_uint)m_numPointsPerSegment.size(), m_indicesData.data(),
-			m_radiuses.data(), m_uvCoord.data(), m_numPointsPerSegment.data());
+		hash.Append(source.uvCoord + source.uvOffsets[firstStrand], (int)(source.uvOffsets[endStrand] - source.uvOffsets[firstStrand]));
 	}
-};
 
-frw::Curve ProcessCurvesBatch(const XGenSplineAPI::XgItSpline& splineIt, frw::Context currContext)
+	return hash;
+}
+
+frw::Curve CreateRPRCurve(frw::Context& currContext, const CurvesBatchData& batchData)
+{
+	return currContext.CreateCurve(batchData.m_pointCount, batchData.m_points,
+		sizeof(float) * 3, batchData.m_indicesData.size(), (rpr_uint)batchData.m_numPointsPerSegment.size(), batchData.m_indicesData.data(),
+		batchData.m_radiuses.data(), batchData.m_uvCoord.data(), batchData.m_numPointsPerSegment.data());
+}
+
+void ProcessCurvesBatch(const XGenSplineAPI::XgItSpline& splineIt, FireRenderHair& hair)
 {
-	// create data buffers
-	CurvesBatchData batchData;
-	batchData.Init(splineIt);
+	HairStrandsSource source;
+	source.points = splineIt.positions(0)->getValue();
+	source.width = splineIt.width();
+
+	// find length of each primitive (each hair in batch) and its offset in data arrays
+	const unsigned int curveCount = splineIt.primitiveCount();
+
+	source.offsets.resize(curveCount);
+	source.lengths.resize(curveCount);
+	source.uvOffsets.resize(curveCount + 1);
 
-	// for each primitive (for each hair in batch)
-	for (unsigned int currCurveIdx = 0; currCurveIdx < splineIt.primitiveCount(); ++currCurveIdx)
+	for (unsigned int currCurveIdx = 0; currCurveIdx < curveCount; ++currCurveIdx)
 	{
-		unsigned int offset = 0;
-		unsigned int length = 0;
-		std::tie(length, offset) = GetHairLengthOffset(splineIt, currCurveIdx);
-
-		// Write indices and copy points
-		std::vector<rpr_uint> curveIndicesData;
-		ProcessHairPoints(curveIndicesData, offset, length);
-		ProcessHairTail(curveIndicesData);
-		assert(curveIndicesData.size() % PointsPerSegment == 0);
-
-		// Texcoord using the patch UV from the root point
-		const SgVec2f* patchUVs = splineIt.patchUVs();
-		batchData.m_uvCoord.push_back(patchUVs[offset][0]);
-		batchData.m_uvCoord.push_back(patchUVs[offset][1]);
-		// Number of points in the current curve
-		const unsigned int segmentsInCurve = (unsigned int)(curveIndicesData.size()) / PointsPerSegment;
-		batchData.m_numPointsPerSegment.push_back(segmentsInCurve);
-
-		// add tmp_indicesData to output
-		batchData.m_indicesData.insert(batchData.m_indicesData.end(), curveIndicesData.begin(), curveIndicesData.end());
-
-		// Hair segments radiuses
-		ProcessHairWidth(batchData.m_radiuses, splineIt.width(), curveIndicesData);
+		std::tie(source.lengths[currCurveIdx], source.offsets[currCurveIdx]) = GetHairLengthOffset(splineIt, currCurveIdx);
 	}
 
-	// find size of points array 
-	// splineIt.vertexCount() returns wrong number - it returns number of vertexes used, not size of vertex array, which is different number when density mask is used
-	if (!batchData.m_indicesData.empty())
+	// Texcoord using the patch UV from the root point
+	std::vector<float> uvCoord(2 * curveCount);
+	const SgVec2f* patchUVs = splineIt.patchUVs();
+	for (unsigned int currCurveIdx = 0; currCurveIdx < curveCount; ++currCurveIdx)
 	{
-		auto maxIndexElement = std::max_element(batchData.m_indicesData.begin(), batchData.m_indicesData.end());
-		batchData.m_pointCount = *maxIndexElement + 1;
+		uvCoord[currCurveIdx * 2] = patchUVs[source.offsets[currCurveIdx]][0];
+		uvCoord[currCurveIdx * 2 + 1] = patchUVs[source.offsets[currCurveIdx]][1];
+		source.uvOffsets[currCurveIdx + 1] = (currCurveIdx + 1) * 2;
 	}
 
-	// create RPR curve (create batch of hairs)
-	return batchData.CreateRPRCurve(currContext);
+	source.uvCoord = uvCoord.data();
+
+	// create RPR curves (create batches of hairs)
+	// size of points array is found from strands: splineIt.vertexCount() returns wrong number - it returns number of vertexes used,
+	// not size of vertex array, which is different number when density mask is used
+	hair.CreateChunkedCurves(source);
 }
 
 bool GetCurvesData(XGenSplineAPI::XgFnSpline& out, MFnDagNode& curvesNode)
@@ -481,6 +373,14 @@ bool GetCurvesData(XGenSplineAPI::XgFnSpline& out, MFnDagNode& curvesNode)
 void FireRenderHair::Freshen(bool shouldCalculateHash)
 {
 	detachFromScene();
+
+	// keep curves of the previous refresh: chunks of strands which did not change reuse them
+	m_PreviousCurves.clear();
+	for (size_t curveIdx = 0; curveIdx < m_Curves.size(); ++curveIdx)
+	{
+		m_PreviousCurves.emplace(m_CurveHashes[curveIdx], m_Curves[curveIdx]);
+	}
+
 	clear();
 
 	auto node = Object();
@@ -489,6 +389,9 @@ void FireRenderHair::Freshen(bool shouldCalculateHash)
 
 	bool haveCurves = CreateCurves();
 
+	// release curves of the changed chunks
+	m_PreviousCurves.clear();
+
 	if (haveCurves)
 	{
 		MDagPath path = MDagPath::getAPathTo(node);
@@ -512,10 +415,57 @@ void FireRenderHair::Freshen(bool shouldCalculateHash)
 void FireRenderHair::clear()
 {
 	m_Curves.clear();
+	m_CurveHashes.clear();
 
 	FireRenderObject::clear();
 }
 
+void FireRenderHair::CreateChunkedCurves(const HairStrandsSource& source)
+{
+	const size_t strandCount = source.StrandCount();
+	const int chunkCount = (int)((strandCount + StrandsPerChunk - 1) / StrandsPerChunk);
+
+	// content hashes of the chunks, chunks are independent
+	std::vector<HashValue> hashes(chunkCount);
+
+#pragma omp parallel for if(chunkCount > 1)
+	for (int chunkIdx = 0; chunkIdx < chunkCount; ++chunkIdx)
+	{
+		size_t firstStrand = chunkIdx * StrandsPerChunk;
+		size_t endStrand = std::min(firstStrand + StrandsPerChunk, strandCount);
+
+		hashes[chunkIdx] = GetChunkHash(source, firstStrand, endStrand);
+	}
+
+	// only one chunk data is resident at once, RPR curves are created sequentially
+	frw::Context context = Context();
+
+	for (int chunkIdx = 0; chunkIdx < chunkCount; ++chunkIdx)
+	{
+		frw::Curve curve;
+
+		auto it = m_PreviousCurves.find(hashes[chunkIdx]);
+		if (it != m_PreviousCurves.end())
+		{
+			curve = it->second;
+			m_PreviousCurves.erase(it);
+		}
+		else
+		{
+			size_t firstStrand = chunkIdx * StrandsPerChunk;
+			size_t endStrand = std::min(firstStrand + StrandsPerChunk, strandCount);
+
+			CurvesBatchData batchData;
+			batchData.Init(source, firstStrand, endStrand);
+
+			curve = CreateRPRCurve(context, batchData);
+		}
+
+		m_Curves.push_back(curve);
+		m_CurveHashes.push_back(hashes[chunkIdx]);
+	}
+}
+
 void FireRenderHair::attachToScene()
 {
 	if (m_isVisible)
@@ -646,7 +596,7 @@ bool FireRenderHairXGenGrooming::CreateCurves()
 	// create rpr curves (hair batch) for each primitive batch
 	for (XGenSplineAPI::XgItSpline splineIt = splines.iterator(); !splineIt.isDone(); splineIt.next())
 	{
-		m_Curves.push_back(ProcessCurvesBatch(splineIt, Context()));
+		ProcessCurvesBatch(splineIt, *this);
 	}
 
 	// apply transform to curves
@@ -686,14 +636,12 @@ bool EnsureValidOrnatrixHairBatch(const std::shared_ptr<Ephere::Plugins::Ornatri
 
 void ProcessOrnatrixTextureCoordinates(
 	const std::shared_ptr<Ephere::Plugins::Ornatrix::IHair>& sourceHair, 
-	int currStrandVertexCount,
-	int currCurveIdx,
-	std::vector<int>& firstVertexIndices,
-	CurvesBatchData& batchData)
+	const std::vector<int>& firstVertexIndices,
+	std::vector<float>& outUVCoord)
 {
 	// texture coords
 	int countTextureChannels = sourceHair->GetTextureCoordinateChannelCount();
-	if (countTextureChannels == 0)
+	if (countTextureChannels == 0 || firstVertexIndices.empty())
 		return;
 
 	// RPR supports only 1 channel!
@@ -702,32 +650,37 @@ void ProcessOrnatrixTextureCoordinates(
 
 	int channel = 0;
 
-	Ephere::Ornatrix::IHair::StrandDataType strandDataType = sourceHair->GetTextureCoordinateDataType(channel);
+	// Request coordinates of all root points at once instead of a call per strand
+	auto minmax = std::minmax_element(firstVertexIndices.begin(), firstVertexIndices.end());
+	int firstVertex = *minmax.first;
+	int vertexCount = *minmax.second - firstVertex + 1;
 
-	std::vector<Ephere::Ornatrix::TextureCoordinate> coords(currStrandVertexCount);
+	std::vector<Ephere::Ornatrix::TextureCoordinate> coords(vertexCount);
 	sourceHair->GetTextureCoordinates(
 		channel,
-		firstVertexIndices[currCurveIdx],
-		currStrandVertexCount,
+		firstVertex,
+		vertexCount,
 		coords.data(),
 		Ephere::Ornatrix::IHair::PerVertex);
 
 	// RPR supports only one uv coordinate pair per hair strand! Thus we pass UV of the root point
-	batchData.m_uvCoord.push_back(coords[0].x());
-	batchData.m_uvCoord.push_back(coords[0].y());
+	outUVCoord.resize(firstVertexIndices.size() * 2);
+	for (size_t currCurveIdx = 0; currCurveIdx < firstVertexIndices.size(); ++currCurveIdx)
+	{
+		const Ephere::Ornatrix::TextureCoordinate& rootCoord = coords[firstVertexIndices[currCurveIdx] - firstVertex];
+		outUVCoord[currCurveIdx * 2] = rootCoord.x();
+		outUVCoord[currCurveIdx * 2 + 1] = rootCoord.y();
+	}
 }
 
-frw::Curve ProcessCurvesBatch(const std::shared_ptr<Ephere::Plugins::Ornatrix::IHair>& sourceHair, frw::Context currContext)
+void ProcessCurvesBatch(const std::shared_ptr<Ephere::Plugins::Ornatrix::IHair>& sourceHair, FireRenderHair& hair)
 {
 	// ensure hair is described in supported way
 	assert(EnsureValidOrnatrixHairBatch(sourceHair));
 
-	// create data buffers
-	CurvesBatchData batchData;
-	batchData.Init(sourceHair);
-
 	// get overall batch data
 	int strandCount = sourceHair->GetStrandCount();
+	unsigned int pointCount = sourceHair->GetVertexCount();
 
 	std::vector<int> pointCounts(strandCount);
 	sourceHair->GetStrandPointCounts(0, int(pointCounts.size()), pointCounts.data());
@@ -736,59 +689,65 @@ frw::Curve ProcessCurvesBatch(const std::shared_ptr<Ephere::Plugins::Ornatrix::I
 	sourceHair->GetStrandFirstVertexIndices(0, int(firstVertexIndices.size()), firstVertexIndices.data());
 
 	// - vertices
-	std::vector<Ephere::Ornatrix::Vector3> vertices = sourceHair->GetVerticesVector(0, batchData.m_pointCount, Ephere::Ornatrix::IHair::Strand);
-	batchData.m_points = &vertices[0][0];
+	std::vector<Ephere::Ornatrix::Vector3> vertices = sourceHair->GetVerticesVector(0, pointCount, Ephere::Ornatrix::IHair::Strand);
 
 	// - hairs widths
-	std::vector<float> width(batchData.m_pointCount);
-	sourceHair->GetWidths(firstVertexIndices[0], batchData.m_pointCount, width.data());
+	std::vector<float> width(pointCount);
+	sourceHair->GetWidths(firstVertexIndices[0], pointCount, width.data());
 
 	// - vertex coords tranformations
 	std::vector <Ephere::Ornatrix::Xform3> strand2ojb (strandCount);
 	sourceHair->GetStrandToObjectTransforms(0, strandCount, strand2ojb.data());
 
-	// for each primitive (for each hair in batch)
-	unsigned int offset = 0;
-	int currStrandVertexCount = 0;
+	// offsets of the strands in vertices array
+	HairStrandsSource source;
+	source.offsets.resize(strandCount);
+	source.lengths.resize(strandCount);
+	source.uvOffsets.resize(strandCount + 1);
 
-	for (int currCurveIdx = 0; currCurveIdx < strandCount; ++currCurveIdx, offset += currStrandVertexCount)
+	unsigned int offset = 0;
+	for (int currCurveIdx = 0; currCurveIdx < strandCount; ++currCurveIdx)
 	{
-		// get current curve
-		currStrandVertexCount = sourceHair->GetStrandPointCount(currCurveIdx);
-		assert(currStrandVertexCount == pointCounts[currCurveIdx]);
+		assert(sourceHair->GetStrandPointCount(currCurveIdx) == pointCounts[currCurveIdx]);
 
-		// transform vertexes from local space
-		for (int currVtxIdx = 0; currVtxIdx < currStrandVertexCount; currVtxIdx++)
-		{
-			Ephere::Ornatrix::Vector3& tcoord = vertices[currVtxIdx + offset];
-			tcoord = strand2ojb[currCurveIdx] * tcoord;
-		}
+		source.offsets[currCurveIdx] = offset;
+		source.lengths[currCurveIdx] = pointCounts[currCurveIdx];
+		offset += pointCounts[currCurveIdx];
+	}
 
-		// texture coords
-		ProcessOrnatrixTextureCoordinates(sourceHair, currStrandVertexCount, currCurveIdx, firstVertexIndices, batchData);
+	// transform vertexes from local space
+	bool parallel = pointCount >= ParallelThresholdSegments;
 
-		// convert data grabbed from ornatrix to rpr
-		unsigned int length = pointCounts[currCurveIdx];
+#pragma omp parallel for if(parallel)
+	for (int currCurveIdx = 0; currCurveIdx < strandCount; ++currCurveIdx)
+	{
+		Ephere::Ornatrix::Vector3* strandVertices = vertices.data() + source.offsets[currCurveIdx];
 
-		// Write indices and copy points
-		std::vector<rpr_uint> curveIndicesData;
-		ProcessHairPoints(curveIndicesData, offset, length);
-		ProcessHairTail(curveIndicesData);
-		assert(curveIndicesData.size() % PointsPerSegment == 0);
+		for (unsigned int currVtxIdx = 0; currVtxIdx < source.lengths[currCurveIdx]; currVtxIdx++)
+		{
+			strandVertices[currVtxIdx] = strand2ojb[currCurveIdx] * strandVertices[currVtxIdx];
+		}
+	}
 
-		// Number of points in the current curve
-		const unsigned int segmentsInCurve = (unsigned int)(curveIndicesData.size()) / PointsPerSegment;
-		batchData.m_numPointsPerSegment.push_back(segmentsInCurve);
+	// texture coords
+	std::vector<float> uvCoord;
+	ProcessOrnatrixTextureCoordinates(sourceHair, firstVertexIndices, uvCoord);
 
-		// add tmp_indicesData to output
-		batchData.m_indicesData.insert(batchData.m_indicesData.end(), curveIndicesData.begin(), curveIndicesData.end());
+	if (!uvCoord.empty())
+	{
+		for (int currCurveIdx = 0; currCurveIdx < strandCount; ++currCurveIdx)
+		{
+			source.uvOffsets[currCurveIdx + 1] = (currCurveIdx + 1) * 2;
+		}
 
-		// Hair segments radiuses
-		ProcessHairWidth(batchData.m_radiuses, width.data(), curveIndicesData);
+		source.uvCoord = uvCoord.data();
 	}
 
-	// create RPR curve (create batch of hairs)
-	return batchData.CreateRPRCurve(currContext);
+	source.points = &vertices[0][0];
+	source.width = width.data();
+
+	// create RPR curves (create batches of hairs)
+	hair.CreateChunkedCurves(source);
 }
 
 bool FireRenderHairOrnatrix::CreateCurves()
@@ -802,7 +761,7 @@ bool FireRenderHairOrnatrix::CreateCurves()
 		return false;
 
 	// create rpr curves
-	m_Curves.push_back(ProcessCurvesBatch(sourceHair, Context()));
+	ProcessCurvesBatch(sourceHair, *this);
 
 	// apply transform to curves
 	ApplyTransform();
@@ -820,72 +779,78 @@ FireRenderHairNHair::FireRenderHairNHair(FireRenderContext* context, const MDagP
 FireRenderHairNHair::~FireRenderHairNHair()
 {}
 
-frw::Curve ProcessCurvesBatch(MRenderLineArray& mainLines, frw::Context currContext)
+void ProcessCurvesBatch(MRenderLineArray& mainLines, FireRenderHair& hair)
 {	
 	MStatus status;
 
-	// create data buffers
-	CurvesBatchData batchData;
-	batchData.Init(mainLines);
+	// first pass: sizes of the data arrays
+	int countMainLines = mainLines.length();
 
-	std::vector<float> vertices;
-	vertices.reserve(batchData.m_pointCount * 3);
-	std::vector<double> widths;
-	widths.reserve(batchData.m_pointCount * 3);
+	HairStrandsSource source;
+	source.offsets.resize(countMainLines);
+	source.lengths.resize(countMainLines);
+	source.uvOffsets.resize(countMainLines + 1);
 
-	// for each primitive (for each hair)
-	int currStrandVertexCount = 0;
-	unsigned int offset = 0;
+	unsigned int pointCount = 0;
 
-	int countMainLines = mainLines.length();
-	for (int idx = 0; idx < countMainLines; ++idx, offset += currStrandVertexCount)
+	for (int idx = 0; idx < countMainLines; ++idx)
+	{
+		MRenderLine renderLine = mainLines.renderLine(idx, &status);
+
+		source.offsets[idx] = pointCount;
+		source.lengths[idx] = renderLine.getLine().length();
+		pointCount += source.lengths[idx];
+
+		// two texcoords per parameter value
+		source.uvOffsets[idx + 1] = source.uvOffsets[idx] + renderLine.getParameter().length() * 2;
+	}
+
+	std::vector<float> vertices(pointCount * 3);
+	std::vector<float> widths(pointCount);
+	std::vector<float> uvCoord(source.uvOffsets.back());
+
+	// second pass: copy Maya data into preallocated arrays
+	for (int idx = 0; idx < countMainLines; ++idx)
 	{
 		MRenderLine renderLine = mainLines.renderLine(idx, &status);
 		MVectorArray lineVtxs = renderLine.getLine();
-		currStrandVertexCount = lineVtxs.length();
+		unsigned int offset = source.offsets[idx];
 
 		// Copy points
-		for (unsigned int vtxIdx = 0; vtxIdx < lineVtxs.length(); ++vtxIdx)
+		for (unsigned int vtxIdx = 0; vtxIdx < source.lengths[idx]; ++vtxIdx)
 		{
-			MVector& tVect = lineVtxs[vtxIdx];
-			vertices.push_back((float)tVect.x);
-			vertices.push_back((float)tVect.y);
-			vertices.push_back((float)tVect.z);
+			const MVector& tVect = lineVtxs[vtxIdx];
+			float* vertex = vertices.data() + (size_t)(offset + vtxIdx) * 3;
+			vertex[0] = (float)tVect.x;
+			vertex[1] = (float)tVect.y;
+			vertex[2] = (float)tVect.z;
 		}
 
-		// Write indices
-		std::vector<rpr_uint> curveIndicesData;
-		ProcessHairPoints(curveIndicesData, offset, currStrandVertexCount);
-		ProcessHairTail(curveIndicesData);
-		assert(curveIndicesData.size() % PointsPerSegment == 0);
-
-		// Number of segments in the current curve
-		const unsigned int segmentsInCurve = (unsigned int)(curveIndicesData.size()) / PointsPerSegment;
-		batchData.m_numPointsPerSegment.push_back(segmentsInCurve);
-
-		// add tmp_indicesData to output
-		batchData.m_indicesData.insert(batchData.m_indicesData.end(), curveIndicesData.begin(), curveIndicesData.end());
-
-		// Hair segments radiuses
+		// Hair widths
 		MDoubleArray width = renderLine.getWidth();
-		std::fill_n(std::back_inserter(widths), width.length(), 0.0);
-		width.get(&widths[offset]);
-		ProcessHairWidth(batchData.m_radiuses, widths.data(), curveIndicesData);
+		unsigned int widthCount = std::min(width.length(), source.lengths[idx]);
+		for (unsigned int widthIdx = 0; widthIdx < widthCount; ++widthIdx)
+		{
+			widths[offset + widthIdx] = (float)width[widthIdx];
+		}
 
 		// Texcoord
 		MDoubleArray parameter = renderLine.getParameter();
-		for (unsigned int idx = 0; idx < parameter.length(); ++idx)
+		float* strandUV = uvCoord.data() + source.uvOffsets[idx];
+		for (unsigned int paramIdx = 0; paramIdx < parameter.length(); ++paramIdx)
 		{
-			float param = (float)parameter[idx];
-			batchData.m_uvCoord.push_back(param);
-			batchData.m_uvCoord.push_back(param);
+			float param = (float)parameter[paramIdx];
+			strandUV[paramIdx * 2] = param;
+			strandUV[paramIdx * 2 + 1] = param;
 		}
 	}
 
-	batchData.m_points = vertices.data();
+	source.points = vertices.data();
+	source.width = widths.data();
+	source.uvCoord = uvCoord.data();
 
-	// create RPR curve (create batch of hairs)
-	return batchData.CreateRPRCurve(currContext);
+	// create RPR curves (create batches of hairs)
+	hair.CreateChunkedCurves(source);
 }
 
 bool FireRenderHairNHair::CreateCurves()
@@ -922,7 +887,7 @@ bool FireRenderHairNHair::CreateCurves()
 	int countFlowerLines = flowerLines.length();
 
 	// create rpr curves
-	m_Curves.push_back(ProcessCurvesBatch(mainLines, Context()));
+	ProcessCurvesBatch(mainLines, *this);
 
 	// clean up
 	mainLines.deleteArray();
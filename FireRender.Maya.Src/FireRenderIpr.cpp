@@ -19,6 +19,7 @@ limitations under the License.
 
 #include "FireRenderUtils.h"
 #include "RenderStampUtils.h"
+#include "PixelKernels.h"
 
 #include "Context/ContextCreator.h"
 
@@ -28,6 +29,7 @@ limitations under the License.
 #include "maya/MItSelectionList.h"
 
 #include <thread>
+#include <algorithm>
 #include <mutex>
 
 using namespace std;
@@ -35,6 +37,22 @@ using namespace std::chrono;
 using namespace RPR;
 using namespace FireMaya;
 
+namespace
+{
+	// Display refresh rate at the start of a frame (10 updates per second)
+	const double TargetRefreshIntervalMs = 100.0;
+
+	// Refresh interval doubles each time the iteration count doubles past this value
+	const int RefreshBackoffStartIteration = 16;
+
+	const double MaxRefreshIntervalMs = 2000.0;
+
+	double ElapsedMs(steady_clock::time_point start)
+	{
+		return duration<double, std::milli>(steady_clock::now() - start).count();
+	}
+}
+
 // Life Cycle
 // -----------------------------------------------------------------------------
 FireRenderIpr::FireRenderIpr() :
@@ -342,13 +360,13 @@ bool FireRenderIpr::stop()
 
 void FireRenderIpr::OnBufferAvailableCallback(float progress)
 {
-	{
-		AutoMutexLock pixelsLock(m_pixelsLock);
-
-		readFrameBuffer();
-	}
+	// Render keeps going in the core while we skip intermediate buffers,
+	// the final one is always shown. Iteration counter of the context doesn't move during the core render call,
+	// so back-off uses the samples rendered so far
+	if (!shouldRefreshDisplay(progress >= 1.0f, m_contextPtr->GetRenderedIterationCount(progress)))
+		return;
 
-	scheduleRenderViewUpdate();
+	refreshDisplay();
 }
 
 // -----------------------------------------------------------------------------
@@ -391,16 +409,24 @@ bool FireRenderIpr::RunOnViewportThread()
 
 				// Render.
 				AutoMutexLock contextLock(m_contextLock);
+
+				auto renderStart = steady_clock::now();
 				m_contextPtr->render(false);
 
-				// Read the frame buffer.
 				{
-					AutoMutexLock pixelsLock(m_pixelsLock);
-					readFrameBuffer();
+					AutoMutexLock statsLock(m_statsLock);
+					m_timingStats.renderMs += ElapsedMs(renderStart);
+					m_timingStats.iterationCount++;
 				}
 
-				// Schedule a Maya render view on the main thread.
-				scheduleRenderViewUpdate();
+				// First iteration of a restarted frame and the last one are always displayed,
+				// otherwise render iterations continue until the next refresh is due.
+				bool forceRefresh = m_contextPtr->m_currentFrame <= 1 || !m_contextPtr->keepRenderRunning();
+
+				if (shouldRefreshDisplay(forceRefresh, m_contextPtr->m_currentIteration))
+				{
+					refreshDisplay();
+				}
 			}
 			catch (...)
 			{
@@ -423,10 +449,11 @@ bool FireRenderIpr::RunOnViewportThread()
 					bool tonemapSuccessful = m_contextPtr->TonemapIntoRAM();
 					if (tonemapSuccessful)
 					{
+						// tonemapped region is pasted into the full frame RAM buffer
 						RV_PIXEL* data = (RV_PIXEL*)m_contextPtr->PixelBuffers()[RPR_AOV_COLOR].data();
 
 						// put tonemapped image to ipr buffer
-						memcpy(m_pixels.data(), data, sizeof(RV_PIXEL) * m_pixels.size());
+						copyRegionFromFrame(data);
 
 						scheduleRenderViewUpdate();
 					}
@@ -443,7 +470,20 @@ bool FireRenderIpr::RunOnViewportThread()
 					RV_PIXEL* data = (RV_PIXEL*)vecData.data();
 
 					// put denoised image to ipr buffer
-					memcpy(m_pixels.data(), data, sizeof(RV_PIXEL) * m_pixels.size());
+					// RAM denoiser returns just the region, frame buffer denoiser returns the whole frame
+					{
+						AutoMutexLock pixelsLock(m_pixelsLock);
+						std::lock_guard<std::mutex> guard(m_regionUpdateMutex);
+
+						if (vecData.size() == m_pixels.size() * 4)
+						{
+							memcpy(m_pixels.data(), data, sizeof(RV_PIXEL) * m_pixels.size());
+						}
+						else
+						{
+							PixelKernels::CopyRegion((float*)m_pixels.data(), (const float*)data, m_contextPtr->width(), m_contextPtr->height(), m_region);
+						}
+					}
 
 					scheduleRenderViewUpdate();
 				}
@@ -561,6 +601,8 @@ void FireRenderIpr::updateRenderView()
 		// Acquire the pixels lock.
 		AutoMutexLock pixelsLock(m_pixelsLock);
 
+		auto uiStart = steady_clock::now();
+
 		RenderViewUpdater::UpdateAndRefreshRegion(m_pixels.data(), m_region.getWidth(), m_region.getHeight(), m_region);
 
 		updateMayaRenderInfo();
@@ -568,12 +610,22 @@ void FireRenderIpr::updateRenderView()
 		if (rcWarningDialog.shown) {
 			rcWarningDialog.close();
 		}
+
+		AutoMutexLock statsLock(m_statsLock);
+		m_timingStats.uiMs += ElapsedMs(uiStart);
 	}
 
 	// Refresh the context if required.
 	m_needsContextRefresh = true;
 }
 
+// -----------------------------------------------------------------------------
+IprTimingStats FireRenderIpr::getTimingStats()
+{
+	AutoMutexLock statsLock(m_statsLock);
+	return m_timingStats;
+}
+
 // -----------------------------------------------------------------------------
 void FireRenderIpr::scheduleRenderViewUpdate()
 {
@@ -649,6 +701,71 @@ void FireRenderIpr::readFrameBuffer()
 	m_contextPtr->readFrameBuffer(params);
 }
 
+// -----------------------------------------------------------------------------
+void FireRenderIpr::copyRegionFromFrame(const RV_PIXEL* frame)
+{
+	AutoMutexLock pixelsLock(m_pixelsLock);
+	std::lock_guard<std::mutex> guard(m_regionUpdateMutex);
+
+	PixelKernels::CopyRegion((float*)m_pixels.data(), (const float*)frame, m_contextPtr->width(), m_contextPtr->height(), m_region);
+}
+
+// -----------------------------------------------------------------------------
+double FireRenderIpr::getRefreshIntervalMs(int iteration)
+{
+	double interval = TargetRefreshIntervalMs;
+
+	for (int i = RefreshBackoffStartIteration; i < iteration && interval < MaxRefreshIntervalMs; i *= 2)
+	{
+		interval *= 2.0;
+	}
+
+	return std::min(interval, MaxRefreshIntervalMs);
+}
+
+// -----------------------------------------------------------------------------
+bool FireRenderIpr::shouldRefreshDisplay(bool force, int iteration)
+{
+	double interval = getRefreshIntervalMs(iteration);
+
+	{
+		AutoMutexLock statsLock(m_statsLock);
+		m_timingStats.refreshIntervalMs = interval;
+	}
+
+	if (force)
+		return true;
+
+	// Render view hasn't consumed the previous frame yet, reading a new one would be wasted
+	if (m_renderViewUpdateScheduled)
+		return false;
+
+	return ElapsedMs(m_lastRefreshTime) >= interval;
+}
+
+// -----------------------------------------------------------------------------
+void FireRenderIpr::refreshDisplay()
+{
+	auto readbackStart = steady_clock::now();
+
+	// Read the frame buffer.
+	{
+		AutoMutexLock pixelsLock(m_pixelsLock);
+		readFrameBuffer();
+	}
+
+	m_lastRefreshTime = steady_clock::now();
+
+	{
+		AutoMutexLock statsLock(m_statsLock);
+		m_timingStats.readbackMs += ElapsedMs(readbackStart);
+		m_timingStats.refreshCount++;
+	}
+
+	// Schedule a Maya render view on the main thread.
+	scheduleRenderViewUpdate();
+}
+
 // -----------------------------------------------------------------------------
 void FireRenderIpr::refreshContext()
 {
@@ -20,6 +20,20 @@ limitations under the License.
 #include "NorthStarRenderingHelper.h"
 
 #include <mutex>
+#include <chrono>
+
+/** Time split of an IPR session between rendering, frame buffer readback and render view updates. */
+struct IprTimingStats
+{
+	size_t iterationCount = 0;
+	size_t refreshCount = 0;
+	double renderMs = 0.0;
+	double readbackMs = 0.0;
+	double uiMs = 0.0;
+
+	/** Display refresh interval currently used by the adaptive refresh policy. */
+	double refreshIntervalMs = 0.0;
+};
 
 /**
  * Manages an interactive photo real (IPR)
@@ -69,6 +83,9 @@ public:
 	/** Update the Maya render view. */
 	void updateRenderView();
 
+	/** Get accumulated render, readback and render view update timings. */
+	IprTimingStats getTimingStats();
+
 private:
 
 	// Life Cycle
@@ -100,6 +117,22 @@ private:
 	/** Read data from the RPR frame buffer into the texture. */
 	void readFrameBuffer();
 
+	/** Copy the render region from a full frame RAM buffer into the render view pixels. */
+	void copyRegionFromFrame(const RV_PIXEL* frame);
+
+	/**
+	 * True if the frame buffer should be read back and pushed to the render view now.
+	 * Refresh rate starts at the target display rate and backs off as samples accumulate.
+	 * Iteration is the number of samples rendered in the current frame.
+	 */
+	bool shouldRefreshDisplay(bool force, int iteration);
+
+	/** Read the frame buffer and schedule a render view update, recording readback time. */
+	void refreshDisplay();
+
+	/** Display refresh interval for the given iteration of the current frame. */
+	static double getRefreshIntervalMs(int iteration);
+
 	/** Refresh the context. */
 	void refreshContext();
 
@@ -186,4 +219,13 @@ private:
 	MCallbackId m_renderGlobalsCallback = 0;
 
 	NorthStarRenderingHelper m_NorthStarRenderingHelper;
+
+	/** Time of the last frame buffer readback. */
+	std::chrono::steady_clock::time_point m_lastRefreshTime;
+
+	/** Render, readback and render view update timings. */
+	IprTimingStats m_timingStats;
+
+	/** A lock to control access to the timing statistics. */
+	std::mutex m_statsLock;
 };
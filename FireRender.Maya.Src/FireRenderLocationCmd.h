@@ -16,9 +16,10 @@ limitations under the License.
 #include <maya/MSyntax.h>
 #include <maya/MStringArray.h>
 #include <maya/MArgDatabase.h>
-#include <maya/MFloatVector.h>
 #include <vector>
 
+#include "LocationData.h"
+
 
 /**
  * Perform location related tasks that are
@@ -44,54 +45,14 @@ public:
 
 private:
 
-	// Enums
-	// -----------------------------------------------------------------------------
-
-	/** The types of region that define a time zone boundary. */
-	enum TimeZoneType
-	{
-		RECTANGLE,
-		POLYGON
-	};
-
-
-	// Structs
-	// -----------------------------------------------------------------------------
-
-	/** Location information. */
-	struct Location
-	{
-		std::string name;
-		float latitude;
-		float longitude;
-		float utcOffset;
-		int countryIndex;
-	};
-
-	/** Time zone information. */
-	struct TimeZone
-	{
-		std::string name;
-		std::vector<MFloatVector> vertices;
-		int type;
-		float utcOffset;
-	};
-
-
 	// Static Members
 	// -----------------------------------------------------------------------------
 
-	/** The list of all countries. */
-	static std::vector<std::string> s_countries;
-
-	/** The list of all locations. */
-	static std::vector<Location> s_locations;
-
-	/** The list of all time zones. */
-	static std::vector<TimeZone> s_timeZones;
+	/** Countries, locations and time zones with the lookup indices. */
+	static LocationData s_data;
 
 	/** The list of most recent search results. */
-	static std::vector<Location> s_searchResults;
+	static std::vector<LocationData::Location> s_searchResults;
 
 	/** True once location data is loaded. */
 	static bool s_loaded;
@@ -102,21 +63,11 @@ private:
 	/** Load data from the specified path. */
 	void load(const MArgDatabase& argData);
 
-	/** Load country data. */
-	void loadCountries(const MString& path);
-
-	/** Load location data. */
-	void loadLocations(const MString& path);
-
-	/** Load time zone data. */
-	void loadTimeZones(const MString& path);
-
-
 	/** Perform a location search and return the results. */
 	void searchLocations(const MArgDatabase& argData);
 
 	/** Get a string for a location, including country. */
-	MString getLocationString(const Location& location) const;
+	MString getLocationString(const LocationData::Location& location) const;
 
 	/** Capitalize a location name because they are stored as lower case. */
 	void capitalizeLocationName(std::string& name) const;
@@ -130,15 +81,6 @@ private:
 	/** Get a geographic coordinate from argument data. */
 	void getGeographicCoordinate(const MArgDatabase& argData, float& latitude, float& longitude) const;
 
-	/** True if the given point is in the given time zone. */
-	bool isPointInTimeZone(const TimeZone& timeZone, float x, float y) const;
-
-	/** True if the given point is in the rectangle defined by the vertices. */
-	bool isPointInRectangle(const std::vector<MFloatVector>& v, float x, float y) const;
-
-	/** True if the given point is in the polygon defined by the vertices. */
-	bool isPointInPolygon(const std::vector<MFloatVector>& v, float x, float y) const;
-
 };
 
 
@@ -17,13 +17,20 @@ limitations under the License.
 #include <maya/MPlug.h>
 #include <maya/MGlobal.h>
 #include <maya/MFileObject.h>
+#include <maya/MFnAttribute.h>
+#include <maya/MPlugArray.h>
+#include <maya/MObjectHandle.h>
 
 #include <thread>
+#include <algorithm>
+#include <filesystem>
+#include <unordered_map>
 
 #include "SkyBuilder.h"
 #include "FireRenderSkyLocator.h"
 
 #include "FireRenderSwatchInstance.h"
+#include "SwatchCache.h"
 
 using namespace FireMaya;
 using namespace std::chrono;
@@ -32,7 +39,9 @@ FireRenderMaterialSwatchRender::FireRenderMaterialSwatchRender(MObject obj, MObj
 	MSwatchRenderBase(obj, renderObj, res),
 	m_runningAsyncRender(false),
 	m_finishedAsyncRender(false),
-	m_cancelAsyncRender(false)
+	m_cancelAsyncRender(false),
+	m_resolution(0),
+	m_cacheKey(0)
 {
 
 }
@@ -69,7 +78,20 @@ bool FireRenderMaterialSwatchRender::doIteration()
 			{
 				return true;
 			}
-			getSwatchInstance().enqueSwatch(this);
+
+			// unchanged material: swatch is ready without rendering, finish it as finalizeRendering does
+			if (readFromCache())
+			{
+				finishParallelRender();
+				return true;
+			}
+
+			FireRenderSwatchInstance& swatchInstance = getSwatchInstance();
+
+			m_shader = swatchInstance.getContext().GetShader(node());
+			m_volumeShader = swatchInstance.getContext().GetVolumeShader(node());
+
+			swatchInstance.enqueSwatch(this);
 		}
 		else
 		{
@@ -102,16 +124,13 @@ bool FireRenderMaterialSwatchRender::setupFRNode()
 	auto disableSwatchPlug = nodeFn.findPlug("disableSwatch");
 
 	bool enableSwatches = false;
-	FireRenderGlobalsData::getThumbnailIterCount(&enableSwatches);
+	int iterationCount = FireRenderGlobalsData::getThumbnailIterCount(&enableSwatches);
 	 
 	if (enableSwatches && (disableSwatchPlug.isNull() || !disableSwatchPlug.asBool()))
 	{
-		FireRenderSwatchInstance& swatchInstance = getSwatchInstance();
-
-		m_shader = swatchInstance.getContext().GetShader(mnode);
-		m_volumeShader = swatchInstance.getContext().GetVolumeShader(mnode);
-
 		m_resolution = resolution();
+		m_materialHash = GetMaterialNetworkHash(mnode);
+		m_cacheKey = SwatchCache::GetKey(m_materialHash, GetSwatchSettingsHash(), m_resolution, iterationCount);
 
 		return true;
 	}
@@ -119,10 +138,173 @@ bool FireRenderMaterialSwatchRender::setupFRNode()
 	return false;
 }
 
-void FireRenderMaterialSwatchRender::processFromBackgroundThread()
+namespace
+{
+	void AppendString(HashValue& hash, const MString& str)
+	{
+		hash.Append(str.asChar(), (int)str.length());
+	}
+
+	// Texture contents aren't part of the attribute values, so modification time of the file is hashed
+	void AppendFileTime(HashValue& hash, const MString& path)
+	{
+		if (path.length() == 0)
+			return;
+
+		// resolves paths relative to the project
+		MFileObject fileObject;
+		fileObject.setRawFullName(path);
+
+		std::error_code errorCode;
+		std::filesystem::file_time_type modificationTime = std::filesystem::last_write_time(std::filesystem::u8path(fileObject.resolvedFullName().asUTF8()), errorCode);
+
+		// missing files and patterns (udim, sequences) only hash the path
+		if (!errorCode)
+		{
+			hash << modificationTime.time_since_epoch().count();
+		}
+	}
+
+	// Memoized hashing of the upstream network, nodes are keyed by MObjectHandle hash code
+	class MaterialNetworkHasher
+	{
+	public:
+		HashValue GetNodeHash(const MObject& node)
+		{
+			unsigned int key = MObjectHandle(node).hashCode();
+
+			auto it = m_nodeHashes.find(key);
+			if (it != m_nodeHashes.end())
+				return it->second;
+
+			// cycle guard: node which is being hashed gets a placeholder (constant, so hash is the same in every session)
+			m_nodeHashes[key] = HashValue();
+
+			HashValue hash;
+			MFnDependencyNode nodeFn(node);
+			AppendString(hash, nodeFn.typeName());
+
+			for (unsigned int attrIdx = 0; attrIdx < nodeFn.attributeCount(); ++attrIdx)
+			{
+				MObject attr = nodeFn.attribute(attrIdx);
+				MFnAttribute attrFn(attr);
+
+				// children are written by the parent compound
+				if (!attrFn.parent().isNull() || !attrFn.isStorable())
+					continue;
+
+				MPlug plug = nodeFn.findPlug(attr, false);
+
+				MStringArray setAttrCmds;
+				plug.getSetAttrCmds(setAttrCmds, MPlug::kNonDefault, false);
+				for (unsigned int cmdIdx = 0; cmdIdx < setAttrCmds.length(); ++cmdIdx)
+				{
+					AppendString(hash, setAttrCmds[cmdIdx]);
+				}
+
+				if (attrFn.isUsedAsFilename())
+				{
+					AppendFileTime(hash, plug.asString());
+				}
+			}
+
+			MPlugArray connections;
+			nodeFn.getConnections(connections);
+			for (unsigned int plugIdx = 0; plugIdx < connections.length(); ++plugIdx)
+			{
+				const MPlug& destination = connections[plugIdx];
+
+				MPlugArray sources;
+				if (!destination.connectedTo(sources, true, false) || sources.length() == 0)
+					continue;
+
+				AppendString(hash, destination.partialName(false, true, true, false, true));
+				AppendString(hash, sources[0].partialName(false, true, true, false, true));
+				hash << size_t(GetNodeHash(sources[0].node()));
+			}
+
+			m_nodeHashes[key] = hash;
+
+			return hash;
+		}
+
+	private:
+		std::unordered_map<unsigned int, HashValue> m_nodeHashes;
+	};
+}
+
+HashValue FireRenderMaterialSwatchRender::GetMaterialNetworkHash(const MObject& node)
 {
-	if (m_cancelAsyncRender)
+	MaterialNetworkHasher hasher;
+
+	return hasher.GetNodeHash(node);
+}
+
+HashValue FireRenderMaterialSwatchRender::GetSwatchSettingsHash()
+{
+	// render globals applied to the swatch context by updateTonemapping, swatch light and camera are fixed
+	static const char* floatSettingNames[] =
+	{
+		"textureGamma",
+		"displayGamma",
+		"toneMappingSimpleExposure",
+		"toneMappingSimpleContrast",
+		"toneMappingWhiteBalanceValue",
+	};
+
+	static const char* boolSettingNames[] =
+	{
+		"applyGammaToMayaViews",
+		"toneMappingSimpleTonemap",
+		"toneMappingWhiteBalanceEnabled",
+	};
+
+	HashValue hash;
+
+	for (const char* name : floatSettingNames)
+	{
+		MPlug plug = GetRadeonProRenderGlobalsPlug(name);
+		hash << (plug.isNull() ? 0.0f : plug.asFloat());
+	}
+
+	for (const char* name : boolSettingNames)
+	{
+		MPlug plug = GetRadeonProRenderGlobalsPlug(name);
+		hash << (plug.isNull() ? false : plug.asBool());
+	}
+
+	MPlug toneMappingTypePlug = GetRadeonProRenderGlobalsPlug("toneMappingType");
+	hash << (toneMappingTypePlug.isNull() ? 0 : toneMappingTypePlug.asInt());
+
+	return hash;
+}
+
+bool FireRenderMaterialSwatchRender::isSameSwatch(const FireRenderMaterialSwatchRender& other) const
+{
+	return m_resolution == other.m_resolution && m_materialHash == other.m_materialHash;
+}
+
+void FireRenderMaterialSwatchRender::processFromBackgroundThread(const std::vector<FireRenderMaterialSwatchRender*>& sameSwatches)
+{
+	// the render is needed while at least one of the swatches waits for it
+	auto allCancelled = [&]()
+	{
+		return std::all_of(sameSwatches.begin(), sameSwatches.end(),
+			[](const FireRenderMaterialSwatchRender* swatch) { return swatch->m_cancelAsyncRender.load(); });
+	};
+
+	if (allCancelled())
+	{
+		for (FireRenderMaterialSwatchRender* swatch : sameSwatches)
+			swatch->finishAsyncRender();
+
 		return;
+	}
+
+	bool rendered = false;
+	std::vector<float> data;
+	unsigned int width = 0;
+	unsigned int height = 0;
 
 	try
 	{
@@ -152,49 +334,79 @@ void FireRenderMaterialSwatchRender::processFromBackgroundThread()
 		swatchInstance.getContext().m_restartRender = true;
 		swatchInstance.getContext().UpdateCompletionCriteriaForSwatch();
 
+		bool cancelled = false;
 		while (swatchInstance.getContext().keepRenderRunning())
 		{
-			if (m_cancelAsyncRender)
+			cancelled = allCancelled();
+			if (cancelled)
 				break;
 
 			swatchInstance.getContext().render();
 		}
 
-		m_finishedAsyncRender = !m_cancelAsyncRender;
+		if (!cancelled)
+		{
+			width = swatchInstance.getContext().m_width;
+			height = swatchInstance.getContext().m_height;
+			data = swatchInstance.getContext().getRenderImageData();
+			rendered = true;
+		}
 	}
 	catch (...)
 	{
 		DebugPrint("Unknown error running material swatch render");
 	}
 
-	if (m_finishedAsyncRender)
+	for (FireRenderMaterialSwatchRender* swatch : sameSwatches)
 	{
-		finalizeRendering();
+		swatch->m_finishedAsyncRender = rendered && !swatch->m_cancelAsyncRender;
+
+		if (swatch->m_finishedAsyncRender)
+		{
+			swatch->finalizeRendering(data, width, height);
+		}
+
+		swatch->finishAsyncRender();
 	}
+}
 
+void FireRenderMaterialSwatchRender::finishAsyncRender()
+{
 	std::unique_lock<std::mutex> lck(m_cancellationMutex);
 	m_runningAsyncRender = false;
 	m_cancellationCondVar.notify_one();
 }
 
-bool FireRenderMaterialSwatchRender::finalizeRendering()
+bool FireRenderMaterialSwatchRender::finalizeRendering(const std::vector<float>& data, unsigned int width, unsigned int height)
 {
-	FireRenderContext & context = getSwatchInstance().getContext();
-
-	unsigned int width = context.m_width;
-	unsigned int height = context.m_height;
-	std::vector<float> data = context.getRenderImageData();
-
 	MImage& img = image();
 
-	img.setFloatPixels(data.data(), width, height);
+	img.setFloatPixels(const_cast<float*>(data.data()), width, height);
 	img.convertPixelFormat(MImage::kByte);
 
+	SwatchCache::GetInstance().Add(m_cacheKey, img.pixels(), width, height);
+
 	finishParallelRender();
 
 	return true;
 }
 
+bool FireRenderMaterialSwatchRender::readFromCache()
+{
+	std::vector<unsigned char> pixels;
+	unsigned int width = 0;
+	unsigned int height = 0;
+
+	if (!SwatchCache::GetInstance().Find(m_cacheKey, pixels, width, height))
+	{
+		return false;
+	}
+
+	image().setPixels(pixels.data(), width, height);
+
+	return true;
+}
+
 bool FireRenderMaterialSwatchRender::doIterationForNonFRNode()
 {
 	MImage& img = image();
@@ -262,7 +474,7 @@ void FireRenderMaterialSwatchRender::cancelParallelRendering()
 {
 	DebugPrint("FireRenderMaterialSwatchRender::cancelParallelRendering()");
 
-	getSwatchInstance().removeFromQueue(this);
+	FireRenderSwatchInstance::removeFromQueueIfInitialized(this);
 
 	m_cancelAsyncRender = true;
 
@@ -45,7 +45,18 @@ public:
 
 	FireRenderSwatchInstance& getSwatchInstance();
 
-	void processFromBackgroundThread();
+	// Renders the swatch. Result is also used by swatches of the same material and resolution
+	void processFromBackgroundThread(const std::vector<FireRenderMaterialSwatchRender*>& sameSwatches);
+
+	// True if the swatch shows the same material network with the same resolution
+	bool isSameSwatch(const FireRenderMaterialSwatchRender& other) const;
+
+	// Hash of the material node and all upstream nodes: their types, values of the non default attributes, connections
+	// and modification times of the referenced files. Node names are not used, so identical networks have the same hash
+	static HashValue GetMaterialNetworkHash(const MObject& node);
+
+	// Hash of the render globals which change the swatch image (tone mapping and gamma)
+	static HashValue GetSwatchSettingsHash();
 
 	void setAsyncRunning(bool val) { m_runningAsyncRender = val; }
 
@@ -54,11 +65,17 @@ public:
 
 private:
 	bool doIterationForNonFRNode();
-	bool finalizeRendering();
+	bool finalizeRendering(const std::vector<float>& data, unsigned int width, unsigned int height);
+
+	// Notifies cancelParallelRendering that background processing of this swatch is over
+	void finishAsyncRender();
 
 	bool IsFRNode() const;
 	bool setupFRNode();
 
+	// Fills the image from the swatch cache, returns false if the swatch is not cached
+	bool readFromCache();
+
 private:
 	std::atomic<bool> m_runningAsyncRender;
 	std::atomic<bool> m_finishedAsyncRender;
@@ -69,6 +86,12 @@ private:
 
 	int m_resolution;
 
+	// hash of the material network, valid after setupFRNode
+	HashValue m_materialHash;
+
+	// key of the swatch image in SwatchCache
+	size_t m_cacheKey;
+
 	// for cancelation synchronization
 	std::mutex m_cancellationMutex;
 	std::condition_variable m_cancellationCondVar;
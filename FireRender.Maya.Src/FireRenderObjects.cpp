@@ -57,6 +57,7 @@ limitations under the License.
 
 #include <maya/MUuid.h>
 #include "Lights/PhysicalLight/PhysicalLightAttributes.h"
+#include "Lights/PhysicalLight/PhysicalLightGeometryUtility.h"
 
 FireRenderObject::FireRenderObject(FireRenderContext* context, const MObject& ob)
 {
@@ -275,9 +276,6 @@ HashValue GetHashValue(const MPlug& plug)
 	if (plug.isIgnoredWhenRendering())
 		return hash;
 
-	if (!plug.isKeyable())
-		return hash;
-
 	auto data = plug.asMDataHandle();
 
 	auto type = data.type();
@@ -347,6 +345,11 @@ HashValue GetHashValue(const MPlug& plug)
 	{
 		hash << data.asMatrix();
 	}	break;
+	case MFnData::kString:
+	{
+		MString str = data.asString();
+		hash.Append(str.asChar(), str.length());
+	}	break;
 	case MFnData::kDoubleArray:
 	case MFnData::kFloatArray:
 	case MFnData::kIntArray:
@@ -361,6 +364,57 @@ HashValue GetHashValue(const MPlug& plug)
 	return hash;
 }
 
+HashValue FireRenderObject::GetAttributesHash(const MObject& ob)
+{
+	HashValue hash;
+	MFnDependencyNode node(ob);
+
+	for (unsigned int i = 0; i < node.attributeCount(); i++)
+	{
+		MObject attribute = node.attribute(i);
+
+		// children are hashed with their parents
+		if (!MFnAttribute(attribute).parent().isNull())
+			continue;
+
+		hash << (size_t) GetHashValue(MPlug(ob, attribute));
+	}
+
+	return hash;
+}
+
+HashValue FireRenderObject::GetUpstreamHash(const MPlug& plug)
+{
+	HashValue hash;
+
+	MPlugArray sources;
+	if (plug.isNull() || !plug.connectedTo(sources, true, false) || sources.length() == 0)
+		return hash;
+
+	MString sourceName = sources[0].partialName();
+	hash.Append(sourceName.asChar(), sourceName.length());
+
+	MStatus status;
+	MItDependencyGraph itdep(
+		sources[0].node(),
+		MFn::kDependencyNode,
+		MItDependencyGraph::kUpstream,
+		MItDependencyGraph::kBreadthFirst,
+		MItDependencyGraph::kNodeLevel,
+		&status);
+
+	for (; !itdep.isDone(); itdep.next())
+	{
+		MObject currentItem = itdep.currentItem();
+
+		std::string uuid = getNodeUUid(currentItem);
+		hash.Append(uuid.c_str(), (int) uuid.size());
+		hash << (size_t) GetAttributesHash(currentItem);
+	}
+
+	return hash;
+}
+
 void FireRenderObject::Freshen(bool shouldCalculateHash)
 {
 	if (m.callbackId.empty())
@@ -2188,7 +2242,56 @@ bool FireRenderLight::ShouldUpdateTransformOnly() const
 
 bool FireRenderPhysLight::ShouldUpdateTransformOnly() const
 {
-	return false;
+	return m_bIsTransformChanged && m_canUpdateTransformOnly;
+}
+
+void FireRenderPhysLight::Freshen(bool shouldCalculateHash)
+{
+	// Moving many lights at once shouldn't retranslate them if only transforms were changed.
+	// Attributes are hashed only for render types which calculate hashes
+	HashValue attributeHash;
+
+	if (shouldCalculateHash)
+	{
+		attributeHash = GetAttributesHash(Object());
+		attributeHash << (size_t) GetUpstreamHash(MFnDependencyNode(Object()).findPlug(PhysicalLightAttributes::colorPicker, false));
+	}
+
+	m_canUpdateTransformOnly = shouldCalculateHash && (attributeHash == m_attributeHash) && CanUpdateTransformOnly();
+
+	FireRenderLight::Freshen(shouldCalculateHash);
+
+	m_canUpdateTransformOnly = false;
+	m_attributeHash = attributeHash;
+
+	if (m_light.isAreaLight)
+	{
+		m_areaLightShape = PhysicalLightAttributes::GetAreaLightShape(Object());
+		m_area = GetAreaOfAreaLight();
+	}
+}
+
+bool FireRenderPhysLight::CanUpdateTransformOnly()
+{
+	if (!m_light.isAreaLight)
+		return m_light.light.IsValid();
+
+	// Only instances of the shape prototypes have the transform of the light.
+	// Emission is normalized by the area, so scaled lights need the new emissive shader
+	return m_light.areaLight && (m_areaLightShape != PLAMesh) &&
+		(fabs(GetAreaOfAreaLight() - m_area) <= m_area * 1e-5f);
+}
+
+float FireRenderPhysLight::GetAreaOfAreaLight()
+{
+	// Same as the transform of the area light shape
+	MTransformationMatrix transformation;
+
+	double areaWidth = PhysicalLightAttributes::GetAreaWidth(Object());
+	double scale[3]{ areaWidth, areaWidth, PhysicalLightAttributes::GetAreaLength(Object()) };
+	transformation.setScale(scale, MSpace::Space::kObject);
+
+	return PhysicalLightGeometryUtility::GetAreaOfMeshPrimitive(m_areaLightShape, transformation.asMatrix() * DagPath().inclusiveMatrix());
 }
 
 PLType FireRenderPhysLight::GetPhysLightType(MObject node)
@@ -2221,7 +2324,7 @@ void FireRenderLight::Freshen(bool shouldCalculateHash)
 
 		if (depNode.typeId() == FireMaya::TypeId::FireRenderPhysicalLightLocator)
 		{
-			FireMaya::translateLight(m_light, context()->GetScope(), Context(), node, mMtx);
+			FireMaya::translateLight(m_light, context()->GetScope(), Context(), node, mMtx, false, context()->GetLightDataBatch());
 		}
 		else if (node.hasFn(MFn::kPluginLocatorNode) || node.hasFn(MFn::kPluginTransformNode))
 		{
@@ -2321,6 +2424,7 @@ void FireRenderEnvLight::clear()
 		context()->iblLight = nullptr;
 	}
 	m_matrix = MMatrix();
+	detachPortals();
 	m.light.Reset();
 	m.image.Reset();
 	m.bgOverride.Reset();
@@ -2416,6 +2520,7 @@ void setPortal_IBL(MObject transformObject, FireRenderEnvLight *light) {
 						if (element.shape)
 						{
 							light->m.light.AttachPortal(element.shape);
+							light->m.portals.push_back(element.shape);
 						}
 					}
 				}
@@ -2429,12 +2534,20 @@ void setPortal_IBL(MObject transformObject, FireRenderEnvLight *light) {
 	}
 }
 
+void FireRenderEnvLight::detachPortals()
+{
+	for (auto& portal : m.portals)
+		m.light.DetachPortal(portal);
+
+	m.portals.clear();
+}
+
 void FireRenderEnvLight::Freshen(bool shouldCalculateHash)
 {
 	RestorePortalStates(true);
 
 	detachFromScene();
-	m.light.Reset();
+	detachPortals();
 	m.image.Reset();
 	m.bgOverride.Reset();
 
@@ -2465,13 +2578,20 @@ void FireRenderEnvLight::Freshen(bool shouldCalculateHash)
 				// from external side of the sphere, but we look from inside sphere
 				// That's why pass true if IBL flip parameter is false and vice versa
 
-				m.image = context()->GetScope().GetImage(filePath, colorSpace, dagPath.partialPathName());
+				// Viewport and IPR use preview resolution, importance sampling data of the smaller image is built much faster
+				m.image = context()->GetScope().GetImage(filePath, colorSpace, dagPath.partialPathName(), context()->environmentImageMaxWidth());
 			}
 		}
 
-		bool ambLightChecker = false;
+		// The light is reused, so an unchanged image doesn't rebuild its importance sampling data.
+		// Ambient lights are created again, they can't be switched back to the image.
+		bool update = m.light && !m.light.IsAmbientLight();
 		auto scope = this->Scope();
-		FireMaya::translateEnvLight(m.light, m.image, Context(), scope, node, dagPath.inclusiveMatrix(), ambLightChecker);
+		if (!FireMaya::translateEnvLight(m.light, m.image, Context(), scope, node, dagPath.inclusiveMatrix(), update))
+		{
+			m.light.Reset();
+		}
+
 		if (m.light)
 		{
 			setPortal_IBL(dagPath.transform(), this);
@@ -2524,6 +2644,10 @@ void FireRenderEnvLight::Freshen(bool shouldCalculateHash)
 			linkedShader.LinkLight(getLight());
 		}
 	}
+	else
+	{
+		m.light.Reset();
+	}
 
 	FireRenderNode::Freshen(shouldCalculateHash);
 }
@@ -2929,9 +3053,15 @@ void FireRenderDisplayLayer::attributeChanged(MNodeMessage::AttributeMessage msg
 //===================
 // Sky
 //===================
+namespace
+{
+	// Size of the sky image for the production render
+	const unsigned int SkyImageWidth = 1024;
+}
+
 FireRenderSky::FireRenderSky(FireRenderContext* context, const MDagPath& dagPath) :
 	FireRenderNode(context, dagPath),
-	m_skyBuilder(new SkyBuilder(dagPath.node()))
+	m_skyBuilder(new SkyBuilder(dagPath.node(), SkyImageWidth, SkyImageWidth))
 {}
 
 FireRenderSky::~FireRenderSky()
@@ -2997,6 +3127,17 @@ void FireRenderSky::Freshen(bool shouldCalculateHash)
 
 	if (dagPath.isValid())
 	{
+		// Viewport and IPR use preview resolution, lat-long sky doesn't need more rows than a half of its width
+		if (unsigned int maxWidth = context()->environmentImageMaxWidth())
+		{
+			unsigned int width = std::min(SkyImageWidth, std::max(maxWidth, 2u));
+			m_skyBuilder->setImageSize(width, width / 2);
+		}
+		else
+		{
+			m_skyBuilder->setImageSize(SkyImageWidth, SkyImageWidth);
+		}
+
 		if (FireMaya::translateSky(m_envLight, m_sunLight, m_image, *m_skyBuilder, Context(), node, dagPath.inclusiveMatrix(), m_initialized))
 		{
 			setPortal_Sky(dagPath.transform(), this);
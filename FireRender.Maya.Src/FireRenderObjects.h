@@ -20,6 +20,7 @@ limitations under the License.
 #include <maya/MFnFluid.h>
 #include <string>
 #include <atomic>
+#include <unordered_map>
 #include "FireMaya.h"
 
 #include "PhysicalLightData.h"
@@ -27,6 +28,7 @@ limitations under the License.
 // Forward declarations
 class FireRenderContext;
 class SkyBuilder;
+struct HairStrandsSource;
 
 class HashValue
 {
@@ -117,6 +119,12 @@ public:
 	static void Dump(const MObject& ob, int depth = 0, int maxDepth = 4);
 	static HashValue GetHash(const MObject& ob);
 
+	// Hash of the attribute values of the node
+	static HashValue GetAttributesHash(const MObject& ob);
+
+	// Hash of the nodes connected upstream of the plug, zero if it isn't connected
+	static HashValue GetUpstreamHash(const MPlug& plug);
+
 	static std::string uuidWithoutInstanceNumberForString(const std::string& uuid);
 
 	// update fire render objects using Maya objects, then marks as clean
@@ -507,8 +515,27 @@ public:
 
 	static PLType GetPhysLightType(MObject dagPath);
 
+	virtual void Freshen(bool shouldCalculateHash) override;
+
 protected:
 	virtual bool ShouldUpdateTransformOnly() const;
+
+private:
+	// True if the translated light can be moved without translating it again
+	bool CanUpdateTransformOnly();
+
+	// Area of the primitive area light shape with the current transform
+	float GetAreaOfAreaLight();
+
+	// hash of the light node attributes and color inputs at the last update
+	HashValue m_attributeHash;
+
+	// only the transform should be updated by the current Freshen
+	bool m_canUpdateTransformOnly = false;
+
+	// area light shape and area at the last update
+	PLAreaLightShape m_areaLightShape = PLARectangle;
+	float m_area = 0.0f;
 };
 
 // Fire render environment light
@@ -541,6 +568,9 @@ public:
 
 	inline frw::EnvironmentLight getLight() { return m.light; }
 
+	// detach portals attached by the last Freshen
+	void detachPortals();
+
 protected:
 	virtual void attachToSceneInternal();
 	virtual void detachFromSceneInternal();
@@ -557,6 +587,9 @@ public:
 		frw::EnvironmentLight bgOverride;
 
 		frw::Image image;
+
+		// portal shapes attached to the light
+		std::vector<frw::Shape> portals;
 	} m;
 };
 
@@ -797,8 +830,8 @@ protected:
 	bool ReadSpeedIntoArray(MFnFluid& fnFluid, std::vector<float>& outputValues);
 	bool ProcessInputField(int inputField, std::vector<float>& outData, unsigned int Xres, unsigned int Yres, unsigned int Zres, MFnFluid& fnFluid);
 
-	// apply noise to channel
-	bool ApplyNoise(std::vector<float>& channelValues);
+	// apply fluid texture noise to channel, gainPlugName is the channel texture gain attribute
+	bool ApplyNoise(std::vector<float>& channelValues, const VolumeData* pVolumeData, const MFnDependencyNode& shaderNode, const char* gainPlugName);
 };
 
 // Bridge class between RPR Volume node and frw::Volume
@@ -896,6 +929,10 @@ public:
 	void setCastShadows(bool castShadow);
 	void setReceiveShadows(bool recieveShadow);
 
+	// creates curves for fixed size chunks of strands
+	// chunks which did not change since the previous refresh reuse their curves
+	void CreateChunkedCurves(const HairStrandsSource& source);
+
 protected:
 	// applies transform to node
 	void ApplyTransform(void);
@@ -923,6 +960,12 @@ protected:
 
 	// curves
 	std::vector<frw::Curve> m_Curves;
+
+	// content hash of each curve (chunk of strands), same order as m_Curves
+	std::vector<HashValue> m_CurveHashes;
+
+	// curves of the previous refresh by content hash, valid only while curves are created
+	std::unordered_map<size_t, frw::Curve> m_PreviousCurves;
 };
 
 class FireRenderHairXGenGrooming : public FireRenderHair
@@ -0,0 +1,171 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "FireRenderSkyBenchmarkCmd.h"
+
+#include "SkyAttributes.h"
+#include "SkyLayers.h"
+
+#include <maya/MGlobal.h>
+#include <maya/MStringArray.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	double MeasureMilliseconds(const std::function<void()>& func)
+	{
+		auto start = std::chrono::steady_clock::now();
+		func();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	MFloatVector SunDirection(float altitudeDegrees)
+	{
+		float altitude = float(altitudeDegrees * PI / 180.0);
+		return MFloatVector(cos(altitude), 0.0f, sin(altitude));
+	}
+
+	template <typename... Args>
+	MString Format(const char* format, const Args&... args)
+	{
+		char buffer[256];
+		snprintf(buffer, sizeof(buffer), format, args...);
+		return MString(buffer);
+	}
+}
+
+void* FireRenderSkyBenchmarkCmd::creator()
+{
+	return new FireRenderSkyBenchmarkCmd;
+}
+
+MSyntax FireRenderSkyBenchmarkCmd::newSyntax()
+{
+	MSyntax syntax;
+
+	CHECK_MSTATUS(syntax.addFlag(kSkyBenchmarkWidthFlag, kSkyBenchmarkWidthFlagLong, MSyntax::kLong));
+	CHECK_MSTATUS(syntax.addFlag(kSkyBenchmarkHeightFlag, kSkyBenchmarkHeightFlagLong, MSyntax::kLong));
+
+	return syntax;
+}
+
+MStatus FireRenderSkyBenchmarkCmd::doIt(const MArgList& args)
+{
+	MStatus status;
+	MArgDatabase argData(syntax(), args, &status);
+	if (!status)
+		return status;
+
+	// Default sky image size
+	int width = 1024;
+	int height = 1024;
+
+	if (argData.isFlagSet(kSkyBenchmarkWidthFlag))
+		argData.getFlagArgument(kSkyBenchmarkWidthFlag, 0, width);
+
+	if (argData.isFlagSet(kSkyBenchmarkHeightFlag))
+		argData.getFlagArgument(kSkyBenchmarkHeightFlag, 0, height);
+
+	if (width <= 0 || height <= 0)
+	{
+		MGlobal::displayError("Sky image size must be positive");
+		return MS::kInvalidParameter;
+	}
+
+	// Default sky node attributes
+	SkyImageParams defaults;
+	defaults.width = width;
+	defaults.height = height;
+	defaults.sunDirection = SunDirection(45.0f);
+	defaults.turbidity = 0.1f;
+	defaults.saturation = 0.5f;
+	defaults.horizonHeight = 0.001f;
+	defaults.horizonBlur = 0.1f;
+	defaults.sunDiskSize = 1.0f;
+	defaults.sunDiskIntensity = 100.0f;
+	defaults.sunGlow = 2.0f;
+	defaults.groundColor = MColor(0.4f, 0.4f, 0.4f);
+	defaults.filterColor = MColor(0.0f, 0.0f, 0.0f);
+
+	// Each change is applied over the previous ones, so every regeneration has a single changed attribute
+	const std::vector<std::pair<const char*, std::function<void(SkyImageParams&)>>> changes =
+	{
+		{ "sun disk size", [](SkyImageParams& p) { p.sunDiskSize = 2.0f; } },
+		{ "sun glow", [](SkyImageParams& p) { p.sunGlow = 10.0f; } },
+		{ "ground color", [](SkyImageParams& p) { p.groundColor = MColor(0.2f, 0.3f, 0.1f); } },
+		{ "filter color", [](SkyImageParams& p) { p.filterColor = MColor(0.1f, 0.0f, 0.0f); } },
+		{ "saturation", [](SkyImageParams& p) { p.saturation = 0.8f; } },
+		{ "horizon blur", [](SkyImageParams& p) { p.horizonBlur = 0.5f; } },
+		{ "sun altitude", [](SkyImageParams& p) { p.sunDirection = SunDirection(30.0f); } },
+	};
+
+	MStringArray results;
+
+	for (short model : { (short) SkyAttributes::kLegacySkyModel, (short) SkyAttributes::kHosekWilkieSkyModel })
+	{
+		const char* modelName = (model == SkyAttributes::kHosekWilkieSkyModel) ? "Hosek-Wilkie" : "legacy";
+
+		SkyImageParams params = defaults;
+		params.skyModel = model;
+
+		SkyLayers layers;
+		std::shared_ptr<const SkyImage> image;
+
+		double fullMs = MeasureMilliseconds([&]() { image = layers.Generate(params); });
+		results.append(Format("Sky %dx%d %s: full generation %.3f ms", width, height, modelName, fullMs));
+
+		// Layered result against the per pixel generator
+		if (model == SkyAttributes::kLegacySkyModel)
+		{
+			std::vector<SkyRgbFloat32> reference(size_t(width) * height);
+
+			SkyGen sg;
+			SetupSkyGenerator(sg, params);
+			double referenceMs = MeasureMilliseconds([&]() { sg.generate(width, height, reference.data()); });
+
+			float maxError = 0.0f;
+			for (size_t idx = 0; idx < reference.size(); ++idx)
+			{
+				const SkyRgbFloat32& a = reference[idx];
+				const SkyRgbFloat32& b = image->pixels[idx];
+				float scale = std::max(1e-6f, std::max(a.r, std::max(a.g, a.b)));
+				maxError = std::max(maxError, std::max(std::fabs(a.r - b.r), std::max(std::fabs(a.g - b.g), std::fabs(a.b - b.b))) / scale);
+			}
+
+			results.append(Format("Sky %dx%d %s: per pixel generation %.3f ms, max relative difference %g", width, height, modelName, referenceMs, maxError));
+		}
+
+		for (const auto& change : changes)
+		{
+			change.second(params);
+
+			double changeMs = MeasureMilliseconds([&]() { image = layers.Generate(params); });
+			results.append(Format("Sky %dx%d %s: %s changed, regeneration %.3f ms", width, height, modelName, change.first, changeMs));
+		}
+	}
+
+	for (unsigned int i = 0; i < results.length(); i++)
+	{
+		MGlobal::displayInfo(results[i]);
+	}
+
+	setResult(results);
+
+	return MS::kSuccess;
+}
@@ -0,0 +1,38 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <maya/MPxCommand.h>
+#include <maya/MSyntax.h>
+#include <maya/MArgDatabase.h>
+
+#define kSkyBenchmarkWidthFlag "-w"
+#define kSkyBenchmarkWidthFlagLong "-width"
+#define kSkyBenchmarkHeightFlag "-ht"
+#define kSkyBenchmarkHeightFlagLong "-height"
+
+/**
+ * Development command, measures the full and the incremental sky regeneration
+ * for typical attribute changes and compares the layered result with the per pixel generator.
+ * Doesn't touch the scene or the sky image cache. The timings are returned as strings.
+ */
+class FireRenderSkyBenchmarkCmd : public MPxCommand
+{
+public:
+
+	static void* creator();
+
+	static MSyntax newSyntax();
+
+	MStatus doIt(const MArgList& args);
+};
@@ -67,6 +67,13 @@ MStatus FireRenderSkyLocator::initialize()
 	nAttr.setMax(50);
 	addAttribute(a);
 
+	// Legacy model is the default, so scenes saved before the attribute was added render the same
+	a = eAttr.create("skyModel", "skm", SkyAttributes::kLegacySkyModel);
+	eAttr.addField("Legacy", SkyAttributes::kLegacySkyModel);
+	eAttr.addField("Hosek-Wilkie", SkyAttributes::kHosekWilkieSkyModel);
+	makeAttribute(eAttr);
+	addAttribute(a);
+
 	a = nAttr.create("intensity", "i", MFnNumericData::kFloat, 1.0f);
 	makeAttribute(nAttr);
 	nAttr.setMin(0);
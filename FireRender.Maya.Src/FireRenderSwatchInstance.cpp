@@ -20,11 +20,13 @@ FireRenderSwatchInstance FireRenderSwatchInstance::m_instance;
 
 using namespace FireMaya;
 
+// Context is kept warm between swatch requests, it is recreated only after this idle time
+static const long ContextIdleTimeoutMs = 120 * 1000;
+
 FireRenderSwatchInstance::FireRenderSwatchInstance()
 {
 	sceneIsCleaned = true;
 	m_shouldClearContext = false;
-	pContext = std::make_unique<NorthStarContext>(); 
 
 	MStatus status;
 	callbackId_FireRenderSwatchInstance = MTimerMessage::addTimerCallback(16.0f, FireRenderSwatchInstance::CheckProcessQueue, nullptr, &status);
@@ -36,6 +38,12 @@ void FireRenderSwatchInstance::initScene()
 	backgroundRendererBusy = false;
 	m_warningDialogOpen = false;
 
+	// context is created on the first swatch request and again after it was released on idle
+	if (!pContext)
+	{
+		pContext = std::make_unique<NorthStarContext>();
+	}
+
 	pContext->setCallbackCreationDisabled(true);
 	pContext->SetRenderType(RenderType::Thumbnail);
 	pContext->initSwatchScene();
@@ -101,11 +109,12 @@ void FireRenderSwatchInstance::ProcessInRenderThread()
 	{
 		try
 		{
-			FireRenderMaterialSwatchRender* item = nullptr;
+			std::vector<FireRenderMaterialSwatchRender*> group;
 
-			while ((item = dequeSwatch()) != nullptr)
+			// swatches of identical materials are rendered once
+			while (dequeSwatchGroup(group))
 			{
-				item->processFromBackgroundThread();
+				group.front()->processFromBackgroundThread(group);
 			}
 		}
 		catch (...)
@@ -122,7 +131,12 @@ void FireRenderSwatchInstance::ProcessInRenderThread()
 			});
 		}
 
-		m_shouldClearContext = true;
+		{
+			RPR::AutoLock<MSpinLock> lock(mutex);
+
+			m_idleStartTime = GetCurrentChronoTime();
+			m_shouldClearContext = true;
+		}
 
 		return false;
 	});
@@ -143,45 +157,71 @@ void FireRenderSwatchInstance::enqueSwatch(FireRenderMaterialSwatchRender* swatc
 	}
 }
 
-FireRenderMaterialSwatchRender* FireRenderSwatchInstance::dequeSwatch()
+bool FireRenderSwatchInstance::dequeSwatchGroup(std::vector<FireRenderMaterialSwatchRender*>& outGroup)
 {
+	outGroup.clear();
+
 	RPR::AutoLock<MSpinLock> lock(mutex);
 
 	if (queueToProcess.size() == 0)
 	{
-		return nullptr;
+		return false;
 	}
 
 	FireRenderMaterialSwatchRender* item = queueToProcess.front();
 	queueToProcess.pop_front();
 
-	item->setAsyncRunning(true);
-	return item;
+	outGroup.push_back(item);
+
+	for (auto it = queueToProcess.begin(); it != queueToProcess.end(); )
+	{
+		if ((*it)->isSameSwatch(*item))
+		{
+			outGroup.push_back(*it);
+			it = queueToProcess.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	for (FireRenderMaterialSwatchRender* swatch : outGroup)
+	{
+		swatch->setAsyncRunning(true);
+	}
+
+	return true;
 }
 
-void FireRenderSwatchInstance::removeFromQueue(FireRenderMaterialSwatchRender* swatch)
+void FireRenderSwatchInstance::removeFromQueueIfInitialized(FireRenderMaterialSwatchRender* swatch)
 {
-	RPR::AutoLock<MSpinLock> lock(mutex);
-	queueToProcess.remove(swatch);
+	if (IsCleaned())
+		return;
+
+	RPR::AutoLock<MSpinLock> lock(m_instance.mutex);
+	m_instance.queueToProcess.remove(swatch);
 }
 
 void FireRenderSwatchInstance::CheckProcessQueue(float elapsedTime, float lastTime, void* clientData)
 {
-	RPR::AutoLock<MSpinLock> lock(instance().mutex);
+	// m_instance is used directly, instance() would initialize the released context
+	RPR::AutoLock<MSpinLock> lock(m_instance.mutex);
 
-	if (!instance().m_shouldClearContext || (instance().queueToProcess.size() != 0))
+	if (!m_instance.m_shouldClearContext || (m_instance.queueToProcess.size() != 0))
 	{
 		return;
 	}
 
-	instance().m_shouldClearContext = false;
+	// keep the warm context while swatches are requested from time to time
+	if (TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), m_instance.m_idleStartTime) < ContextIdleTimeoutMs)
+	{
+		return;
+	}
 
-	// reset context
-	instance().cleanScene();
-	instance().pContext.reset();
+	m_instance.m_shouldClearContext = false;
 
-	instance().pContext = std::make_unique<NorthStarContext>();
-	instance().initScene();
+	// release context, the next swatch request creates it again
+	m_instance.cleanScene();
+	m_instance.pContext.reset();
 }
-
-
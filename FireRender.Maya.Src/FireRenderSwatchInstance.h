@@ -28,8 +28,13 @@ public:
 	void cleanScene();
 
 	void enqueSwatch(FireRenderMaterialSwatchRender* swatch);
-	FireRenderMaterialSwatchRender* dequeSwatch();
-	void removeFromQueue(FireRenderMaterialSwatchRender* swatch);
+
+	// Takes the first queued swatch with all queued swatches of the same material and resolution.
+	// Returns false if the queue is empty
+	bool dequeSwatchGroup(std::vector<FireRenderMaterialSwatchRender*>& outGroup);
+
+	// Doesn't initialize the released context, nothing is queued then
+	static void removeFromQueueIfInitialized(FireRenderMaterialSwatchRender* swatch);
 
 	static void resetInstance();
 
@@ -58,6 +63,9 @@ private:
 	std::atomic<bool> backgroundRendererBusy;
 	std::atomic<bool> m_shouldClearContext;
 
+	// time when the queue became empty, warm context is recreated only after the idle timeout
+	TimePoint m_idleStartTime;
+
 	std::list<FireRenderMaterialSwatchRender*> queueToProcess;
 
 	RenderCacheWarningDialog rcWarningDialog;
@@ -11,6 +11,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ********************************************************************/
 #include "FireRenderThread.h"
+#include "Tracing.h"
 
 #if _WIN32
 #include <windows.h>
@@ -26,6 +27,9 @@ namespace FireMaya
 vector<shared_ptr<FireRenderThread::QueueItemBase>> FireRenderThread::itemQueue;
 vector<shared_ptr<FireRenderThread::QueueItemBase>> FireRenderThread::itemQueueForMainThread;
 mutex FireRenderThread::itemQueueMutex;
+condition_variable FireRenderThread::itemQueueCondition;
+bool FireRenderThread::wakeRequested = false;
+size_t FireRenderThread::idleItemCount = 0;
 unique_ptr<thread> FireRenderThread::ptrWorkerThread;
 atomic_bool FireRenderThread::shouldUseThread { false };
 atomic_bool FireRenderThread::runTheThread { true };
@@ -33,6 +37,9 @@ set<thread::id> FireRenderThread::executingThreadIds;
 
 MCallbackId FireRenderThread::callbackId_RPRMainThreadEvent = 0;
 
+// Upper bound of the idle wait, protects from a missed wake up
+static const auto MaxIdleWaitTime = 100ms;
+
 std::thread::id gMainThreadId;
 
 class QueueItem : public FireRenderThread::QueueItemBase
@@ -80,6 +87,25 @@ void FireRenderThread::KeepRunning(std::function<bool()> function)
 	CheckThreadIsRunning();
 
 	itemQueue.push_back(make_shared<QueueItem>(function));
+	SignalQueueChanged();
+}
+
+void FireRenderThread::SignalQueueChanged()
+{
+	wakeRequested = true;
+	itemQueueCondition.notify_one();
+}
+
+void FireRenderThread::MarkIdle()
+{
+	idleItemCount++;
+}
+
+void FireRenderThread::Wake()
+{
+	unique_lock<mutex> lock(itemQueueMutex);
+
+	SignalQueueChanged();
 }
 
 /* Should return true if thread is running, if we are on that thread or we should not use the thread */
@@ -178,6 +204,7 @@ void FireRenderThread::ThreadProc(void *)
 #if _WIN32
 	SetThreadName(GetCurrentThreadId(), "* FireRenderThread *");
 #endif
+	Tracing::SetThreadName("FireRenderThread");
 	executingThreadIds.emplace(this_thread::get_id());
 
 	while (runTheThread)
@@ -187,20 +214,28 @@ void FireRenderThread::ThreadProc(void *)
 		{
 			unique_lock<mutex> lock(itemQueueMutex);
 			queue = itemQueue;
+
+			// changes signalled from now on should be handled by the next pass
+			wakeRequested = false;
 		}
 
 		if (queue.empty())
 		{
-			this_thread::sleep_for(10ms);
+			unique_lock<mutex> lock(itemQueueMutex);
+			itemQueueCondition.wait_for(lock, 10ms, [] { return wakeRequested || !runTheThread; });
 		}
 		else
 		{
+			idleItemCount = 0;
+
 			for (auto item : queue)
 			{
 				item->Run();
 				this_thread::yield();
 			}
 
+			bool allItemsIdle = idleItemCount >= queue.size();
+
 			{
 				unique_lock<mutex> lock(itemQueueMutex);
 				decltype(itemQueue) newQueue;
@@ -210,6 +245,10 @@ void FireRenderThread::ThreadProc(void *)
 						newQueue.push_back(item);
 
 				itemQueue = newQueue;
+
+				// Nobody has work to do: sleep until something changes instead of polling
+				if (allItemsIdle)
+					itemQueueCondition.wait_for(lock, MaxIdleWaitTime, [] { return wakeRequested || !runTheThread; });
 			}
 
 			this_thread::yield();
@@ -244,6 +283,8 @@ void FireRenderThread::RunTheThread(bool value)
 {
 	runTheThread = value;
 
+	Wake();
+
 	if (runTheThread)
 	{
 		CheckThreadIsRunning();
@@ -17,6 +17,8 @@ limitations under the License.
 #include <vector>
 #include <set>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <future>
 #include <thread>
 #include <exception>
@@ -29,6 +31,7 @@ limitations under the License.
 	it can also be used to return actual result if needed (bool, MStatus, etc.)
 	and KeepRunning - which simulates the stand-alone thread
 	so it will keep on executing specified block of code until that block of code returns false
+	(block which has nothing to do should call *MarkIdle* instead of sleeping, thread then waits until *Wake* is called)
 
 	- for *CPU* rendering I do serialize all the calls and if one call calls function that also calls RunOnceAndWait - that block will execute in the same thread
 	- for *GPU* rendering - all *RunOnceAndWait* calls are execute in the calling thread (for maximum speed)
@@ -140,6 +143,9 @@ private:
 	static std::vector<std::shared_ptr<QueueItemBase>> itemQueueForMainThread;
 	static std::set<std::thread::id> executingThreadIds;
 	static std::mutex itemQueueMutex;
+	static std::condition_variable itemQueueCondition;
+	static bool wakeRequested;		// guarded by itemQueueMutex
+	static size_t idleItemCount;	// items of the current pass which had nothing to do (used only by the thread)
 	static std::unique_ptr<std::thread> ptrWorkerThread;
 	static std::atomic_bool shouldUseThread;
 	static std::atomic_bool runTheThread;
@@ -165,6 +171,7 @@ public:
 				std::unique_lock<std::mutex> lock(itemQueueMutex);
 
 				itemQueue.emplace(itemQueue.begin(), ptr);
+				SignalQueueChanged();
 			}
 			else
 			{
@@ -186,6 +193,7 @@ public:
 				std::unique_lock<std::mutex> lock(itemQueueMutex);
 
 				itemQueue.emplace(itemQueue.begin(), ptr);
+				SignalQueueChanged();
 			}
 			else
 			{
@@ -247,6 +255,13 @@ public:
 	Block of code should avoid waiting and sleeping as it shares the main thread.
 	*/
 	static void KeepRunningOnMainThread(std::function<bool()> function);
+	/**
+	Should be called by the *KeepRunning* block when it had nothing to do in this pass. If all the blocks are idle
+	the thread waits until *Wake* is called (or the idle timeout elapses) instead of spinning.
+	*/
+	static void MarkIdle();
+	/* Wakes the thread waiting for an idle block. Safe to call from any thread */
+	static void Wake();
 	/* Checks if caller is running on RPR Thread */
 	static void CheckIsOnRPRThread();
 	/* If set to false to just directly run all run and wait calls, returns previous value */
@@ -271,6 +286,8 @@ private:
 
 private:
 	static bool CheckThreadIsRunning();
+	/* Should be called with itemQueueMutex locked */
+	static void SignalQueueChanged();
 	static void ThreadProc(void *);
 	static void RPRMainThreadEventCallback(float, float, void *);
 	static void RegisterRPREventCallback();
@@ -30,6 +30,7 @@ limitations under the License.
 #include <maya/MFileObject.h>
 #include <maya/MCommonSystemUtils.h>
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 #include <time.h>
@@ -106,6 +107,8 @@ FireRenderGlobalsData::FireRenderGlobalsData() :
 	cameraMotionBlur(false),
 	motionBlurCameraExposure(0.0f),
 	motionSamples(0),
+	viewportEnvironmentResolution(0),
+	vdbGridCacheSize(2048),
 	tileRenderingEnabled(false),
 	tileSizeX(0),
 	tileSizeY(0),
@@ -326,6 +329,10 @@ void FireRenderGlobalsData::readFromCurrentScene()
 		if (!plug.isNull())
 			oocTexCache = plug.asInt();
 
+		plug = frGlobalsNode.findPlug("vdbGridCacheSize");
+		if (!plug.isNull())
+			vdbGridCacheSize = (unsigned int) std::max(plug.asInt(), 0);
+
 /*		plug = frGlobalsNode.findPlug("maxRayDepthViewport");
 		if (!plug.isNull())
 			maxRayDepthViewport = plug.asShort();*/
@@ -419,6 +426,10 @@ void FireRenderGlobalsData::readFromCurrentScene()
 		if (!plug.isNull())
 			viewportMotionBlur = plug.asBool();
 
+		plug = frGlobalsNode.findPlug("environmentResolutionViewport");
+		if (!plug.isNull())
+			viewportEnvironmentResolution = (unsigned int) std::max(plug.asInt(), 0);
+
 		plug = frGlobalsNode.findPlug("velocityAOVMotionBlur");
 		if (!plug.isNull())
 			velocityAOVMotionBlur = plug.asBool();
@@ -334,6 +334,9 @@ public:
 	float motionBlurCameraExposure;
 	unsigned int motionSamples;
 
+	// Maximum width of the environment images in the viewport and IPR, 0 for the full resolution
+	unsigned int viewportEnvironmentResolution;
+
 	// Contour
 	bool contourIsEnabled;
 
@@ -370,6 +373,9 @@ public:
 	bool enableOOC;
 	unsigned int oocTexCache;
 
+	// Size of the vdb grid cache in MB
+	unsigned int vdbGridCacheSize;
+
 	DenoiserSettings denoiserSettings;
 	AirVolumeSettings airVolumeSettings;
 
@@ -959,33 +965,38 @@ void RemapRampControlPoints(
 	output.clear();
 	output.reserve(countOutputPoints);
 
-	auto itCurr = inputControlPoints.begin();
-	auto itNext = inputControlPoints.begin(); ++itNext;
 	// 1 element
-	if (itNext == inputControlPoints.end())
+	if (inputControlPoints.size() == 1)
 	{
-		output.push_back(itCurr->ctrlPointData);
+		output.push_back(inputControlPoints.front().ctrlPointData);
 		return;
 	}
 
-	// many elements
+	// many elements; output positions and control points are both sorted, so they are merged in a single sweep
+	auto itNext = inputControlPoints.begin();
 	for (size_t idx = 0; idx < countOutputPoints; ++idx)
 	{
 		float positionOnRamp = (1.0f / (countOutputPoints - 1)) * idx;
 
-		if (positionOnRamp > itNext->position)
+		// first control point which is not before the position
+		while (itNext != inputControlPoints.end() && itNext->position < positionOnRamp)
 		{
-			itNext++;
-			itCurr++;
+			++itNext;
+		}
+
+		if (itNext == inputControlPoints.begin())
+		{
+			output.push_back(itNext->ctrlPointData);
+			continue;
 		}
 
 		if (itNext == inputControlPoints.end())
 		{
-			output.push_back(itCurr->ctrlPointData);
+			output.push_back(inputControlPoints.back().ctrlPointData);
 			continue;
 		}
 
-		valType remappedValue = RampLerp(*itCurr, *itNext, positionOnRamp); // only linear interpolation is currently supported
+		valType remappedValue = RampLerp(*(itNext - 1), *itNext, positionOnRamp); // only linear interpolation is currently supported
 
 		output.push_back(remappedValue);
 	}
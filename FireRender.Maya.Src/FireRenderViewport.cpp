@@ -42,6 +42,13 @@ using namespace FireMaya;
 
 //#define HIGHLIGHT_TEXTURE_UPDATES	1	// debugging: every update will draw a color line on top of the rendered picture
 
+namespace
+{
+	// Camera change to pixels latency of all viewports
+	std::mutex latencyStatsLock;
+	ViewportLatencyStats latencyStats;
+}
+
 MStatus FireRenderViewport::FindMayaView(const MString& panelName, M3dView *view)
 {
     // Get the Maya 3D view.
@@ -66,7 +73,11 @@ FireRenderViewport::FireRenderViewport(const MString& panelName) :
 	m_showUpscaledFrame(false),
 	m_createFailed(false),
 	m_currentAOV(RPR_AOV_COLOR),
-	m_pCurrentTexture(nullptr)
+	m_pCurrentTexture(nullptr),
+	m_cameraGeneration(0),
+	m_presentedGeneration(0),
+	m_cameraChangePending(false),
+	m_pendingCameraGeneration(0)
 {
 	m_alwaysEnabledAOVs.push_back(RPR_AOV_COLOR);
 	m_alwaysEnabledAOVs.push_back(RPR_AOV_VARIANCE);
@@ -124,8 +135,10 @@ MStatus FireRenderViewport::setup()
 		// Acquire the pixels lock.
 		AutoMutexLock pixelsLock(m_pixelsLock);
 
-		// Update the Maya texture from the internal pixel data.
+		// Update the Maya texture from the last presented frame (only the changed region is uploaded).
 		m_pCurrentTexture->UpdateTexture();
+
+		OnTextureUpdated();
 	}
 
 	return doSetup();
@@ -178,6 +191,10 @@ MStatus FireRenderViewport::doSetup()
 		width /= 2;
 		height /= 2;
 	}
+	// Camera moves in the view are picked up by the context refresh below
+	if (m_contextPtr->isCameraDirty())
+		OnCameraChanged();
+
 	// Check if the viewport size has changed.
 	if (width != m_contextPtr->width() || height != m_contextPtr->height())
 	{
@@ -291,6 +308,9 @@ bool FireRenderViewport::RunOnViewportThread()
 			m_contextPtr->cameraAttributeChanged() ||	// camera changed
 			m_contextPtr->keepRenderRunning())			// or we must render just because rendering is not yet completed
 		{
+			// camera changes made before this point are in the rendered frame
+			unsigned int cameraGeneration = m_cameraGeneration;
+
 			try
 			{
 				m_showUpscaledFrame = false;
@@ -299,25 +319,16 @@ bool FireRenderViewport::RunOnViewportThread()
 				FireRenderContext::Lock lock(m_contextPtr.get(), "FireRenderContext::StateRendering"); // lock with constructor which will not change state
 
 				// Perform a render iteration.
+				// Pixels lock is not needed here: the frame is read into the texture back buffer
+				// and the main thread only uploads presented frames
 				{
 					AutoMutexLock contextLock(m_contextLock);
-					
-					if (!NorthStarContext::IsGivenContextNorthStar(m_contextPtr.get()))
-					{
-						AutoMutexLock pixelsLock(m_pixelsLock);
-
-						m_contextPtr->render(false);
-						m_closeDialogNeeded = true;
-
-						readFrameBuffer();
-					}
-					else
-					{
-						m_contextPtr->render(false);
-						m_closeDialogNeeded = true;
-
-						readFrameBuffer();
-					}
+
+					m_contextPtr->render(false);
+					m_closeDialogNeeded = true;
+
+					readFrameBuffer();
+					m_presentedGeneration = cameraGeneration;
 				}
 
 				if (m_renderingErrors > 0)
@@ -353,8 +364,8 @@ bool FireRenderViewport::RunOnViewportThread()
 			}
 			else
 			{
-				// Don't waste CPU time too much when not rendering
-				this_thread::sleep_for(2ms);
+				// Nothing to render: the thread sleeps until the context is changed
+				FireRenderThread::MarkIdle();
 			}
 		}
 
@@ -364,7 +375,8 @@ bool FireRenderViewport::RunOnViewportThread()
 	case FireRenderContext::StatePaused:	// The context is paused.
 	case FireRenderContext::StateUpdating:	// The context is updating.
 	default:								// Handle all other cases.
-		this_thread::sleep_for(5ms);
+		// State change wakes the thread
+		FireRenderThread::MarkIdle();
 		return true;
 	}
 }
@@ -473,6 +485,8 @@ void FireRenderViewport::clearTextureCache()
 // -----------------------------------------------------------------------------
 MStatus FireRenderViewport::cameraChanged(MDagPath& cameraPath)
 {
+	OnCameraChanged();
+
 	auto status = FireRenderThread::RunOnceAndWait<MStatus>([this, &cameraPath]() -> MStatus
 	{
 
@@ -495,6 +509,62 @@ MStatus FireRenderViewport::cameraChanged(MDagPath& cameraPath)
 	return status;
 }
 
+// -----------------------------------------------------------------------------
+void FireRenderViewport::OnCameraChanged()
+{
+	AutoMutexLock lock(m_latencyLock);
+
+	unsigned int generation = ++m_cameraGeneration;
+
+	// Measure from the first change which is not displayed yet
+	if (!m_cameraChangePending)
+	{
+		m_cameraChangePending = true;
+		m_pendingCameraGeneration = generation;
+		m_cameraChangeTime = GetCurrentChronoTime();
+	}
+}
+
+// -----------------------------------------------------------------------------
+void FireRenderViewport::OnTextureUpdated()
+{
+	AutoMutexLock lock(m_latencyLock);
+
+	if (!m_cameraChangePending || m_presentedGeneration < m_pendingCameraGeneration)
+		return;
+
+	m_cameraChangePending = false;
+
+	double latency = TimeDiffChrono<std::chrono::microseconds>(GetCurrentChronoTime(), m_cameraChangeTime) / 1000.0;
+
+	{
+		AutoMutexLock statsLock(latencyStatsLock);
+
+		latencyStats.sampleCount++;
+		latencyStats.lastMs = latency;
+		latencyStats.averageMs += (latency - latencyStats.averageMs) / latencyStats.sampleCount;
+		latencyStats.maxMs = std::max(latencyStats.maxMs, latency);
+	}
+
+	DebugPrint("Viewport camera change latency: %.2f ms", latency);
+}
+
+// -----------------------------------------------------------------------------
+ViewportLatencyStats FireRenderViewport::GetLatencyStats()
+{
+	AutoMutexLock lock(latencyStatsLock);
+
+	return latencyStats;
+}
+
+// -----------------------------------------------------------------------------
+void FireRenderViewport::ResetLatencyStats()
+{
+	AutoMutexLock lock(latencyStatsLock);
+
+	latencyStats = ViewportLatencyStats();
+}
+
 // -----------------------------------------------------------------------------
 MStatus FireRenderViewport::refresh()
 {
@@ -784,15 +854,18 @@ void FireRenderViewport::readFrameBuffer(FireMaya::StoredFrame* storedFrame, boo
 	else
 	{
 		// setup params
-		params.pixels = (RV_PIXEL*) m_texture.GetPixelData();
+		params.pixels = (RV_PIXEL*) m_texture.GetBackBuffer();
 		params.mergeShadowCatcher = true;
 
 		// process frame buffer
 		m_contextPtr->readFrameBufferSimple(params);
 
+		// hand the frame over to the main thread
+		m_texture.PresentBackBuffer();
+
 		if (runDenoiserAndUpscaler)
 		{
-			m_textureUpscaled.SetPixelData(m_contextPtr->DenoiseAndUpscaleForViewport());
+			m_textureUpscaled.PresentPixelData(m_contextPtr->DenoiseAndUpscaleForViewport());
 			m_textureChanged = true;
 		}
 
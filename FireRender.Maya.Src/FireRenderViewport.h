@@ -13,6 +13,8 @@ limitations under the License.
 #pragma once
 
 #include <vector>
+#include <atomic>
+#include <mutex>
 #include "frWrap.h"
 
 #include <maya/MCallbackIdArray.h>
@@ -33,6 +35,15 @@ limitations under the License.
 #include "NorthStarRenderingHelper.h"
 #include "ViewportTexture.h"
 
+/** Camera change to presented pixels latency statistics of all viewports, in milliseconds. */
+struct ViewportLatencyStats
+{
+	size_t sampleCount = 0;
+	double lastMs = 0.0;
+	double averageMs = 0.0;
+	double maxMs = 0.0;
+};
+
 /**
  * A viewport is responsible for rendering to a texture
  * that is then rendered to a Maya viewport panel.
@@ -106,6 +117,12 @@ public:
 	bool ShouldBeRecreated() const { return m_contextPtr && !m_contextPtr->DoesContextSupportCurrentSettings(); }
 
 	void OnBufferAvailableCallback(float progress);
+
+	/** Returns camera change to presented pixels latency statistics. */
+	static ViewportLatencyStats GetLatencyStats();
+
+	/** Clears latency statistics. */
+	static void ResetLatencyStats();
 private:
 
 	// Members
@@ -171,6 +188,19 @@ private:
 
 	ViewportTexture* m_pCurrentTexture;
 
+	/** Camera change generation, incremented on every camera change. */
+	std::atomic<unsigned int> m_cameraGeneration;
+
+	/** Camera generation of the last presented frame. */
+	std::atomic<unsigned int> m_presentedGeneration;
+
+	/** First camera change which is not on the screen yet (guarded by the latency lock). */
+	bool m_cameraChangePending;
+	unsigned int m_pendingCameraGeneration;
+	TimePoint m_cameraChangeTime;
+
+	std::mutex m_latencyLock;
+
 	// Private Methods
 	// -----------------------------------------------------------------------------
 private:
@@ -223,4 +253,10 @@ private:
 	rpr_GLuint* GetGlTexture() const;
 
 	void ScheduleViewportUpdate();
+
+	/** Starts latency measurement, if it was not started yet. */
+	void OnCameraChanged();
+
+	/** Finishes latency measurement when the frame with the camera change gets to the texture. */
+	void OnTextureUpdated();
 };
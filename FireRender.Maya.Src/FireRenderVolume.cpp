@@ -14,7 +14,11 @@ limitations under the License.
 #include "Context/FireRenderContext.h"
 #include "FireRenderUtils.h"
 #include "Volumes/VolumeAttributes.h"
+#include "Volumes/FluidNoise.h"
+#include "Volumes/GridValues.h"
+#include "ParallelFor.h"
 #include "FastNoise.h"
+#include "Tracing.h"
 
 #include <float.h>
 #include <array>
@@ -22,6 +26,7 @@ limitations under the License.
 #include <vector>
 #include <iterator>
 #include <stdint.h>
+#include <cstring>
 
 #include <maya/MFnLight.h>
 #include <maya/MFnDependencyNode.h>
@@ -272,8 +277,8 @@ bool FireRenderRPRVolume::TranslateVolume()
 			vdata.densityGrid.size.gridSizeX,
 			vdata.densityGrid.size.gridSizeY,
 			vdata.densityGrid.size.gridSizeZ,
-			vdata.densityGrid.gridOnIndices,
-			vdata.densityGrid.gridOnValueIndices,
+			vdata.densityGrid.GetIndices(),
+			vdata.densityGrid.GetValues(),
 			RPR_GRID_INDICES_TOPOLOGY_XYZ_U32
 		);
 
@@ -290,8 +295,8 @@ bool FireRenderRPRVolume::TranslateVolume()
 			vdata.albedoGrid.size.gridSizeX,
 			vdata.albedoGrid.size.gridSizeY,
 			vdata.albedoGrid.size.gridSizeZ,
-			vdata.albedoGrid.gridOnIndices,
-			vdata.albedoGrid.gridOnValueIndices,
+			vdata.albedoGrid.GetIndices(),
+			vdata.albedoGrid.GetValues(),
 			RPR_GRID_INDICES_TOPOLOGY_XYZ_U32
 		);
 	}
@@ -302,8 +307,8 @@ bool FireRenderRPRVolume::TranslateVolume()
 			vdata.emissionGrid.size.gridSizeX,
 			vdata.emissionGrid.size.gridSizeY,
 			vdata.emissionGrid.size.gridSizeZ,
-			vdata.emissionGrid.gridOnIndices,
-			vdata.emissionGrid.gridOnValueIndices,
+			vdata.emissionGrid.GetIndices(),
+			vdata.emissionGrid.GetValues(),
 			RPR_GRID_INDICES_TOPOLOGY_XYZ_U32
 		);
 	}
@@ -444,8 +449,8 @@ void NorthstarRPRVolume_DebugDumpGrid(
 	size_t gridSizeX, 
 	size_t gridSizeY, 
 	size_t gridSizeZ, 
-	std::vector<uint32_t>& gridOnIndices,
-	std::vector<float>& dataToDump, 
+	const std::vector<uint32_t>& gridOnIndices,
+	const std::vector<float>& dataToDump, 
 	std::vector<float>* plookupTable,
 	const std::string& pathToFile,
 	const std::string& caption)
@@ -540,42 +545,18 @@ bool NorthstarRPRVolume::TranslateVolume()
 	if (vdata.densityGrid.IsValid()) // grid exists
 	{
 		// normalize density grid
-		float maxDensityGridValue = *std::max_element(
-			vdata.densityGrid.gridOnValueIndices.begin(), vdata.densityGrid.gridOnValueIndices.end());
-		if (maxDensityGridValue > 1.0f)
-		{
-			for (size_t idx = 0; idx < vdata.densityGrid.gridOnValueIndices.size(); idx++)
-			{
-				vdata.densityGrid.gridOnValueIndices[idx] = vdata.densityGrid.gridOnValueIndices[idx] / maxDensityGridValue;
-			}
-		}
+		NormalizeGridValues(vdata.densityGrid.GetValues(), vdata.densityGrid.processedValues);
 
 		// compute grid values because density lookup is not implemented in Northstar
-		std::vector<float>& lookupTable = vdata.densityGrid.valuesLookUpTable;
-		size_t countCtrlPoints = lookupTable.size() / 3;
-		float step = 1.0f / ((countCtrlPoints > 1) ? (countCtrlPoints - 1) : 1);
-		for (float& gridVal : vdata.densityGrid.gridOnValueIndices)
-		{
-			// - find 2 closest ctrl points
-			volatile size_t leftSideCtrlPoint = floor(gridVal / step);
-
-			volatile size_t rightSideCtrlPoint = leftSideCtrlPoint;
-			if (leftSideCtrlPoint < countCtrlPoints - 1)
-			{
-				rightSideCtrlPoint = leftSideCtrlPoint + 1;
-			}
-
-			// - interpolate color values from 2 ctrl points
-			gridVal = gridVal * (lookupTable[leftSideCtrlPoint * 3] + lookupTable[rightSideCtrlPoint * 3]) / 2.0f;
-		}
+		ApplyDensityLookupTable(vdata.densityGrid.GetProcessedValues(), vdata.densityGrid.valuesLookUpTable);
 
 		// proceed with grid creation
 		m_densityGrid = Context().CreateVolumeGrid(
 			vdata.densityGrid.size.gridSizeX,
 			vdata.densityGrid.size.gridSizeY,
 			vdata.densityGrid.size.gridSizeZ,
-			vdata.densityGrid.gridOnIndices,
-			vdata.densityGrid.gridOnValueIndices,
+			vdata.densityGrid.GetIndices(),
+			vdata.densityGrid.GetValues(),
 			RPR_GRID_INDICES_TOPOLOGY_XYZ_U32
 		);
 
@@ -596,8 +577,8 @@ bool NorthstarRPRVolume::TranslateVolume()
 			vdata.densityGrid.gridSizeX,
 			vdata.densityGrid.gridSizeY,
 			vdata.densityGrid.gridSizeZ,
-			vdata.densityGrid.gridOnIndices,
-			vdata.densityGrid.gridOnValueIndices,
+			vdata.densityGrid.GetIndices(),
+			vdata.densityGrid.GetValues(),
 			nullptr,
 			"C://temp//dbg//",
 			"density_grid_Z_"
@@ -608,24 +589,15 @@ bool NorthstarRPRVolume::TranslateVolume()
 	if (vdata.albedoGrid.IsValid()) // grid exists
 	{
 		// normalize grid data
-		float maxAlbedoGridValue = *std::max_element(
-			vdata.albedoGrid.gridOnValueIndices.begin(),
-			vdata.albedoGrid.gridOnValueIndices.end());
-		if (maxAlbedoGridValue > 1.0f)
-		{
-			for (size_t idx = 0; idx < vdata.albedoGrid.gridOnValueIndices.size(); idx++)
-			{
-				vdata.albedoGrid.gridOnValueIndices[idx] = vdata.albedoGrid.gridOnValueIndices[idx] / maxAlbedoGridValue;
-			}
-		}
+		NormalizeGridValues(vdata.albedoGrid.GetValues(), vdata.albedoGrid.processedValues);
 
 		// create grid
 		m_albedoGrid = Context().CreateVolumeGrid(
 			vdata.albedoGrid.size.gridSizeX,
 			vdata.albedoGrid.size.gridSizeY,
 			vdata.albedoGrid.size.gridSizeZ,
-			vdata.albedoGrid.gridOnIndices,
-			vdata.albedoGrid.gridOnValueIndices,
+			vdata.albedoGrid.GetIndices(),
+			vdata.albedoGrid.GetValues(),
 			RPR_GRID_INDICES_TOPOLOGY_XYZ_U32
 		);
 
@@ -652,8 +624,8 @@ bool NorthstarRPRVolume::TranslateVolume()
 				vdata.albedoGrid.gridSizeX,
 				vdata.albedoGrid.gridSizeY,
 				vdata.albedoGrid.gridSizeZ,
-				vdata.albedoGrid.gridOnIndices,
-				vdata.albedoGrid.gridOnValueIndices,
+				vdata.albedoGrid.GetIndices(),
+				vdata.albedoGrid.GetValues(),
 				&albedoValues,
 				"C://temp//dbg//",
 				"temperature_grid_Z_"
@@ -670,24 +642,15 @@ bool NorthstarRPRVolume::TranslateVolume()
 	if (vdata.emissionGrid.IsValid()) // grid exists
 	{
 		// normalize grid data
-		float maxEmissionGridValue = *std::max_element(
-			vdata.emissionGrid.gridOnValueIndices.begin(),
-			vdata.emissionGrid.gridOnValueIndices.end());
-		if (maxEmissionGridValue > 1.0f)
-		{
-			for (size_t idx = 0; idx < vdata.emissionGrid.gridOnValueIndices.size(); idx++)
-			{
-				vdata.emissionGrid.gridOnValueIndices[idx] = vdata.emissionGrid.gridOnValueIndices[idx] / maxEmissionGridValue;
-			}
-		}
+		NormalizeGridValues(vdata.emissionGrid.GetValues(), vdata.emissionGrid.processedValues);
 
 		// create grid
 		m_emissionGrid = Context().CreateVolumeGrid(
 			vdata.emissionGrid.size.gridSizeX,
 			vdata.emissionGrid.size.gridSizeY,
 			vdata.emissionGrid.size.gridSizeZ,
-			vdata.emissionGrid.gridOnIndices,
-			vdata.emissionGrid.gridOnValueIndices,
+			vdata.emissionGrid.GetIndices(),
+			vdata.emissionGrid.GetValues(),
 			RPR_GRID_INDICES_TOPOLOGY_XYZ_U32
 		);
 
@@ -735,8 +698,8 @@ bool NorthstarRPRVolume::TranslateVolume()
 			vdata.emissionGrid.gridSizeX,
 			vdata.emissionGrid.gridSizeY,
 			vdata.emissionGrid.gridSizeZ,
-			vdata.emissionGrid.gridOnIndices,
-			vdata.emissionGrid.gridOnValueIndices,
+			vdata.emissionGrid.GetIndices(),
+			vdata.emissionGrid.GetValues(),
 			/*&emissionValues, */ &vdata.emissionGrid.valuesLookUpTable,
 			"C://temp//dbg//",
 			"emission_grid_Z_"
@@ -817,43 +780,34 @@ void RemapControlPoints(std::vector<float>& outputControlPoints, const std::vect
 {
 	const size_t count_of_new_control_points = 100;
 
+	// control points are sorted by position, so the search continues from the previous output point
+	auto itNext = inputControlPoints.begin();
+
 	for (size_t new_ctrl_point_idx = 0; new_ctrl_point_idx < count_of_new_control_points; ++new_ctrl_point_idx)
 	{
 		float dist2vx_normalized = (1.0f / count_of_new_control_points) * new_ctrl_point_idx;
 
-		// get 2 most close control points from opacity ramp control points array
-		const auto* prev_point = &inputControlPoints[0];
-		const auto* next_point = &inputControlPoints[0];
-
-		for (unsigned int idx = 0; idx < inputControlPoints.size(); ++idx) // yes, non-optimal to search every time, but...
+		// get first control point after the output position
+		while (itNext != inputControlPoints.end() && itNext->position <= dist2vx_normalized)
 		{
-			auto& ctrlPoint = inputControlPoints[idx];
-
-			if (ctrlPoint.position > dist2vx_normalized)
-			{
-				if (idx == 0)
-				{
-					AddValToArr(ctrlPoint.ctrlPointData, outputControlPoints);
-					break;
-				}
-
-				next_point = &inputControlPoints[idx];
-				prev_point = &inputControlPoints[idx - 1];
+			++itNext;
+		}
 
-				// interpolate values from theese points
-				// - only linear interpolation is supported atm
-				float coef = ((dist2vx_normalized - prev_point->position) / (next_point->position - prev_point->position));
-				auto prevValue = prev_point->ctrlPointData;
-				auto nextValue = next_point->ctrlPointData;
-				auto calcRes = nextValue - prevValue;
-				calcRes = coef * calcRes;
-				calcRes = calcRes + prevValue;
+		// no values are written past the last control point
+		if (itNext == inputControlPoints.end())
+		{
+			break;
+		}
 
-				AddValToArr(calcRes, outputControlPoints);
-				break;
-			}
+		if (itNext == inputControlPoints.begin())
+		{
+			AddValToArr(itNext->ctrlPointData, outputControlPoints);
+			continue;
 		}
 
+		// interpolate values from theese points
+		// - only linear interpolation is supported atm
+		AddValToArr(RampLerp(*(itNext - 1), *itNext, dist2vx_normalized), outputControlPoints);
 	}
 }
 
@@ -904,6 +858,42 @@ bool FireRenderFluidVolume::TranslateGeneralVolumeData(VolumeData* pVolumeData,
 	return true;
 }
 
+namespace
+{
+	// Grids smaller than that are filled on the calling thread
+	const size_t MinVoxelsPerThread = 64 * 1024;
+
+	// Names of the fluid shader input fields, indices are the values of the "*Input" attributes
+	const char* FluidInputFieldNames[] = { "Constant", "X Gradient", "Y Gradient", "Z Gradient", "Center Gradient", "Density", "Temperature", "Fuel", "Pressure", "Speed" };
+
+	// Maya fluid grids have the same layout as the volume data (x changes fastest)
+	void CopyFluidGrid(const float* source, size_t gridSize, std::vector<float>& outputValues)
+	{
+		outputValues.resize(gridSize);
+
+		if (gridSize > 0)
+		{
+			std::memcpy(outputValues.data(), source, gridSize * sizeof(float));
+		}
+	}
+
+	// Splits z slices of the grid between threads
+	template<class Func>
+	void ForEachSlice(size_t Xres, size_t Yres, size_t Zres, Func func)
+	{
+		size_t sliceSize = std::max<size_t>(Xres * Yres, 1);
+		size_t minSlicesPerThread = std::max<size_t>(MinVoxelsPerThread / sliceSize, 1);
+
+		RPR::ParallelFor(Zres, minSlicesPerThread, [&](size_t firstSlice, size_t lastSlice)
+		{
+			for (size_t z_idx = firstSlice; z_idx < lastSlice; ++z_idx)
+			{
+				func(z_idx);
+			}
+		});
+	}
+}
+
 void FillArrayWithGradient(
 	std::vector<float>& outputValues,
 	unsigned int Xres,
@@ -911,25 +901,33 @@ void FillArrayWithGradient(
 	unsigned int Zres,
 	const MFnFluid::FluidGradient gradient)
 {
-	VoxelParams voxelParams;
-	voxelParams.Xres = Xres;
-	voxelParams.Yres = Yres;
-	voxelParams.Zres = Zres;
-
 	VolumeGradient volGrad = static_cast<VolumeGradient>(static_cast<int>(gradient) + 4);
 
+	outputValues.resize((size_t)Xres * Yres * Zres);
+
 	// - write data to output
-	for (size_t z_idx = 0; z_idx < Zres; ++z_idx)
+	ForEachSlice(Xres, Yres, Zres, [&](size_t z_idx)
+	{
+		VoxelParams voxelParams;
+		voxelParams.Xres = Xres;
+		voxelParams.Yres = Yres;
+		voxelParams.Zres = Zres;
+		voxelParams.z = (unsigned int) z_idx;
+
+		float* sliceValues = outputValues.data() + z_idx * Xres * Yres;
+
 		for (size_t y_idx = 0; y_idx < Yres; ++y_idx)
+		{
+			voxelParams.y = (unsigned int) y_idx;
+
 			for (size_t x_idx = 0; x_idx < Xres; ++x_idx)
 			{
 				voxelParams.x = (unsigned int) x_idx;
-				voxelParams.y = (unsigned int) y_idx;
-				voxelParams.z = (unsigned int) z_idx;
 
-				float dist2vx_normalized = GetDistParamNormalized(voxelParams, volGrad);
-				outputValues.push_back(dist2vx_normalized);
+				*sliceValues++ = GetDistParamNormalized(voxelParams, volGrad);
 			}
+		}
+	});
 }
 
 bool FireRenderFluidVolume::ReadDensityIntoArray(MFnFluid& fnFluid, std::vector<float>& outputValues)
@@ -952,12 +950,11 @@ bool FireRenderFluidVolume::ReadDensityIntoArray(MFnFluid& fnFluid, std::vector<
 	unsigned int Zres = 0;
 	mstatus = fnFluid.getResolution(Xres, Yres, Zres);
 	unsigned int gridSize = Xres*Yres*Zres;
-	outputValues.reserve(gridSize);
 
 	// empty grid
 	if (density_method == MFnFluid::kZero)
 	{
-		outputValues.resize(gridSize, 0.0f);
+		outputValues.assign(gridSize, 0.0f);
 		return true;
 	}
 
@@ -972,10 +969,7 @@ bool FireRenderFluidVolume::ReadDensityIntoArray(MFnFluid& fnFluid, std::vector<
 		}
 
 		// - convert data to rpr representation
-		for (size_t idx = 0; idx < gridSize; ++idx)
-		{
-			outputValues.push_back(density[idx]);
-		}
+		CopyFluidGrid(density, gridSize, outputValues);
 
 		return true;
 	}
@@ -1013,12 +1007,11 @@ bool FireRenderFluidVolume::ReadTemperatureIntoArray(MFnFluid& fnFluid, std::vec
 	unsigned int Zres = 0;
 	mstatus = fnFluid.getResolution(Xres, Yres, Zres);
 	unsigned int gridSize = Xres*Yres*Zres;
-	outputValues.reserve(gridSize);
 
 	// empty grid
 	if (temperature_method == MFnFluid::kZero)
 	{
-		outputValues.resize(gridSize, 0.0f);
+		outputValues.assign(gridSize, 0.0f);
 		return true;
 	}
 
@@ -1033,10 +1026,7 @@ bool FireRenderFluidVolume::ReadTemperatureIntoArray(MFnFluid& fnFluid, std::vec
 		}
 
 		// - convert data to rpr representation
-		for (size_t idx = 0; idx < gridSize; ++idx)
-		{
-			outputValues.push_back(temperature[idx]);
-		}
+		CopyFluidGrid(temperature, gridSize, outputValues);
 
 		return true;
 	}
@@ -1076,12 +1066,11 @@ bool FireRenderFluidVolume::ReadFuelIntoArray(MFnFluid& fnFluid, std::vector<flo
 	unsigned int Zres = 0;
 	mstatus = fnFluid.getResolution(Xres, Yres, Zres);
 	unsigned int gridSize = Xres*Yres*Zres;
-	outputValues.reserve(gridSize);
 
 	// empty grid
 	if (fuel_method == MFnFluid::kZero)
 	{
-		outputValues.resize(gridSize, 0.0f);
+		outputValues.assign(gridSize, 0.0f);
 		return true;
 	}
 
@@ -1096,10 +1085,7 @@ bool FireRenderFluidVolume::ReadFuelIntoArray(MFnFluid& fnFluid, std::vector<flo
 		}
 
 		// - convert data to rpr representation
-		for (size_t idx = 0; idx < gridSize; ++idx)
-		{
-			outputValues.push_back(fuel[idx]);
-		}
+		CopyFluidGrid(fuel, gridSize, outputValues);
 
 		return true;
 	}
@@ -1137,12 +1123,8 @@ bool FireRenderFluidVolume::ReadPressureIntoArray(MFnFluid& fnFluid, std::vector
 	unsigned int Zres = 0;
 	mstatus = fnFluid.getResolution(Xres, Yres, Zres);
 	unsigned int gridSize = Xres * Yres*Zres;
-	outputValues.reserve(gridSize);
 
-	for (size_t idx = 0; idx < gridSize; ++idx)
-	{
-		outputValues.push_back(pressure[idx]);
-	}
+	CopyFluidGrid(pressure, gridSize, outputValues);
 
 	return true;
 }
@@ -1162,18 +1144,17 @@ bool FireRenderFluidVolume::ReadSpeedIntoArray(MFnFluid& fnFluid, std::vector<fl
 		return false;
 	}
 
-	// NOTE: unlike all of the other inputs, velocity uses its own XYZ resolutions!
-	int Xres = 0;
-	int Yres = 0;
-	int Zres = 0;
-	mstatus = fnFluid.velocityGridSizes(Xres, Yres, Zres);
+	// speed is evaluated in the voxel centers, so output has the fluid resolution as other inputs
+	unsigned int Xres = 0;
+	unsigned int Yres = 0;
+	unsigned int Zres = 0;
+	mstatus = fnFluid.getResolution(Xres, Yres, Zres);
 	unsigned int gridSize = Xres*Yres*Zres;
-	outputValues.reserve(gridSize);
 
 	// empty grid
 	if (velocityMethod == MFnFluid::kZero)
 	{
-		outputValues.resize(gridSize, 0.0f);
+		outputValues.assign(gridSize, 0.0f);
 		return true;
 	}
 
@@ -1190,13 +1171,46 @@ bool FireRenderFluidVolume::ReadSpeedIntoArray(MFnFluid& fnFluid, std::vector<fl
 			return false;
 		}
 
+		// NOTE: unlike all of the other inputs, velocity is stored on the voxel faces,
+		// each component has one more value along its own axis
+		int xSize = 0;
+		int ySize = 0;
+		int zSize = 0;
+		mstatus = fnFluid.velocityGridSizes(xSize, ySize, zSize);
+		if ((MStatus::kSuccess != mstatus) ||
+			(xSize != (int)((Xres + 1) * Yres * Zres)) ||
+			(ySize != (int)(Xres * (Yres + 1) * Zres)) ||
+			(zSize != (int)(Xres * Yres * (Zres + 1))))
+		{
+			error.set("MFnFluid:", "unexpected velocity grid size", false, false);
+			return false;
+		}
+
+		outputValues.resize(gridSize);
+
 		// - convert data to rpr representation
-		for (size_t z_idx = 0; z_idx < Zres; ++z_idx)
+		ForEachSlice(Xres, Yres, Zres, [&](size_t z_idx)
+		{
+			float* sliceValues = outputValues.data() + z_idx * Xres * Yres;
+
 			for (size_t y_idx = 0; y_idx < Yres; ++y_idx)
+			{
+				const float* xRow = xSpeed + (z_idx * Yres + y_idx) * (Xres + 1);
+				const float* yRow = ySpeed + (z_idx * (Yres + 1) + y_idx) * Xres;
+				const float* zRow = zSpeed + (z_idx * Yres + y_idx) * Xres;
+				const size_t yNext = Xres;
+				const size_t zNext = (size_t)Xres * Yres;
+
 				for (size_t x_idx = 0; x_idx < Xres; ++x_idx)
 				{
-					outputValues.push_back(sqrt(xSpeed[x_idx]*xSpeed[x_idx] + ySpeed[y_idx]*ySpeed[y_idx] + zSpeed[z_idx]*zSpeed[z_idx]));
+					float vx = 0.5f * (xRow[x_idx] + xRow[x_idx + 1]);
+					float vy = 0.5f * (yRow[x_idx] + yRow[x_idx + yNext]);
+					float vz = 0.5f * (zRow[x_idx] + zRow[x_idx + zNext]);
+
+					*sliceValues++ = sqrt(vx * vx + vy * vy + vz * vz);
 				}
+			}
+		});
 
 		return true;
 	}
@@ -1222,13 +1236,19 @@ bool FireRenderFluidVolume::ProcessInputField(int inputField,
 	MFnFluid& fnFluid)
 {
 	outData.clear();
-	outData.reserve(fnFluid.gridSize());
+
+	Tracing::Zone zone("Read fluid input");
+	if (zone.IsActive())
+	{
+		const int fieldCount = (int)(sizeof(FluidInputFieldNames) / sizeof(FluidInputFieldNames[0]));
+		zone.SetDetail((inputField >= 0 && inputField < fieldCount) ? FluidInputFieldNames[inputField] : "Unknown");
+	}
 
 	switch (inputField)
 	{
 		case 0 /*Constant*/:
 		{
-			outData.resize(Xres*Yres*Zres, 1.0f);
+			outData.assign((size_t)Xres*Yres*Zres, 1.0f);
 			break;
 		}
 
@@ -1482,7 +1502,7 @@ bool FireRenderFluidVolume::TranslateDensity(VolumeData* pVolumeData, MFnFluid&
 	// - apply noise to voxel values
 	if (isNoiseForDensityEnabled)
 	{
-		bool success = ApplyNoise(pVolumeData->densityVal);
+		bool success = ApplyNoise(pVolumeData->densityVal, pVolumeData, shaderNode, "opacityTexGain");
 		if (!success)
 			return false;
 	}
@@ -1559,7 +1579,7 @@ bool FireRenderFluidVolume::TranslateAlbedo(VolumeData* pVolumeData, MFnFluid& f
 	// - apply noise to voxel values
 	if (isNoiseForAlbedoEnabled)
 	{
-		bool success = ApplyNoise(pVolumeData->albedoVal);
+		bool success = ApplyNoise(pVolumeData->albedoVal, pVolumeData, shaderNode, "colorTexGain");
 		if (!success)
 			return false;
 	}
@@ -1636,7 +1656,7 @@ bool FireRenderFluidVolume::TranslateEmission(VolumeData* pVolumeData, MFnFluid&
 	// - apply noise to voxel values
 	if (isNoiseForEmissionEnabled)
 	{
-		bool success = ApplyNoise(pVolumeData->albedoVal);
+		bool success = ApplyNoise(pVolumeData->emissionVal, pVolumeData, shaderNode, "incandTexGain");
 		if (!success)
 			return false;
 	}
@@ -1645,8 +1665,18 @@ bool FireRenderFluidVolume::TranslateEmission(VolumeData* pVolumeData, MFnFluid&
 	return true;
 }
 
-bool FireRenderFluidVolume::ApplyNoise(std::vector<float>& channelValues)
+bool FireRenderFluidVolume::ApplyNoise(std::vector<float>& channelValues, const VolumeData* pVolumeData, const MFnDependencyNode& shaderNode, const char* gainPlugName)
 {
+	FluidNoiseParams noiseParams;
+	if (!noiseParams.ReadFromFluid(shaderNode, gainPlugName))
+	{
+		FireRenderError error;
+		error.set("MFnFluid:", "failed to get texture noise parameters", false, false);
+		return false;
+	}
+
+	ApplyFluidNoise(channelValues, pVolumeData->gridSizeX, pVolumeData->gridSizeY, pVolumeData->gridSizeZ, noiseParams);
+
 	return true;
 }
 
@@ -133,6 +133,26 @@ MStatus	GLTFTranslator::writer(const MFileObject& file,
 
 	try
 	{
+		OptionMap optionMap;
+		ParseOptionStringValues(optionMap, optionsString);
+
+		auto getFloatOption = [&optionMap](const char* name)
+		{
+			OptionMap::const_iterator it = optionMap.find(name);
+			return it != optionMap.end() ? MString(it->second.c_str()).asFloat() : 0.0f;
+		};
+
+		animationExporter.SetKeyReductionTolerances(
+			getFloatOption("AnimTranslationTolerance"),
+			getFloatOption("AnimRotationTolerance"),
+			getFloatOption("AnimScaleTolerance"));
+
+		OptionMap::const_iterator it = optionMap.find("AnimResampleStep");
+		if (it != optionMap.end())
+		{
+			animationExporter.SetResampleStep(MString(it->second.c_str()).asDouble());
+		}
+
 		m_progressBars->SetTextAboveProgress("Preparing Animation...", true);
 
 		animationExporter.Export(*fireRenderContext, &renderableCameras, rprsContext);
@@ -140,12 +160,9 @@ MStatus	GLTFTranslator::writer(const MFileObject& file,
 		std::vector<rpr_scene> scenes;
 		scenes.push_back(scene.Handle());
 
-		OptionMap optionMap;
-		ParseOptionStringValues(optionMap, optionsString);
-
 		unsigned int gltfFlags = RPRGLTF_EXPORTFLAG_COPY_IMAGES_USING_OBJECTNAME | RPRGLTF_EXPORTFLAG_KHR_LIGHT;
 
-		OptionMap::const_iterator it = optionMap.find("BuildPbrImages");
+		it = optionMap.find("BuildPbrImages");
 		if (it != optionMap.end())
 		{
 			if (MString(it->second.c_str()).asInt() > 0)
@@ -0,0 +1,202 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <vector>
+
+// Builds RPR curve arrays (indices, segment counts and radiuses) of hair strands.
+// Doesn't depend on Maya or RPR so that it can be benchmarked on synthetic grooms.
+
+/* from RadeonProRender.h :
+	*  A rpr_curve is a set of curves
+	*  A curve is a set of segments
+	*  A segment is always composed of 4 3D points
+*/
+const unsigned int PointsPerSegment = 4;
+
+// Strands with at least this number of segments are written in parallel
+const size_t ParallelThresholdSegments = 64 * 1024;
+
+// Neighbour segments of a strand share the end point, so every segment after the first one adds
+// (PointsPerSegment - 1) new points. Single point strand still produces one segment.
+inline unsigned int GetHairSegmentCount(unsigned int length)
+{
+	if (length == 0)
+		return 0;
+
+	return std::max(1u, (length - 1 + PointsPerSegment - 2) / (PointsPerSegment - 1));
+}
+
+// Writes indices and radiuses of one strand into preallocated arrays.
+// Last segment is padded with the index of the last point of the strand.
+// In RPR we set 2 widths per segment: bottom and top circle
+template <typename T>
+void WriteHairSegments(
+	unsigned int* outIndices,
+	float* outRadiuses,
+	const T* width,
+	unsigned int offset,
+	unsigned int length,
+	unsigned int segmentCount)
+{
+	// ensure correct inputs
+	assert(width != nullptr);
+
+	for (unsigned int segmentIdx = 0; segmentIdx < segmentCount; ++segmentIdx)
+	{
+		unsigned int* segmentIndices = outIndices + segmentIdx * PointsPerSegment;
+
+		for (unsigned int pointIdx = 0; pointIdx < PointsPerSegment; ++pointIdx)
+		{
+			unsigned int strandPointIdx = std::min(segmentIdx * (PointsPerSegment - 1) + pointIdx, length - 1);
+			segmentIndices[pointIdx] = offset + strandPointIdx;
+		}
+
+		outRadiuses[segmentIdx * 2] = (float)width[segmentIndices[0]] * 0.5f;
+		outRadiuses[segmentIdx * 2 + 1] = (float)width[segmentIndices[PointsPerSegment - 1]] * 0.5f;
+	}
+}
+
+// Source data of the strands of a hair system, strands are ranges of the points array
+struct HairStrandsSource
+{
+	const float* points; // 3 floats per point
+	const float* width; // width of each point
+	const float* uvCoord;
+
+	std::vector<unsigned int> offsets; // first point of each strand
+	std::vector<unsigned int> lengths; // point count of each strand
+	std::vector<size_t> uvOffsets; // first texcoord of each strand, has one more element than strands
+
+	HairStrandsSource(void)
+		: points(nullptr)
+		, width(nullptr)
+		, uvCoord(nullptr)
+	{}
+
+	size_t StrandCount(void) const { return lengths.size(); }
+
+	// Range of points used by strands [firstStrand, endStrand)
+	void GetPointRange(size_t firstStrand, size_t endStrand, unsigned int& firstPoint, unsigned int& endPoint) const
+	{
+		firstPoint = UINT_MAX;
+		endPoint = 0;
+
+		for (size_t strandIdx = firstStrand; strandIdx < endStrand; ++strandIdx)
+		{
+			if (lengths[strandIdx] == 0)
+				continue;
+
+			firstPoint = std::min(firstPoint, offsets[strandIdx]);
+			endPoint = std::max(endPoint, offsets[strandIdx] + lengths[strandIdx]);
+		}
+
+		if (endPoint == 0)
+			firstPoint = 0;
+	}
+};
+
+// Hair systems are split into chunks of this number of strands, each chunk is a separate RPR curve
+const size_t StrandsPerChunk = 64 * 1024;
+
+struct CurvesBatchData
+{
+	std::vector<unsigned int> m_indicesData;
+	std::vector<int> m_numPointsPerSegment;
+	std::vector<float> m_radiuses; // width
+	std::vector<float> m_uvCoord;
+	unsigned int m_pointCount;
+	const float* m_points;
+
+	CurvesBatchData(void)
+		: m_indicesData()
+		, m_numPointsPerSegment()
+		, m_radiuses() // In RPR we set 2 widths per segment (segment is 4 points)
+		, m_uvCoord() // RPR accepts only one UV pair per curve
+		, m_pointCount(0) // splineIt.vertexCount() returns wrong number - it returns number of vertexes used, not size of vertex array, which is different number when density mask is used
+		, m_points(nullptr)
+	{}
+
+	// Batch of strands [firstStrand, endStrand). Only points used by these strands are passed to RPR
+	void Init(const HairStrandsSource& source, size_t firstStrand, size_t endStrand)
+	{
+		unsigned int firstPoint = 0;
+		unsigned int endPoint = 0;
+		source.GetPointRange(firstStrand, endStrand, firstPoint, endPoint);
+
+		m_points = source.points + (size_t)firstPoint * 3;
+		m_pointCount = endPoint - firstPoint;
+
+		// strand offsets relative to the first point of the batch
+		std::vector<unsigned int> offsets(source.offsets.begin() + firstStrand, source.offsets.begin() + endStrand);
+		std::vector<unsigned int> lengths(source.lengths.begin() + firstStrand, source.lengths.begin() + endStrand);
+
+		for (size_t strandIdx = 0; strandIdx < offsets.size(); ++strandIdx)
+		{
+			offsets[strandIdx] = (lengths[strandIdx] > 0) ? offsets[strandIdx] - firstPoint : 0;
+		}
+
+		// Write indices and hair segments radiuses
+		BuildSegments(offsets, lengths, source.width + firstPoint);
+
+		if (source.uvCoord != nullptr)
+		{
+			m_uvCoord.assign(source.uvCoord + source.uvOffsets[firstStrand], source.uvCoord + source.uvOffsets[endStrand]);
+		}
+	}
+
+	// Fills indices, segment counts and radiuses of all strands.
+	// First pass computes exact array sizes, second pass writes strands in parallel.
+	template <typename T>
+	void BuildSegments(const std::vector<unsigned int>& strandOffsets, const std::vector<unsigned int>& strandLengths, const T* width)
+	{
+		assert(strandOffsets.size() == strandLengths.size());
+
+		const int strandCount = (int)strandLengths.size();
+
+		m_numPointsPerSegment.resize(strandCount);
+		std::vector<size_t> firstSegments(strandCount);
+
+		size_t segmentCount = 0;
+		for (int strandIdx = 0; strandIdx < strandCount; ++strandIdx)
+		{
+			unsigned int segmentsInCurve = GetHairSegmentCount(strandLengths[strandIdx]);
+
+			firstSegments[strandIdx] = segmentCount;
+			m_numPointsPerSegment[strandIdx] = segmentsInCurve;
+			segmentCount += segmentsInCurve;
+		}
+
+		m_indicesData.resize(segmentCount * PointsPerSegment);
+		m_radiuses.resize(segmentCount * 2);
+
+		bool parallel = segmentCount >= ParallelThresholdSegments;
+
+#pragma omp parallel for if(parallel)
+		for (int strandIdx = 0; strandIdx < strandCount; ++strandIdx)
+		{
+			size_t firstSegment = firstSegments[strandIdx];
+
+			WriteHairSegments(
+				m_indicesData.data() + firstSegment * PointsPerSegment,
+				m_radiuses.data() + firstSegment * 2,
+				width,
+				strandOffsets[strandIdx],
+				strandLengths[strandIdx],
+				m_numPointsPerSegment[strandIdx]);
+		}
+	}
+};
@@ -0,0 +1,441 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "HosekSkyGen.h"
+
+#include "Hosek/ArHosekSkyModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace
+{
+	// Hosek RGB radiance to SkyGen units, gives the same zenith brightness for the default sky (turbidity 0.1, altitude 45)
+	const double HosekSkyScale = 1150.0;
+
+	// The model is fitted for this turbidity range
+	const double MinTurbidity = 1.0;
+	const double MaxTurbidity = 10.0;
+
+	// Sun angle table resolution, it is indexed by sin(gamma / 2), which is denser close to the sun
+	const int GammaTableSize = 2048;
+
+	// Upper hemisphere sampling for the ground irradiance
+	const int IrradianceThetaSamples = 16;
+	const int IrradiancePhiSamples = 32;
+
+	struct CookedModel
+	{
+		double turbidity = -1.0;
+		std::array<double, 3> albedo = { -1.0, -1.0, -1.0 };
+		double elevation = -1.0;
+
+		std::array<std::array<double, 9>, 3> configs;
+		std::array<double, 3> radiances;
+	};
+
+	// Coefficients only depend on turbidity, ground albedo and sun elevation.
+	// The last cooked set is kept, so regenerating the sky for other attribute changes doesn't cook them again
+	void CookModel(double turbidity, const std::array<double, 3>& albedo, double elevation, std::array<std::array<double, 9>, 3>& configs, std::array<double, 3>& radiances)
+	{
+		static std::mutex cacheLock;
+		static CookedModel cache;
+
+		std::lock_guard<std::mutex> lock(cacheLock);
+
+		if (cache.turbidity != turbidity || cache.albedo != albedo || cache.elevation != elevation)
+		{
+			// Ground albedo is a single value in the model, so the state is cooked per channel
+			for (int channel = 0; channel < 3; channel++)
+			{
+				ArHosekSkyModelState* state = arhosek_rgb_skymodelstate_alloc_init(turbidity, albedo[channel], elevation);
+
+				std::copy(state->configs[channel], state->configs[channel] + 9, cache.configs[channel].begin());
+				cache.radiances[channel] = state->radiances[channel];
+
+				arhosekskymodelstate_free(state);
+			}
+
+			cache.turbidity = turbidity;
+			cache.albedo = albedo;
+			cache.elevation = elevation;
+		}
+
+		configs = cache.configs;
+		radiances = cache.radiances;
+	}
+
+	// Zenith angle part of the model
+	inline double ZenithTerm(const std::array<double, 9>& config, double cosTheta)
+	{
+		return 1.0 + config[0] * exp(config[1] / (cosTheta + 0.01));
+	}
+
+	// Sun angle part of the model without the zenith brightening (config[7] * sqrt(cos(theta)))
+	inline double GammaTerm(const std::array<double, 9>& config, double cosGamma, double gamma)
+	{
+		const double expM = exp(config[4] * gamma);
+		const double rayM = cosGamma * cosGamma;
+		const double mieM = (1.0 + rayM) / pow(1.0 + config[8] * config[8] - 2.0 * config[8] * cosGamma, 1.5);
+
+		return config[2] + config[3] * expM + config[5] * rayM + config[6] * mieM;
+	}
+
+	inline double Clamp(double value, double minValue, double maxValue)
+	{
+		return std::min(std::max(value, minValue), maxValue);
+	}
+}
+
+void HosekSkyGen::prepare()
+{
+	if (m_prepared)
+		return;
+
+	m_prepared = true;
+
+	adjust_sun_glow();
+
+	Scalar horiz_height = horizon_height / 10.0;
+
+	m_sunDir = sun_direction.Normalize();
+	vectortweak(m_sunDir, y_is_up, horiz_height);
+	m_sunFade = (m_sunDir.z < 0.0) ? std::max(0.0, 1.0 + m_sunDir.z) : 1.0;
+
+	Scalar local_haze = std::max(2.0 + haze, 2.0);
+
+	m_saturation = saturation;
+	tweak_saturation(m_saturation, local_haze);
+
+	m_rgbScale = rgb_unit_conversion;
+	if (m_rgbScale.r < 0.0)
+	{
+		m_rgbScale.r = m_rgbScale.g = m_rgbScale.b = 1.0 / 80000.0;
+	}
+	m_rgbScale *= multiplier;
+
+	m_sunColor = calc_sun_color(m_sunDir, local_haze);
+
+	// The model is defined for the sun above the horizon, lower sun fades the sky out
+	double elevation = asin(Clamp(m_sunDir.z, 0.0, 1.0));
+	double turbidity = Clamp(local_haze, MinTurbidity, MaxTurbidity);
+	std::array<double, 3> albedo = { Clamp(ground_color.r, 0.0, 1.0), Clamp(ground_color.g, 0.0, 1.0), Clamp(ground_color.b, 0.0, 1.0) };
+
+	CookModel(turbidity, albedo, elevation, m_configs, m_radiances);
+
+	for (int channel = 0; channel < 3; channel++)
+	{
+		std::vector<float>& table = m_gammaTable[channel];
+		table.resize(GammaTableSize + 1);
+
+		for (int idx = 0; idx <= GammaTableSize; idx++)
+		{
+			double halfSin = double(idx) / GammaTableSize;
+			double gamma = 2.0 * asin(halfSin);
+			double cosGamma = 1.0 - 2.0 * halfSin * halfSin;
+
+			table[idx] = float(GammaTerm(m_configs[channel], cosGamma, gamma));
+		}
+	}
+
+	// Ground is lit by the cosine weighted sky (midpoint rule over the upper hemisphere) and the sun
+	SkyColor irradiance;
+	for (int i = 0; i < IrradianceThetaSamples; i++)
+	{
+		double theta = (i + 0.5) * (PI * 0.5) / IrradianceThetaSamples;
+		double weight = cos(theta) * sin(theta) * (PI * 0.5 / IrradianceThetaSamples) * (2.0 * PI / IrradiancePhiSamples);
+
+		for (int j = 0; j < IrradiancePhiSamples; j++)
+		{
+			double phi = (j + 0.5) * 2.0 * PI / IrradiancePhiSamples;
+			Point3 dir(float(sin(theta) * cos(phi)), float(sin(theta) * sin(phi)), float(cos(theta)));
+
+			irradiance += skyRadiance(dir) * weight;
+		}
+	}
+
+	m_groundColor = ground_color;
+	m_groundColor *= irradiance / PI + m_sunColor * std::max(0.0, Scalar(m_sunDir.z)) * GLOBAL_SCALE;
+}
+
+SkyColor HosekSkyGen::skyRadiance(const Point3& dir) const
+{
+	double cosTheta = Clamp(dir.z, 0.0, 1.0);
+	double cosGamma = Clamp(DotProd(dir, m_sunDir), -1.0, 1.0);
+	double gamma = acos(cosGamma);
+
+	SkyColor radiance;
+	double* channels[3] = { &radiance.r, &radiance.g, &radiance.b };
+
+	for (int channel = 0; channel < 3; channel++)
+	{
+		const Configuration& config = m_configs[channel];
+
+		*channels[channel] = ZenithTerm(config, cosTheta) * (GammaTerm(config, cosGamma, gamma) + config[7] * sqrt(cosTheta)) * m_radiances[channel];
+	}
+
+	return radiance * (HosekSkyScale * m_sunFade);
+}
+
+SkyColor HosekSkyGen::shade(const Point3& direction, Scalar downness)
+{
+	// only calc for above-the-horizon
+	Point3 dir = direction;
+	if (dir.z < 0.001)
+	{
+		dir.z = 0.001f;
+		dir = dir.Normalize();
+	}
+
+	SkyColor out_color;
+
+	if (downness <= 0.0)
+	{
+		// Lower hemisphere
+		Scalar hor_blur = horizon_blur / 10.0;
+		Scalar night_factor = 1.0;
+		if (hor_blur > 0.0)
+		{
+			Scalar dness = smoothstep(0.0, 1.0, -downness / hor_blur);
+			if (dness < 1.0)
+			{
+				out_color = skyRadiance(dir) * (1.0 - dness) + m_groundColor * dness;
+			}
+			else
+			{
+				out_color = m_groundColor;
+			}
+			night_factor = 1.0 - dness;
+		}
+		else
+		{
+			out_color = m_groundColor;
+			night_factor = 0.0;
+		}
+
+		if (night_factor > 0.0)
+		{
+			SkyColor night = night_color;
+			night *= night_factor;
+			if (out_color.r < night.r) out_color.r = night.r;
+			if (out_color.g < night.g) out_color.g = night.g;
+			if (out_color.b < night.b) out_color.b = night.b;
+		}
+	}
+	else
+	{
+		// Upper hemisphere
+		out_color = skyRadiance(dir) + m_sunColor * sun_disk_factor(dir, m_sunDir);
+	}
+
+	out_color *= m_rgbScale;
+	colortweak(out_color, m_saturation, filter_color);
+	out_color.sanitize();
+
+	return out_color;
+}
+
+SkyColor HosekSkyGen::computeColor(const Point3& direction)
+{
+	prepare();
+
+	if (multiplier <= 0.0 || !on)
+	{
+		return SkyColor(0.0, 0.0, 0.0);
+	}
+
+	Point3 dir = direction;
+	vectortweak(dir, y_is_up, horizon_height / 10.0);
+
+	return shade(dir, dir.z);
+}
+
+void HosekSkyGen::generateRowPerPixel(int w, int w2, float phi, SkyRgbFloat32* row)
+{
+	float nw = 1.0f / float(w);
+	float sinphi = sin(phi);
+
+	for (int j = 0; j < w2; j++)
+	{
+		float theta = float(2.0f * PI * j * nw);
+		Point3 dir(cos(theta) * sinphi, sin(theta) * sinphi, -cos(phi));
+
+		SkyColor pix = computeColor(dir);
+
+		row[j].r = static_cast<float>(pix.r);
+		row[j].g = static_cast<float>(pix.g);
+		row[j].b = static_cast<float>(pix.b);
+	}
+}
+
+void HosekSkyGen::generateSkyRow(int w2, float phi, std::vector<float>& cosGamma, SkyRgbFloat32* row)
+{
+	const int w = int(cosGamma.size());
+	const float nw = 1.0f / float(w);
+
+	// Horizon height shifts and renormalizes all directions of the row the same way
+	float sinphi = sin(phi);
+	float z = float(-cos(phi) - horizon_height / 10.0);
+	float length = sqrt(sinphi * sinphi + z * z);
+
+	// Directions just above the horizon are clamped as in SkyGen
+	float xyScale = sinphi / length;
+	z /= length;
+	if (z < 0.001f)
+	{
+		z = 0.001f;
+		xyScale = sqrt(1.0f - z * z);
+	}
+
+	const float sunX = m_sunDir.x * xyScale;
+	const float sunY = m_sunDir.y * xyScale;
+	const float sunZ = m_sunDir.z * z;
+	const float step = float(2.0f * PI * nw);
+
+	for (int j = 0; j < w2; j++)
+	{
+		float theta = step * j;
+		cosGamma[j] = std::min(1.0f, std::max(-1.0f, float(cos(theta) * sunX + sin(theta) * sunY + sunZ)));
+	}
+
+	double cosTheta = z;
+	std::array<float, 3> zenith;
+	std::array<float, 3> zenithBrightening;
+	for (int channel = 0; channel < 3; channel++)
+	{
+		zenith[channel] = float(ZenithTerm(m_configs[channel], cosTheta) * m_radiances[channel] * HosekSkyScale * m_sunFade);
+		zenithBrightening[channel] = float(m_configs[channel][7] * sqrt(cosTheta));
+	}
+
+	const float* tableR = m_gammaTable[0].data();
+	const float* tableG = m_gammaTable[1].data();
+	const float* tableB = m_gammaTable[2].data();
+
+	for (int j = 0; j < w2; j++)
+	{
+		// table lookup with linear interpolation
+		float position = sqrt(std::max(0.0f, 0.5f * (1.0f - cosGamma[j]))) * GammaTableSize;
+		int idx = std::min(int(position), GammaTableSize - 1);
+		float t = position - idx;
+
+		row[j].r = zenith[0] * (tableR[idx] + t * (tableR[idx + 1] - tableR[idx]) + zenithBrightening[0]);
+		row[j].g = zenith[1] * (tableG[idx] + t * (tableG[idx + 1] - tableG[idx]) + zenithBrightening[1]);
+		row[j].b = zenith[2] * (tableB[idx] + t * (tableB[idx + 1] - tableB[idx]) + zenithBrightening[2]);
+	}
+}
+
+void HosekSkyGen::generateGroundRow(int w, int w2, float phi, SkyRgbFloat32* row)
+{
+	float nw = 1.0f / float(w);
+	float sinphi = sin(phi);
+
+	for (int j = 0; j < w2; j++)
+	{
+		float theta = float(2.0f * PI * j * nw);
+		Point3 dir(cos(theta) * sinphi, sin(theta) * sinphi, -cos(phi));
+		vectortweak(dir, false, horizon_height / 10.0);
+		if (dir.z < 0.001)
+		{
+			dir.z = 0.001f;
+			dir = dir.Normalize();
+		}
+
+		SkyColor color = skyRadiance(dir);
+
+		row[j].r = static_cast<float>(color.r);
+		row[j].g = static_cast<float>(color.g);
+		row[j].b = static_cast<float>(color.b);
+	}
+}
+
+void HosekSkyGen::generateAtmosphere(int w, int h, int firstRow, int lastRow, SkyRgbFloat32* buffer)
+{
+	prepare();
+
+	float nh = 1.0f / float(h);
+
+	bool canMirrorSky = (fabs(m_sunDir.y) < 0.00001f);
+	int w2 = canMirrorSky ? (w + 1) / 2 : w; // divide by 2 with rounding up
+
+#pragma omp parallel
+	{
+		std::vector<float> cosGamma(w);
+
+#pragma omp for
+		for (int row = firstRow; row < lastRow; row++)
+		{
+			float phi = float(PI * (h - row - 1) * nh);
+			SkyRgbFloat32* pixels = buffer + size_t(row) * w;
+
+			if (row_downness(row, h) > 0.0)
+			{
+				generateSkyRow(w2, phi, cosGamma, pixels);
+			}
+			else
+			{
+				generateGroundRow(w, w2, phi, pixels);
+			}
+
+			if (canMirrorSky)
+			{
+				for (int j = 0; j < w2; j++)
+				{
+					pixels[w - j - 1] = pixels[j];
+				}
+			}
+		}
+	}
+}
+
+SkyColor HosekSkyGen::computeGroundColor()
+{
+	prepare();
+
+	return m_groundColor;
+}
+
+void HosekSkyGen::generate(int w, int h, SkyRgbFloat32* buffer)
+{
+	prepare();
+
+	if (multiplier <= 0.0 || !on)
+	{
+		std::fill(buffer, buffer + size_t(w) * h, SkyRgbFloat32());
+		return;
+	}
+
+	// Layers need z up axis
+	if (y_is_up)
+	{
+		float nh = 1.0f / float(h);
+
+#pragma omp parallel for
+		for (int i = 0; i < h; i++)
+		{
+			generateRowPerPixel(w, w, float(PI * i * nh), buffer + size_t(h - i - 1) * w);
+		}
+
+		return;
+	}
+
+	std::vector<float> blend;
+	generateHorizonBlend(h, blend);
+
+	std::vector<SkyRgbFloat32> atmosphere(size_t(w) * h);
+	generateAtmosphere(w, h, 0, atmosphereRowCount(blend), atmosphere.data());
+
+	std::vector<SkySunPixel> sunPixels;
+	generateSunDisk(w, h, sunPixels);
+
+	compose(w, h, atmosphere.data(), sunPixels, computeGroundColor(), blend, buffer);
+}
@@ -0,0 +1,86 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include "SkyGen.h"
+
+#include <array>
+#include <vector>
+
+/**
+ * Sky generator based on the Hosek-Wilkie analytic sky model (RGB datasets).
+ * Parameters, horizon, ground, sun disk and color adjustments are the same as in SkyGen,
+ * only the sky radiance model differs.
+ *
+ * Model coefficients are cooked once per turbidity, ground albedo and sun elevation.
+ * Lat-long rows have a constant zenith angle, so the zenith terms are evaluated once per row,
+ * and the sun angle terms are taken from a lookup table, so the per pixel work is a dot product
+ * and a table fetch in plain loops over the row.
+ */
+class HosekSkyGen : public SkyGen
+{
+public:
+	/** Color of the sky and the sun in the direction. */
+	SkyColor computeColor(const Point3& direction);
+
+	/** Fill w x h lat-long image. */
+	void generate(int w, int h, SkyRgbFloat32* buffer);
+
+	/** Atmosphere layer (see SkyGen) evaluated with the Hosek model. */
+	void generateAtmosphere(int w, int h, int firstRow, int lastRow, SkyRgbFloat32* buffer);
+
+	/** Ground lit by the Hosek sky and the sun. */
+	SkyColor computeGroundColor();
+
+private:
+	typedef std::array<double, 9> Configuration;
+
+	/** Cook the model coefficients and the tables for the current parameters. */
+	void prepare();
+
+	/** Exact sky radiance (without the sun disk) for the direction above the horizon. */
+	SkyColor skyRadiance(const Point3& dir) const;
+
+	/** Sky and ground color for a direction which is already adjusted for the horizon height. */
+	SkyColor shade(const Point3& dir, Scalar downness);
+
+	/** Rows with y up axis, evaluated per pixel. */
+	void generateRowPerPixel(int w, int w2, float phi, SkyRgbFloat32* row);
+
+	/** Sky radiance of the row below the horizon, directions are clamped to the horizon. */
+	void generateGroundRow(int w, int w2, float phi, SkyRgbFloat32* row);
+
+	/** Sky radiance of the row of the upper hemisphere. */
+	void generateSkyRow(int w2, float phi, std::vector<float>& cosGamma, SkyRgbFloat32* row);
+
+private:
+	bool m_prepared = false;
+
+	/** Normalized sun direction adjusted for horizon height. */
+	Point3 m_sunDir;
+
+	/** Sky fades out when the sun goes below the horizon. */
+	Scalar m_sunFade = 1.0;
+
+	SkyColor m_sunColor;
+	SkyColor m_groundColor;
+	SkyColor m_rgbScale;
+	Scalar m_saturation = 1.0;
+
+	/** Hosek model coefficients A..I and radiance scale per RGB channel. */
+	std::array<Configuration, 3> m_configs;
+	std::array<double, 3> m_radiances;
+
+	/** Sun angle terms of the model per channel, indexed by sin(gamma / 2). */
+	std::array<std::vector<float>, 3> m_gammaTable;
+};
@@ -0,0 +1,45 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "JsonUtils.h"
+
+#include <cstdio>
+
+void WriteJsonString(std::ostream& out, const std::string& str)
+{
+	out << '"';
+
+	for (char c : str)
+	{
+		switch (c)
+		{
+		case '"': out << "\\\""; break;
+		case '\\': out << "\\\\"; break;
+		case '\n': out << "\\n"; break;
+		case '\r': out << "\\r"; break;
+		case '\t': out << "\\t"; break;
+		default:
+			if ((unsigned char)c < 0x20)
+			{
+				char code[8];
+				snprintf(code, sizeof(code), "\\u%04x", c);
+				out << code;
+			}
+			else
+			{
+				out << c;
+			}
+		}
+	}
+
+	out << '"';
+}
@@ -14,8 +14,6 @@ limitations under the License.
 #include "IESLightLocatorMesh.h"
 
 #include <cassert>
-#include <fstream>
-#include <sstream>
 
 #include <maya/MFloatMatrix.h>
 #include <maya/MEulerRotation.h>
@@ -23,8 +21,7 @@ limitations under the License.
 #include "base_mesh.h"
 #include "FireRenderError.h"
 #include "FireRenderUtils.h"
-#include "IESLight/IESprocessor.h"
-#include "IESLight/IESLightRepresentationCalc.h"
+#include "IESProfileCache.h"
 #if defined(OSMac_)
 #include "Translators.h"
 #else
@@ -33,139 +30,12 @@ limitations under the License.
 
 namespace
 {
-	// TODO: these parameters are hardcoded for now. Fix it!
-	const float IES_SCALE_MUL = 0.05f;
-
 	template<typename T, size_t N>
 	constexpr size_t StackArraySize(const T(&arr)[N])
 	{
 		return N;
 	}
 
-	const char* DescribeIESError(IESLightRepresentationErrorCode code)
-	{
-		switch (code)
-		{
-			case IESLightRepresentationErrorCode::INVALID_DATA:
-				return "Invalid ies data";
-
-			case IESLightRepresentationErrorCode::NO_EDGES:
-				return "Could not build nay edges to show ies light";
-		}
-
-		// Wrong use of this function
-		assert(false);
-		return nullptr;
-	}
-
-	const char* DescribeIESError(IESProcessor::ErrorCode code)
-	{
-		switch (code)
-		{
-			case IESProcessor::ErrorCode::NO_FILE:
-				return "Given file is empty";
-
-			case IESProcessor::ErrorCode::NOT_IES_FILE:
-				return "Wrong file (not *ies)";
-
-			case IESProcessor::ErrorCode::FAILED_TO_READ_FILE:
-				return "Failed to open the file";
-
-			case IESProcessor::ErrorCode::INVALID_DATA_IN_IES_FILE:
-				return "Invalid data in ies file";
-
-			case IESProcessor::ErrorCode::PARSE_FAILED:
-				return "ies file parsing failed";
-
-			case IESProcessor::ErrorCode::UNEXPECTED_END_OF_FILE:
-				return "Unexpected end of ies file";
-
-			case IESProcessor::ErrorCode::NOT_SUPPORTED:
-				return "Not supported format of ies file";
-		}
-
-		// Wrong use of this function
-		assert(false);
-		return nullptr;
-	}
-
-	bool GenerateIESRepresentation(
-		const wchar_t* filename,
-		size_t pointsPerPolyline,
-		float scale,
-		std::vector<MFloatVector>& vertices,
-		std::vector<unsigned int>& indices)
-	{
-		vertices.clear();
-		indices.clear();
-
-		FireRenderError error;
-		IESProcessor processor;
-		IESLightRepresentationParams params;
-		std::vector<std::vector<RadeonProRender::float3>> polylines;
-		params.maxPointsPerPLine = pointsPerPolyline;
-		params.webScale = scale;
-
-		auto parseError = processor.Parse(params.data, filename);
-
-		if (parseError != IESProcessor::ErrorCode::SUCCESS)
-		{
-			std::stringstream errorMessage;
-			const char* errorDescription = DescribeIESError(parseError);
-			errorMessage << "RPR Error: Failed to parse ies file";
-
-			if (errorDescription != nullptr)
-			{
-				errorMessage << " (reason: " << errorDescription << ") ";
-			}
-
-			error.set("Parse error", errorMessage.str().c_str(), false, false);
-		}
-
-		if (!error.check())
-		{
-			auto calcError = CalculateIESLightRepresentation(polylines, params);
-
-			if (calcError != IESLightRepresentationErrorCode::SUCCESS)
-			{
-				std::stringstream errorMessage;
-				const char* errorDescription = DescribeIESError(calcError);
-				errorMessage << "RPR Warning: ies file parsed successfully but failed to build it's representation";
-
-				if (errorDescription != nullptr)
-				{
-					errorMessage << " (reason: " << errorDescription << ") ";
-				}
-
-				error.set("Show ies form failed", errorMessage.str().c_str());
-			}
-		}
-
-		if (error.check())
-		{
-			// report failure
-			return false;
-		}
-
-		// Convert polyline to lines
-		for (const auto& polyline : polylines)
-		{
-			size_t verticesCount = polyline.size();
-			for (size_t nVertex = 0; nVertex < verticesCount; ++nVertex)
-			{
-				const bool duplicateIndex = (nVertex > 0 && nVertex + 1 < verticesCount);
-				const auto& vertex = polyline[nVertex];
-				const unsigned vertexIndex = static_cast<unsigned>(vertices.size());
-
-				indices.insert(indices.end(), duplicateIndex ? 2 : 1, vertexIndex);
-				vertices.emplace_back(vertex.x, vertex.y, vertex.z);
-			}
-		}
-
-		// report success
-		return true;
-	}
-
 	void GenerateSphereRepresentation(
 		std::vector<MFloatVector>& vertices,
 		std::vector<unsigned int>& indices)
@@ -215,17 +85,17 @@ bool IESLightLocatorMeshBase::SetFilename(const MString filename, bool forcedUpd
 		return false;
 	}
 
-	const wchar_t* castedName = filename.asWChar();
-	std::wstring local = castedName;
-
-	if (local.empty())
+	if (filename.length() == 0)
 	{
+		m_profile.reset();
 		GenerateSphereRepresentation(m_vertices, m_indices);
 	}
 	else
 	{
-		const size_t pointsPerPolyline = 32;
-		bool isGenerated = GenerateIESRepresentation(castedName, pointsPerPolyline, IES_SCALE_MUL, m_vertices, m_indices);
+		// Representation is shared by all locators using the file
+		m_profile = IESProfileCache::GetInstance().GetProfile(filename);
+		m_vertices.clear();
+		m_indices.clear();
 	}
 
 	m_filename = filename;
@@ -233,6 +103,16 @@ bool IESLightLocatorMeshBase::SetFilename(const MString filename, bool forcedUpd
 	return true;
 }
 
+const std::vector<MFloatVector>& IESLightLocatorMeshBase::GetVertices() const
+{
+	return m_profile ? m_profile->vertices : m_vertices;
+}
+
+const std::vector<unsigned int>& IESLightLocatorMeshBase::GetIndices() const
+{
+	return m_profile ? m_profile->indices : m_indices;
+}
+
 
 IESLightLegacyLocatorMesh::IESLightLegacyLocatorMesh() :
 	m_scale(1.f),
@@ -292,12 +172,15 @@ void IESLightLegacyLocatorMesh::Draw(M3dView& view)
 	glPushAttrib(GL_ALL_ATTRIB_BITS);
 	glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
 
+	const std::vector<MFloatVector>& meshVertices = GetVertices();
+	const std::vector<unsigned int>& meshIndices = GetIndices();
+
 	glEnableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(3, GL_FLOAT, 0, m_vertices.data());
+	glVertexPointer(3, GL_FLOAT, 0, meshVertices.data());
 
 	glDrawElements(GL_LINES,
-		static_cast<GLsizei>(m_indices.size()),
-		GL_UNSIGNED_INT, m_indices.data());
+		static_cast<GLsizei>(meshIndices.size()),
+		GL_UNSIGNED_INT, meshIndices.data());
 
 	glDisableClientState(GL_VERTEX_ARRAY);
 
@@ -314,9 +197,12 @@ void IESLightLocatorMesh::populateOverrideGeometry(
 	const MHWRender::MRenderItemList &renderItems,
 	MHWRender::MGeometry &data)
 {
+	const std::vector<MFloatVector>& meshVertices = GetVertices();
+	const std::vector<unsigned int>& meshIndices = GetIndices();
+
 	// Get the vertex and index counts.
-	unsigned int vertexCount = static_cast<unsigned int>(m_vertices.size());
-	unsigned int indexCount = static_cast<unsigned int>(m_indices.size());
+	unsigned int vertexCount = static_cast<unsigned int>(meshVertices.size());
+	unsigned int indexCount = static_cast<unsigned int>(meshIndices.size());
 
 	// Get vertex buffer requirements.
 	auto& vertexBufferDescriptorList = requirements.vertexRequirements();
@@ -358,7 +244,7 @@ void IESLightLocatorMesh::populateOverrideGeometry(
 	// Populate the vertex buffer.
 	if (vertexBuffer && vertices)
 	{
-		memcpy(vertices, m_vertices.data(), sizeof(MFloatVector) * vertexCount);
+		memcpy(vertices, meshVertices.data(), sizeof(MFloatVector) * vertexCount);
 		vertexBuffer->commit(vertices);
 	}
 
@@ -375,7 +261,7 @@ void IESLightLocatorMesh::populateOverrideGeometry(
 
 		if (indices)
 		{
-			memcpy(indices, m_indices.data(), sizeof(unsigned int) * indexCount);
+			memcpy(indices, meshIndices.data(), sizeof(unsigned int) * indexCount);
 			indexBuffer->commit(indices);
 		}
 
@@ -20,17 +20,28 @@ limitations under the License.
 #include <maya/MRenderTargetManager.h>
 
 #include <array>
+#include <memory>
 #include <vector>
 
+struct IESProfile;
+
 class IESLightLocatorMeshBase
 {
 public:
 	bool SetFilename(const MString value, bool forcedUpdate, bool* fileNameChanged = nullptr);
 
+protected:
+	/** Mesh of the profile if the file is set, own (default sphere) mesh otherwise. */
+	const std::vector<MFloatVector>& GetVertices() const;
+	const std::vector<unsigned int>& GetIndices() const;
+
 protected:
 	MString m_filename;
 	std::vector<unsigned int> m_indices;
 	std::vector<MFloatVector> m_vertices;
+
+	/** Cached profile of the file, shared with other lights. */
+	std::shared_ptr<const IESProfile> m_profile;
 };
 
 /**
@@ -0,0 +1,197 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "IESProfileCache.h"
+
+#include <cassert>
+#include <sstream>
+
+#include "FireRenderError.h"
+
+namespace
+{
+	// TODO: these parameters are hardcoded for now. Fix it!
+	const float IES_SCALE_MUL = 0.05f;
+	const size_t IES_POINTS_PER_POLYLINE = 32;
+
+	const char* DescribeIESError(IESLightRepresentationErrorCode code)
+	{
+		switch (code)
+		{
+			case IESLightRepresentationErrorCode::INVALID_DATA:
+				return "Invalid ies data";
+
+			case IESLightRepresentationErrorCode::NO_EDGES:
+				return "Could not build nay edges to show ies light";
+		}
+
+		// Wrong use of this function
+		assert(false);
+		return nullptr;
+	}
+
+	const char* DescribeIESError(IESProcessor::ErrorCode code)
+	{
+		switch (code)
+		{
+			case IESProcessor::ErrorCode::NO_FILE:
+				return "Given file is empty";
+
+			case IESProcessor::ErrorCode::NOT_IES_FILE:
+				return "Wrong file (not *ies)";
+
+			case IESProcessor::ErrorCode::FAILED_TO_READ_FILE:
+				return "Failed to open the file";
+
+			case IESProcessor::ErrorCode::INVALID_DATA_IN_IES_FILE:
+				return "Invalid data in ies file";
+
+			case IESProcessor::ErrorCode::PARSE_FAILED:
+				return "ies file parsing failed";
+
+			case IESProcessor::ErrorCode::UNEXPECTED_END_OF_FILE:
+				return "Unexpected end of ies file";
+
+			case IESProcessor::ErrorCode::NOT_SUPPORTED:
+				return "Not supported format of ies file";
+		}
+
+		// Wrong use of this function
+		assert(false);
+		return nullptr;
+	}
+
+	void BuildRepresentation(IESProfile& profile)
+	{
+		std::vector<std::vector<RadeonProRender::float3>> polylines;
+
+		auto calcError = CalculateIESLightRepresentation(polylines, profile.params);
+
+		if (calcError != IESLightRepresentationErrorCode::SUCCESS)
+		{
+			std::stringstream errorMessage;
+			const char* errorDescription = DescribeIESError(calcError);
+			errorMessage << "RPR Warning: ies file parsed successfully but failed to build it's representation";
+
+			if (errorDescription != nullptr)
+			{
+				errorMessage << " (reason: " << errorDescription << ") ";
+			}
+
+			FireRenderError error;
+			error.set("Show ies form failed", errorMessage.str().c_str());
+			return;
+		}
+
+		// Convert polyline to lines
+		for (const auto& polyline : polylines)
+		{
+			size_t verticesCount = polyline.size();
+			for (size_t nVertex = 0; nVertex < verticesCount; ++nVertex)
+			{
+				const bool duplicateIndex = (nVertex > 0 && nVertex + 1 < verticesCount);
+				const auto& vertex = polyline[nVertex];
+				const unsigned vertexIndex = static_cast<unsigned>(profile.vertices.size());
+
+				profile.indices.insert(profile.indices.end(), duplicateIndex ? 2 : 1, vertexIndex);
+				profile.vertices.emplace_back(vertex.x, vertex.y, vertex.z);
+			}
+		}
+
+		profile.hasRepresentation = true;
+	}
+}
+
+IESProfileCache& IESProfileCache::GetInstance()
+{
+	static IESProfileCache instance;
+	return instance;
+}
+
+std::shared_ptr<const IESProfile> IESProfileCache::GetProfile(const MString& filePath)
+{
+	namespace fs = std::filesystem;
+
+	std::wstring key = filePath.asWChar();
+
+	// Missing file gets the default time, so it is parsed (and reported) again once it appears
+	std::error_code errorCode;
+	fs::file_time_type modificationTime = fs::last_write_time(fs::path(key), errorCode);
+	if (errorCode)
+	{
+		modificationTime = fs::file_time_type();
+	}
+
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	auto it = m_entries.find(key);
+	if (it != m_entries.end() && it->second.modificationTime == modificationTime)
+	{
+		return it->second.profile;
+	}
+
+	// Parsing under the lock, so lights sharing a file which is not cached yet don't parse it in parallel
+	Entry entry;
+	entry.modificationTime = modificationTime;
+	entry.profile = LoadProfile(filePath);
+
+	m_entries[key] = entry;
+
+	return entry.profile;
+}
+
+void IESProfileCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	m_entries.clear();
+}
+
+std::shared_ptr<const IESProfile> IESProfileCache::LoadProfile(const MString& filePath)
+{
+	auto profile = std::make_shared<IESProfile>();
+
+	if (filePath.length() == 0)
+	{
+		return profile;
+	}
+
+	IESProcessor processor;
+	profile->params.maxPointsPerPLine = IES_POINTS_PER_POLYLINE;
+	profile->params.webScale = IES_SCALE_MUL;
+
+	auto parseError = processor.Parse(profile->params.data, filePath.asWChar());
+
+	if (parseError != IESProcessor::ErrorCode::SUCCESS)
+	{
+		std::stringstream errorMessage;
+		const char* errorDescription = DescribeIESError(parseError);
+		errorMessage << "RPR Error: Failed to parse ies file";
+
+		if (errorDescription != nullptr)
+		{
+			errorMessage << " (reason: " << errorDescription << ") ";
+		}
+
+		FireRenderError error;
+		error.set("Parse error", errorMessage.str().c_str(), false, false);
+
+		return profile;
+	}
+
+	profile->parsed = true;
+	profile->iesData = processor.ToString(profile->params.data);
+
+	BuildRepresentation(*profile);
+
+	return profile;
+}
@@ -0,0 +1,80 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <maya/MString.h>
+#include <maya/MFloatVector.h>
+
+#include "IESLight/IESprocessor.h"
+#include "IESLight/IESLightRepresentationCalc.h"
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/** Parsed IES profile with everything built from it, shared by all lights using the file. */
+struct IESProfile
+{
+	/** True if the file was parsed successfully. */
+	bool parsed = false;
+
+	/** Parsed profile data. */
+	IESLightRepresentationParams params;
+
+	/** Profile data in the format accepted by rprIESLightSetImageFromIESdata. */
+	std::string iesData;
+
+	/** True if the viewport representation was built. */
+	bool hasRepresentation = false;
+
+	/** Viewport representation edges, pairs of indices into vertices. */
+	std::vector<MFloatVector> vertices;
+	std::vector<unsigned int> indices;
+};
+
+/**
+ * Process wide cache of IES profiles keyed by file path.
+ * A profile is parsed again only if the file was modified.
+ */
+class IESProfileCache
+{
+public:
+	static IESProfileCache& GetInstance();
+
+	IESProfileCache(const IESProfileCache&) = delete;
+	IESProfileCache& operator=(const IESProfileCache&) = delete;
+
+	/** Get the profile of the file, never null. Parse errors are reported once per file version. */
+	std::shared_ptr<const IESProfile> GetProfile(const MString& filePath);
+
+	void Clear();
+
+private:
+	IESProfileCache() = default;
+
+	static std::shared_ptr<const IESProfile> LoadProfile(const MString& filePath);
+
+private:
+	struct Entry
+	{
+		std::filesystem::file_time_type modificationTime;
+		std::shared_ptr<const IESProfile> profile;
+	};
+
+	std::mutex m_lock;
+
+	std::unordered_map<std::wstring, Entry> m_entries;
+};
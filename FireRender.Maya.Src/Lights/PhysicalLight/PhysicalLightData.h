@@ -82,6 +82,9 @@ struct PhysicalLightData
 	PLIntensityUnit intensityUnits;
 
 	frw::Value resultFrwColor;
+	// Hash of the nodes connected to the color, lights with the same one share the emissive shader
+	size_t colorInputHash = 0;
+
 	// Spot
 	float spotInnerAngle;
 	float spotOuterFallOff;
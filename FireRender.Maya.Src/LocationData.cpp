@@ -0,0 +1,398 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "LocationData.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#undef min
+#undef max
+
+// Namespaces
+// -----------------------------------------------------------------------------
+using namespace std;
+
+
+// Public Methods
+// -----------------------------------------------------------------------------
+void LocationData::load(const string& path)
+{
+	// Load countries, locations and time zones.
+	loadCountries(path);
+	loadLocations(path);
+	loadTimeZones(path);
+
+	// Build lookup structures.
+	buildTimeZoneGrid();
+	buildLocationIndex();
+}
+
+// -----------------------------------------------------------------------------
+void LocationData::set(vector<string> countries, vector<Location> locations, vector<TimeZone> timeZones)
+{
+	m_countries = std::move(countries);
+	m_locations = std::move(locations);
+	m_timeZones = std::move(timeZones);
+
+	buildTimeZoneGrid();
+	buildLocationIndex();
+}
+
+// -----------------------------------------------------------------------------
+vector<int> LocationData::findLocations(const string& search) const
+{
+	// Short search strings match most of the locations anyway.
+	if (search.size() < 3)
+		return findLocationsLinear(search);
+
+	// Use the least common trigram of the search string to get candidates.
+	const vector<int>* candidates = nullptr;
+
+	for (size_t i = 0; i + 3 <= search.size(); i++)
+	{
+		auto it = m_locationTrigrams.find(getTrigram(&search[i]));
+
+		// No location has this trigram, so nothing can match.
+		if (it == m_locationTrigrams.end())
+			return vector<int>();
+
+		if (!candidates || it->second.size() < candidates->size())
+			candidates = &it->second;
+	}
+
+	// Verify candidates, they are in ascending order already.
+	vector<int> result;
+
+	for (int index : *candidates)
+	{
+		if (m_locations[index].name.find(search) != string::npos)
+			result.push_back(index);
+	}
+
+	return result;
+}
+
+// -----------------------------------------------------------------------------
+vector<int> LocationData::findLocationsLinear(const string& search) const
+{
+	vector<int> result;
+
+	for (int i = 0; i < (int)m_locations.size(); i++)
+	{
+		if (m_locations[i].name.find(search) != string::npos)
+			result.push_back(i);
+	}
+
+	return result;
+}
+
+// -----------------------------------------------------------------------------
+int LocationData::findTimeZone(float x, float y) const
+{
+	if (m_timeZoneGrid.empty())
+		return -1;
+
+	for (int index : m_timeZoneGrid[getTimeZoneGridCell(x, y)])
+	{
+		const TimeZone& timeZone = m_timeZones[index];
+
+		// Reject by bounds before the exact test.
+		if (x < timeZone.boundsMin.x || x > timeZone.boundsMax.x ||
+			y < timeZone.boundsMin.y || y > timeZone.boundsMax.y)
+			continue;
+
+		if (isPointInTimeZone(timeZone, x, y))
+			return index;
+	}
+
+	return -1;
+}
+
+// -----------------------------------------------------------------------------
+int LocationData::findTimeZoneLinear(float x, float y) const
+{
+	for (int i = 0; i < (int)m_timeZones.size(); i++)
+	{
+		if (isPointInTimeZone(m_timeZones[i], x, y))
+			return i;
+	}
+
+	return -1;
+}
+
+
+// Private Methods
+// -----------------------------------------------------------------------------
+bool LocationData::DataReader::open(const string& fileName)
+{
+	m_data.clear();
+	m_position = 0;
+
+	// Read the whole file at once.
+	ifstream file(filesystem::u8path(fileName), ios::binary | ios::ate);
+	if (!file)
+		return false;
+
+	streamoff size = file.tellg();
+	file.seekg(0, ios::beg);
+
+	if (size > 0)
+	{
+		m_data.resize((size_t)size);
+		file.read(m_data.data(), m_data.size());
+		m_data.resize((size_t)file.gcount());
+	}
+
+	return !m_data.empty();
+}
+
+// -----------------------------------------------------------------------------
+void LocationData::DataReader::readBytes(void* dest, size_t size)
+{
+	// Truncated files leave remaining values zeroed.
+	size_t available = std::min(size, m_data.size() - m_position);
+	memcpy(dest, m_data.data() + m_position, available);
+	memset((char*)dest + available, 0, size - available);
+	m_position += available;
+}
+
+// -----------------------------------------------------------------------------
+string LocationData::DataReader::readString()
+{
+	int length = read<int>();
+	size_t available = std::min<size_t>(std::max(length, 0), m_data.size() - m_position);
+
+	string result(m_data.data() + m_position, available);
+	m_position += available;
+
+	// Match the C string semantics of the original data format.
+	result.resize(strlen(result.c_str()));
+
+	return result;
+}
+
+// -----------------------------------------------------------------------------
+void LocationData::loadCountries(const string& path)
+{
+	// Read the countries file.
+	DataReader reader;
+	if (!reader.open(path + "countries.dat"))
+		return;
+
+	// Read the number of countries and resize the container.
+	int count = std::max(reader.read<int>(), 0);
+	m_countries.resize(count);
+
+	// Read countries.
+	for (int i = 0; i < count; i++)
+	{
+		m_countries[i] = reader.readString();
+	}
+}
+
+// -----------------------------------------------------------------------------
+void LocationData::loadLocations(const string& path)
+{
+	// Read the locations file.
+	DataReader reader;
+	if (!reader.open(path + "locations.dat"))
+		return;
+
+	// Read the number of locations and resize the container.
+	int count = std::max(reader.read<int>(), 0);
+	m_locations.resize(count);
+
+	// Read locations.
+	for (int i = 0; i < count; i++)
+	{
+		Location& location = m_locations[i];
+
+		// Read the location name.
+		location.name = reader.readString();
+
+		// Read geographic information.
+		location.latitude = reader.read<float>();
+		location.longitude = reader.read<float>();
+		location.utcOffset = reader.read<float>();
+		location.countryIndex = reader.read<int>();
+
+		// Guard country lookups against bad data.
+		if (location.countryIndex < 0 || location.countryIndex >= (int)m_countries.size())
+			location.countryIndex = 0;
+	}
+}
+
+// -----------------------------------------------------------------------------
+void LocationData::loadTimeZones(const string& path)
+{
+	// Read the time zone shapes file.
+	DataReader reader;
+	if (!reader.open(path + "time_zones.dat"))
+		return;
+
+	// Read the number of locations and resize the container.
+	int count = std::max(reader.read<int>(), 0);
+	m_timeZones.resize(count);
+
+	// Read time zones.
+	for (int i = 0; i < count; i++)
+	{
+		TimeZone& timeZone = m_timeZones[i];
+
+		// Read the time zone name.
+		timeZone.name = reader.readString();
+
+		// Read time zone type and UTC offset.
+		timeZone.type = reader.read<int>();
+		timeZone.utcOffset = reader.read<float>();
+
+		// Read time zone vertices (longitude and latitude pairs) in one block.
+		int vertexCount = std::max(reader.read<int>(), 0);
+		timeZone.vertices.resize(vertexCount);
+		reader.readBytes(timeZone.vertices.data(), timeZone.vertices.size() * sizeof(Point));
+	}
+}
+
+// -----------------------------------------------------------------------------
+void LocationData::buildTimeZoneGrid()
+{
+	m_timeZoneGrid.assign(TimeZoneGridWidth * TimeZoneGridHeight, vector<int>());
+
+	for (int i = 0; i < (int)m_timeZones.size(); i++)
+	{
+		TimeZone& timeZone = m_timeZones[i];
+
+		// Rectangles need two vertices, polygons need at least one
+		// edge; skip time zones that can never contain a point.
+		bool valid = (timeZone.type == RECTANGLE && timeZone.vertices.size() >= 2) ||
+			(timeZone.type == POLYGON && !timeZone.vertices.empty());
+
+		if (!valid)
+			continue;
+
+		// Rectangles are defined by the first two vertices only.
+		size_t vertexCount = timeZone.type == RECTANGLE ? 2 : timeZone.vertices.size();
+
+		timeZone.boundsMin = timeZone.vertices[0];
+		timeZone.boundsMax = timeZone.vertices[0];
+
+		for (size_t j = 1; j < vertexCount; j++)
+		{
+			const Point& v = timeZone.vertices[j];
+			timeZone.boundsMin = { fminf(timeZone.boundsMin.x, v.x), fminf(timeZone.boundsMin.y, v.y) };
+			timeZone.boundsMax = { fmaxf(timeZone.boundsMax.x, v.x), fmaxf(timeZone.boundsMax.y, v.y) };
+		}
+
+		// Register the time zone in every cell its bounds overlap.
+		int first = getTimeZoneGridCell(timeZone.boundsMin.x, timeZone.boundsMin.y);
+		int last = getTimeZoneGridCell(timeZone.boundsMax.x, timeZone.boundsMax.y);
+
+		for (int y = first / TimeZoneGridWidth; y <= last / TimeZoneGridWidth; y++)
+		{
+			for (int x = first % TimeZoneGridWidth; x <= last % TimeZoneGridWidth; x++)
+			{
+				m_timeZoneGrid[y * TimeZoneGridWidth + x].push_back(i);
+			}
+		}
+	}
+}
+
+// -----------------------------------------------------------------------------
+void LocationData::buildLocationIndex()
+{
+	m_locationTrigrams.clear();
+
+	for (int i = 0; i < (int)m_locations.size(); i++)
+	{
+		const string& name = m_locations[i].name;
+
+		for (size_t j = 0; j + 3 <= name.size(); j++)
+		{
+			vector<int>& indices = m_locationTrigrams[getTrigram(&name[j])];
+
+			// A name may contain the same trigram several times.
+			if (indices.empty() || indices.back() != i)
+				indices.push_back(i);
+		}
+	}
+}
+
+// -----------------------------------------------------------------------------
+int LocationData::getTimeZoneGridCell(float x, float y)
+{
+	// Points outside of the valid range are clamped to the border
+	// cells, the same way as the bounds of the time zones.
+	int cellX = (int)floorf((x + 180.0f) / TimeZoneGridCellSize);
+	int cellY = (int)floorf((y + 90.0f) / TimeZoneGridCellSize);
+
+	cellX = std::min(std::max(cellX, 0), TimeZoneGridWidth - 1);
+	cellY = std::min(std::max(cellY, 0), TimeZoneGridHeight - 1);
+
+	return cellY * TimeZoneGridWidth + cellX;
+}
+
+// -----------------------------------------------------------------------------
+uint32_t LocationData::getTrigram(const char* c)
+{
+	return ((uint32_t)(unsigned char)c[0] << 16) |
+		((uint32_t)(unsigned char)c[1] << 8) |
+		(uint32_t)(unsigned char)c[2];
+}
+
+// -----------------------------------------------------------------------------
+bool LocationData::isPointInTimeZone(const TimeZone& timeZone, float x, float y)
+{
+	// Determine if the time zone coordinates should
+	// be interpreted as a rectangle or a polygon.
+	switch (timeZone.type)
+	{
+	case RECTANGLE:
+		return isPointInRectangle(timeZone.vertices, x, y);
+
+	case POLYGON:
+		return isPointInPolygon(timeZone.vertices, x, y);
+
+	default:
+		return false;
+	}
+}
+
+// -----------------------------------------------------------------------------
+bool LocationData::isPointInRectangle(const vector<Point>& v, float x, float y)
+{
+	if (v.size() < 2)
+		return false;
+
+	Point min = { fminf(v[0].x, v[1].x), fminf(v[0].y, v[1].y) };
+	Point max = { fmaxf(v[0].x, v[1].x), fmaxf(v[0].y, v[1].y) };
+
+	return (x >= min.x && x <= max.x && y >= min.y && y <= max.y);
+}
+
+// -----------------------------------------------------------------------------
+bool LocationData::isPointInPolygon(const vector<Point>& v, float x, float y)
+{
+	bool inside = false;
+	size_t count = v.size();
+
+	for (size_t i = 0, j = count - 1; i < count; j = i++)
+	{
+		if (((v[i].y > y) != (v[j].y > y)) &&
+			(x < (v[j].x - v[i].x) * (y - v[i].y) / (v[j].y - v[i].y) + v[i].x))
+			inside = !inside;
+	}
+
+	return inside;
+}
@@ -0,0 +1,192 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+/**
+ * Countries, locations and time zones used by the sky location
+ * search, with the lookup indices. Has no Maya dependencies.
+ */
+class LocationData
+{
+
+public:
+
+	// Enums
+	// -----------------------------------------------------------------------------
+
+	/** The types of region that define a time zone boundary. */
+	enum TimeZoneType
+	{
+		RECTANGLE,
+		POLYGON
+	};
+
+
+	// Structs
+	// -----------------------------------------------------------------------------
+
+	/** Geographic point, x is longitude and y is latitude. */
+	struct Point
+	{
+		float x;
+		float y;
+	};
+
+	/** Location information. */
+	struct Location
+	{
+		std::string name;
+		float latitude;
+		float longitude;
+		float utcOffset;
+		int countryIndex;
+	};
+
+	/** Time zone information. */
+	struct TimeZone
+	{
+		std::string name;
+		std::vector<Point> vertices;
+		int type;
+		float utcOffset;
+
+		/** Bounding box of the vertices. */
+		Point boundsMin;
+		Point boundsMax;
+	};
+
+
+	// Public Methods
+	// -----------------------------------------------------------------------------
+
+	/** Load data files from the given folder (UTF-8, ending with a separator) and build lookup indices. */
+	void load(const std::string& path);
+
+	/** Replace the data and build lookup indices. */
+	void set(std::vector<std::string> countries, std::vector<Location> locations, std::vector<TimeZone> timeZones);
+
+	const std::vector<std::string>& countries() const { return m_countries; }
+	const std::vector<Location>& locations() const { return m_locations; }
+	const std::vector<TimeZone>& timeZones() const { return m_timeZones; }
+
+	/** Get indices of the locations with names containing the search string, in ascending order. */
+	std::vector<int> findLocations(const std::string& search) const;
+
+	/** Brute force version of findLocations, used for validation. */
+	std::vector<int> findLocationsLinear(const std::string& search) const;
+
+	/** Get the index of the first time zone containing the point or -1. */
+	int findTimeZone(float x, float y) const;
+
+	/** Brute force version of findTimeZone, used for validation. */
+	int findTimeZoneLinear(float x, float y) const;
+
+
+private:
+
+	/** Reads values from a data file loaded into memory with a single read. */
+	class DataReader
+	{
+	public:
+		/** Load the whole file. Returns false if it can't be read. */
+		bool open(const std::string& fileName);
+
+		template <typename T>
+		T read()
+		{
+			T value = T();
+			readBytes(&value, sizeof(T));
+			return value;
+		}
+
+		/** Read a length prefixed string. */
+		std::string readString();
+
+		void readBytes(void* dest, size_t size);
+
+	private:
+		std::vector<char> m_data;
+		size_t m_position = 0;
+	};
+
+
+	// Constants
+	// -----------------------------------------------------------------------------
+
+	/** Size of a time zone grid cell in degrees. */
+	static const int TimeZoneGridCellSize = 5;
+	static const int TimeZoneGridWidth = 360 / TimeZoneGridCellSize;
+	static const int TimeZoneGridHeight = 180 / TimeZoneGridCellSize;
+
+
+	// Private Methods
+	// -----------------------------------------------------------------------------
+
+	/** Load country data. */
+	void loadCountries(const std::string& path);
+
+	/** Load location data. */
+	void loadLocations(const std::string& path);
+
+	/** Load time zone data. */
+	void loadTimeZones(const std::string& path);
+
+	/** Build the time zone bounding box grid. */
+	void buildTimeZoneGrid();
+
+	/** Build the location name trigram index. */
+	void buildLocationIndex();
+
+	/** Get the time zone grid cell containing the given point. */
+	static int getTimeZoneGridCell(float x, float y);
+
+	/** Get the trigram key starting at the given character. */
+	static uint32_t getTrigram(const char* c);
+
+	/** True if the given point is in the given time zone. */
+	static bool isPointInTimeZone(const TimeZone& timeZone, float x, float y);
+
+	/** True if the given point is in the rectangle defined by the vertices. */
+	static bool isPointInRectangle(const std::vector<Point>& v, float x, float y);
+
+	/** True if the given point is in the polygon defined by the vertices. */
+	static bool isPointInPolygon(const std::vector<Point>& v, float x, float y);
+
+
+	// Members
+	// -----------------------------------------------------------------------------
+
+	/** The list of all countries. */
+	std::vector<std::string> m_countries;
+
+	/** The list of all locations. */
+	std::vector<Location> m_locations;
+
+	/** The list of all time zones. */
+	std::vector<TimeZone> m_timeZones;
+
+	/**
+	 * Time zone indices by grid cell, in ascending order so the first
+	 * matching time zone is the same as for a scan of all time zones.
+	 */
+	std::vector<std::vector<int>> m_timeZoneGrid;
+
+	/** Location indices by name trigram, in ascending order. */
+	std::unordered_map<uint32_t, std::vector<int>> m_locationTrigrams;
+};
@@ -0,0 +1,446 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace
+{
+	// Initial size of the per thread format buffer
+	const size_t FormatBufferSize = 1024;
+
+	// The background thread sleeps at most this long if it misses a wake up
+	const std::chrono::milliseconds MaxSinkIdleTime(20);
+
+	/**
+	 * Multiple producer single consumer queue (intrusive, based on the D. Vyukov's algorithm).
+	 * Push is wait free, it is an exchange of the head pointer. Pop is called by a single consumer at a time.
+	 */
+	class RecordQueue
+	{
+	public:
+		struct Node
+		{
+			std::atomic<Node*> next { nullptr };
+			Logger::Record record;
+		};
+
+		RecordQueue() :
+			m_head(&m_stub),
+			m_tail(&m_stub)
+		{
+		}
+
+		~RecordQueue()
+		{
+			while (Node* node = Pop())
+			{
+				delete node;
+			}
+		}
+
+		void Push(Node* node)
+		{
+			node->next.store(nullptr, std::memory_order_relaxed);
+			Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+			prev->next.store(node, std::memory_order_release);
+		}
+
+		/** Returns null if the queue is empty or a producer is in the middle of the push. */
+		Node* Pop()
+		{
+			Node* tail = m_tail;
+			Node* next = tail->next.load(std::memory_order_acquire);
+
+			if (tail == &m_stub)
+			{
+				if (next == nullptr)
+				{
+					return nullptr;
+				}
+
+				m_tail = next;
+				tail = next;
+				next = next->next.load(std::memory_order_acquire);
+			}
+
+			if (next != nullptr)
+			{
+				m_tail = next;
+				return tail;
+			}
+
+			if (tail != m_head.load(std::memory_order_acquire))
+			{
+				return nullptr;
+			}
+
+			Push(&m_stub);
+
+			next = tail->next.load(std::memory_order_acquire);
+			if (next != nullptr)
+			{
+				m_tail = next;
+				return tail;
+			}
+
+			return nullptr;
+		}
+
+	private:
+		std::atomic<Node*> m_head;
+		Node* m_tail;
+		Node m_stub;
+	};
+
+	class LoggerState
+	{
+	public:
+		static LoggerState& Instance()
+		{
+			static LoggerState instance;
+			return instance;
+		}
+
+		~LoggerState()
+		{
+			Shutdown();
+		}
+
+		template <class Cb>
+		void AddCallback(std::map<Cb, Logger::LevelEnum>& callbacks, Cb cb, Logger::LevelEnum level)
+		{
+			std::lock_guard<std::recursive_mutex> lock(m_callbacksMutex);
+
+			callbacks[cb] = level;
+			UpdateMinLevel();
+		}
+
+		template <class Cb>
+		void RemoveCallback(std::map<Cb, Logger::LevelEnum>& callbacks, Cb cb)
+		{
+			std::lock_guard<std::recursive_mutex> lock(m_callbacksMutex);
+
+			callbacks.erase(cb);
+			UpdateMinLevel();
+		}
+
+		bool IsEnabled(Logger::LevelEnum level) const
+		{
+			return level >= m_minLevel.load(std::memory_order_relaxed);
+		}
+
+		void Submit(Logger::LevelEnum level, const Logger::Fields& fields, const char* message)
+		{
+			std::unique_ptr<RecordQueue::Node> node(new RecordQueue::Node());
+
+			Logger::Record& record = node->record;
+			record.level = level;
+			record.frame = fields.frame;
+			record.object = fields.object ? fields.object : "";
+			record.phase = fields.phase ? fields.phase : "";
+			record.message = message;
+			record.threadId = std::this_thread::get_id();
+
+			if (!StartSink())
+			{
+				Dispatch(record);
+				return;
+			}
+
+			m_pending.fetch_add(1, std::memory_order_relaxed);
+			m_queue.Push(node.release());
+
+			// Shutdown may have drained the queue since the state check, then the record would never be dispatched.
+			// Either Shutdown sees the pushed record or the state seen here isn't Running, the queue is drained here then.
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (m_state.load() != Running)
+			{
+				DispatchQueued();
+				return;
+			}
+
+			m_sinkCondition.notify_one();
+		}
+
+		void Flush()
+		{
+			if (m_state.load() != Running || std::this_thread::get_id() == m_sinkThreadId)
+			{
+				return;
+			}
+
+			std::unique_lock<std::mutex> lock(m_flushMutex);
+			m_flushCondition.wait_for(lock, std::chrono::seconds(10), [this]() { return m_pending.load() == 0 || m_state.load() != Running; });
+		}
+
+		void Shutdown()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_sinkMutex);
+
+				if (m_state.exchange(Stopped) != Running)
+				{
+					return;
+				}
+			}
+
+			m_sinkCondition.notify_one();
+
+			if (m_sinkThread.joinable())
+			{
+				m_sinkThread.join();
+			}
+
+			// Records pushed while the thread was stopping, pairs with the fence in Submit
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			DispatchQueued();
+		}
+
+		void Restart()
+		{
+			Shutdown();
+
+			std::lock_guard<std::mutex> lock(m_sinkMutex);
+			m_state.store(NotStarted);
+		}
+
+	private:
+		enum State
+		{
+			NotStarted,
+			Running,
+			Stopped,
+		};
+
+		LoggerState() = default;
+
+		void UpdateMinLevel()
+		{
+			int minLevel = Logger::LevelError + 1;
+
+			for (const auto& it : m_callbacks)
+			{
+				minLevel = std::min<int>(minLevel, it.second);
+			}
+
+			for (const auto& it : m_recordCallbacks)
+			{
+				minLevel = std::min<int>(minLevel, it.second);
+			}
+
+			m_minLevel.store(minLevel);
+		}
+
+		/** Starts the background thread on the first record. Returns false if the records should be dispatched synchronously. */
+		bool StartSink()
+		{
+			State state = m_state.load(std::memory_order_acquire);
+			if (state != NotStarted)
+			{
+				return state == Running;
+			}
+
+			std::lock_guard<std::mutex> lock(m_sinkMutex);
+
+			if (m_state.load() == NotStarted)
+			{
+				// The thread runs while the state is Running
+				m_state.store(Running);
+				m_sinkThread = std::thread([this]() { SinkProc(); });
+				m_sinkThreadId = m_sinkThread.get_id();
+			}
+
+			return m_state.load() == Running;
+		}
+
+		void SinkProc()
+		{
+			while (m_state.load() == Running)
+			{
+				DispatchQueued();
+
+				std::unique_lock<std::mutex> lock(m_sinkMutex);
+				m_sinkCondition.wait_for(lock, MaxSinkIdleTime);
+			}
+
+			DispatchQueued();
+		}
+
+		void DispatchQueued()
+		{
+			// The queue has a single consumer, after Shutdown the logging threads drain it too
+			std::lock_guard<std::recursive_mutex> lock(m_dispatchMutex);
+
+			size_t count = 0;
+
+			while (RecordQueue::Node* node = m_queue.Pop())
+			{
+				Dispatch(node->record);
+				delete node;
+				count++;
+			}
+
+			if (count > 0 && m_pending.fetch_sub(count) == count)
+			{
+				std::lock_guard<std::mutex> lock(m_flushMutex);
+				m_flushCondition.notify_all();
+			}
+		}
+
+		void Dispatch(Logger::Record& record)
+		{
+			record.text = FormatText(record);
+
+#ifdef LINUX
+			// Added for Linux debugging:
+			std::clog << record.text;
+#endif
+
+			std::lock_guard<std::recursive_mutex> lock(m_callbacksMutex);
+
+			for (const auto& it : m_callbacks)
+			{
+				if (it.second <= record.level)
+				{
+					it.first(record.text.c_str());
+				}
+			}
+
+			for (const auto& it : m_recordCallbacks)
+			{
+				if (it.second <= record.level)
+				{
+					it.first(record);
+				}
+			}
+		}
+
+		static std::string FormatText(const Logger::Record& record)
+		{
+			std::string text;
+
+			if (record.frame >= 0)
+			{
+				text += "[frame " + std::to_string(record.frame) + "] ";
+			}
+
+			if (!record.object.empty())
+			{
+				text += "[" + record.object + "] ";
+			}
+
+			if (!record.phase.empty())
+			{
+				text += "[" + record.phase + "] ";
+			}
+
+			if (text.empty())
+			{
+				return record.message;
+			}
+
+			return text + record.message;
+		}
+
+	public:
+		std::map<Logger::Callback, Logger::LevelEnum> m_callbacks;
+		std::map<Logger::RecordCallback, Logger::LevelEnum> m_recordCallbacks;
+
+	private:
+		/** Recursive, so callbacks called synchronously can log. */
+		std::recursive_mutex m_callbacksMutex;
+
+		/** Lowest level any callback wants, higher than LevelError if there are no callbacks. */
+		std::atomic<int> m_minLevel { Logger::LevelError + 1 };
+
+		RecordQueue m_queue;
+
+		/** Recursive, so callbacks can log while the queue is drained on the same thread. */
+		std::recursive_mutex m_dispatchMutex;
+
+		/** Records pushed and not dispatched yet. */
+		std::atomic<size_t> m_pending { 0 };
+
+		std::atomic<State> m_state { NotStarted };
+		std::thread m_sinkThread;
+		std::atomic<std::thread::id> m_sinkThreadId;
+		std::mutex m_sinkMutex;
+		std::condition_variable m_sinkCondition;
+
+		std::mutex m_flushMutex;
+		std::condition_variable m_flushCondition;
+	};
+}
+
+void Logger::AddCallback(Callback cb, LevelEnum level)
+{
+	LoggerState& state = LoggerState::Instance();
+	state.AddCallback(state.m_callbacks, cb, level);
+}
+
+void Logger::AddCallback(RecordCallback cb, LevelEnum level)
+{
+	LoggerState& state = LoggerState::Instance();
+	state.AddCallback(state.m_recordCallbacks, cb, level);
+}
+
+void Logger::RemoveCallback(Callback cb)
+{
+	LoggerState& state = LoggerState::Instance();
+	state.RemoveCallback(state.m_callbacks, cb);
+}
+
+void Logger::RemoveCallback(RecordCallback cb)
+{
+	LoggerState& state = LoggerState::Instance();
+	state.RemoveCallback(state.m_recordCallbacks, cb);
+}
+
+bool Logger::IsEnabled(LevelEnum level)
+{
+	return LoggerState::Instance().IsEnabled(level);
+}
+
+void Logger::Flush()
+{
+	LoggerState::Instance().Flush();
+}
+
+void Logger::Shutdown()
+{
+	LoggerState::Instance().Shutdown();
+}
+
+void Logger::Restart()
+{
+	LoggerState::Instance().Restart();
+}
+
+std::vector<char>& Logger::FormatBuffer()
+{
+	thread_local std::vector<char> buffer(FormatBufferSize);
+	return buffer;
+}
+
+void Logger::Submit(LevelEnum level, const Fields& fields, const char* message)
+{
+	LoggerState::Instance().Submit(level, fields, message);
+}
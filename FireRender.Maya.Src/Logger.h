@@ -13,10 +13,21 @@ limitations under the License.
 #pragma once
 #include <cstdio>
 #include <map>
+#include <string>
+#include <thread>
 #include <vector>
 #include <iostream>
 #include <assert.h>
 
+/**
+ * Plugin logger.
+ *
+ * The level is checked before the message is formatted, so disabled levels cost an atomic load.
+ * Messages are formatted into a thread local buffer and the records are handed to a background
+ * thread through a lock-free queue, the callbacks are called on that thread in the order of the records
+ * (before the background thread is started and after Shutdown the callbacks are called synchronously).
+ * Callbacks must be thread safe.
+ */
 class Logger
 {
 public:
@@ -28,46 +39,98 @@ public:
 		LevelError,
 	};
 
-private:
+	/** Optional structured fields of the record. Strings are copied only if the level is enabled. */
+	struct Fields
+	{
+		int frame = -1;
+		const char* object = nullptr;
+		const char* phase = nullptr;
+	};
+
+	struct Record
+	{
+		LevelEnum level = LevelInfo;
+
+		/** -1 if not set. */
+		int frame = -1;
+
+		/** Empty if not set. */
+		std::string object;
+		std::string phase;
+
+		std::string message;
+
+		/** Thread which has logged the record. */
+		std::thread::id threadId;
+
+		/** Message prefixed with the fields, it is passed to the text callbacks. */
+		std::string text;
+	};
+
 	typedef void(*Callback)(const char * sz);
+	typedef void(*RecordCallback)(const Record& record);
 
-	std::map<Callback, LevelEnum> callbacks;
+	static void AddCallback(Callback cb, LevelEnum level);
+	static void AddCallback(RecordCallback cb, LevelEnum level);
 
-	// single instance
-	static Logger& Instance()
-	{
-		static Logger instance;
-		return instance;
-	}
+	static void RemoveCallback(Callback cb);
+	static void RemoveCallback(RecordCallback cb);
 
+	/** True if any callback wants the level. */
+	static bool IsEnabled(LevelEnum level);
 
-public:
+	/** Wait until the queued records are passed to the callbacks. */
+	static void Flush();
+
+	/** Flush and stop the background thread, the following records are passed to the callbacks synchronously. */
+	static void Shutdown();
 
-	static void AddCallback(Callback cb, LevelEnum level)
+	/** Shutdown and let the next record start the background thread again, used by the unit tests. */
+	static void Restart();
+
+	template <typename... Args>
+	static void Printf(LevelEnum level, const char *format, const Args&... args)
 	{
-		Instance().callbacks[cb] = level;
+		if (IsEnabled(level))
+		{
+			Submit(level, Fields(), Format(format, args...));
+		}
 	}
 
 	template <typename... Args>
-	static void Printf(LevelEnum level, const char *format, const Args&... args)
+	static void Printf(LevelEnum level, const Fields& fields, const char *format, const Args&... args)
 	{
-		if (!Instance().callbacks.empty())
+		if (IsEnabled(level))
 		{
-			std::vector<char> buf;
-			buf.resize(0x10000);
-			int written = snprintf(buf.data(), buf.size(), format, args...);
-			assert(written >= 0 && written < buf.size());
-#ifdef LINUX
-			// Added for Linux debugging:
-			std::clog << buf.data();
-#endif
-			for (auto cb : Instance().callbacks)
-			{
-				if (cb.second <= level)
-					cb.first(buf.data());
-			}
+			Submit(level, fields, Format(format, args...));
+		}
+	}
+
+private:
+	/** Buffer of the calling thread, it grows to fit the longest message. */
+	static std::vector<char>& FormatBuffer();
+
+	template <typename... Args>
+	static const char* Format(const char *format, const Args&... args)
+	{
+		std::vector<char>& buffer = FormatBuffer();
+
+		int written = snprintf(buffer.data(), buffer.size(), format, args...);
+		if (written < 0)
+		{
+			return format;
 		}
+
+		if (size_t(written) >= buffer.size())
+		{
+			buffer.resize(size_t(written) + 1);
+			snprintf(buffer.data(), buffer.size(), format, args...);
+		}
+
+		return buffer.data();
 	}
+
+	static void Submit(LevelEnum level, const Fields& fields, const char* message);
 };
 
 template <typename... Args>
@@ -84,6 +147,12 @@ inline void LogPrint(const char *format, const Args&... args)
 	Logger::Printf(Logger::LevelInfo, format, args...);
 }
 
+template <typename... Args>
+inline void LogPrint(const Logger::Fields& fields, const char *format, const Args&... args)
+{
+	Logger::Printf(Logger::LevelInfo, fields, format, args...);
+}
+
 template <typename... Args>
 inline void ErrorPrint(const char *format, const Args&... args)
 {
@@ -0,0 +1,61 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace RPR
+{
+	/**
+	 * Splits [0, count) into contiguous ranges and calls func(begin, end) for each of them
+	 * on the OpenMP thread pool, at most one range per thread. Returns when all ranges are done.
+	 * Ranges are not smaller than minRangeSize, so small inputs are processed on the calling thread only.
+	 * Func must not call Maya API, it isn't thread safe, and must not throw.
+	 */
+	template<class Func>
+	void ParallelFor(size_t count, size_t minRangeSize, Func func)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+#ifdef _OPENMP
+		size_t maxRanges = (size_t) std::max(omp_get_max_threads(), 1);
+#else
+		size_t maxRanges = 1;
+#endif
+		size_t rangeCount = std::min(maxRanges, std::max<size_t>(count / std::max<size_t>(minRangeSize, 1), 1));
+
+		if (rangeCount == 1)
+		{
+			func((size_t)0, count);
+			return;
+		}
+
+		size_t rangeSize = (count + rangeCount - 1) / rangeCount;
+		int rangeCountInt = (int) ((count + rangeSize - 1) / rangeSize);
+
+#pragma omp parallel for schedule(static, 1)
+		for (int range = 0; range < rangeCountInt; range++)
+		{
+			size_t begin = (size_t) range * rangeSize;
+			func(begin, std::min(begin + rangeSize, count));
+		}
+	}
+}
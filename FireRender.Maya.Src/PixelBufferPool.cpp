@@ -0,0 +1,241 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "PixelBufferPool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cassert>
+
+#ifdef WIN32
+#include <malloc.h>
+#endif
+
+namespace
+{
+	// Sizes below this are rounded up to it
+	const size_t MinBlockSize = 4096;
+
+	// Each power of two range is split into this many classes, so rounding wastes at most 25%
+	const size_t ClassesPerPowerOfTwo = 4;
+
+	// By default keep up to 1GB of free pixel memory (20 AOVs of 4K RGBA float)
+	const size_t DefaultCacheLimit = size_t(1) << 30;
+
+	size_t Log2Floor(size_t value)
+	{
+		size_t result = 0;
+		while (value >>= 1)
+		{
+			++result;
+		}
+		return result;
+	}
+}
+
+PixelBufferPool& PixelBufferPool::GetInstance()
+{
+	// Never destroyed: pixel buffers owned by static objects can be released during static destruction
+	static PixelBufferPool* instance = new PixelBufferPool();
+	return *instance;
+}
+
+PixelBufferPool::PixelBufferPool() :
+	m_cacheLimit(DefaultCacheLimit)
+{
+}
+
+PixelBufferPool::~PixelBufferPool()
+{
+	Trim();
+}
+
+size_t PixelBufferPool::GetSizeClass(size_t size)
+{
+	if (size <= MinBlockSize)
+	{
+		return MinBlockSize;
+	}
+
+	size_t powerOfTwo = size_t(1) << Log2Floor(size);
+	size_t step = powerOfTwo / ClassesPerPowerOfTwo;
+
+	return (size + step - 1) / step * step;
+}
+
+size_t PixelBufferPool::GetClassIndex(size_t capacity)
+{
+	assert(capacity == GetSizeClass(capacity));
+
+	size_t powerIndex = Log2Floor(capacity);
+	size_t powerOfTwo = size_t(1) << powerIndex;
+	size_t step = powerOfTwo / ClassesPerPowerOfTwo;
+
+	return (powerIndex - Log2Floor(MinBlockSize)) * ClassesPerPowerOfTwo + (capacity - powerOfTwo) / step;
+}
+
+void* PixelBufferPool::AllocateAligned(size_t size)
+{
+#ifdef WIN32
+	return _aligned_malloc(size, Alignment);
+#else
+	void* block = nullptr;
+	if (posix_memalign(&block, Alignment, size) != 0)
+	{
+		return nullptr;
+	}
+	return block;
+#endif
+}
+
+void PixelBufferPool::FreeAligned(void* block)
+{
+#ifdef WIN32
+	_aligned_free(block);
+#else
+	free(block);
+#endif
+}
+
+void* PixelBufferPool::Acquire(size_t size, size_t& outCapacity)
+{
+	outCapacity = GetSizeClass(size);
+	size_t classIndex = GetClassIndex(outCapacity);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		m_stats.allocationCount++;
+
+		if (classIndex < m_freeBlocks.size() && !m_freeBlocks[classIndex].empty())
+		{
+			void* block = m_freeBlocks[classIndex].back();
+			m_freeBlocks[classIndex].pop_back();
+
+			m_stats.poolHitCount++;
+			m_stats.bytesCached -= outCapacity;
+			m_stats.bytesInUse += outCapacity;
+			m_stats.peakBytesInUse = std::max(m_stats.peakBytesInUse, m_stats.bytesInUse);
+
+			return block;
+		}
+	}
+
+	void* block = AllocateAligned(outCapacity);
+
+	if (block == nullptr)
+	{
+		// Free cached blocks and try again
+		Trim();
+		block = AllocateAligned(outCapacity);
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (block == nullptr)
+	{
+		outCapacity = 0;
+		return nullptr;
+	}
+
+	m_stats.systemAllocationCount++;
+	m_stats.bytesInUse += outCapacity;
+	m_stats.peakBytesInUse = std::max(m_stats.peakBytesInUse, m_stats.bytesInUse);
+
+	return block;
+}
+
+void PixelBufferPool::Release(void* block, size_t capacity)
+{
+	if (block == nullptr)
+	{
+		return;
+	}
+
+	size_t classIndex = GetClassIndex(capacity);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_stats.bytesInUse -= capacity;
+
+	if (capacity > m_cacheLimit)
+	{
+		FreeAligned(block);
+		return;
+	}
+
+	if (classIndex >= m_freeBlocks.size())
+	{
+		m_freeBlocks.resize(classIndex + 1);
+	}
+
+	m_freeBlocks[classIndex].push_back(block);
+	m_stats.bytesCached += capacity;
+
+	TrimToLimit();
+}
+
+void PixelBufferPool::TrimToLimit()
+{
+	// Free largest blocks first, they are least likely to be reused (resolution changed)
+	for (size_t classIndex = m_freeBlocks.size(); classIndex > 0 && m_stats.bytesCached > m_cacheLimit; --classIndex)
+	{
+		std::vector<void*>& blocks = m_freeBlocks[classIndex - 1];
+
+		if (blocks.empty())
+		{
+			continue;
+		}
+
+		size_t powerIndex = (classIndex - 1) / ClassesPerPowerOfTwo + Log2Floor(MinBlockSize);
+		size_t powerOfTwo = size_t(1) << powerIndex;
+		size_t capacity = powerOfTwo + ((classIndex - 1) % ClassesPerPowerOfTwo) * (powerOfTwo / ClassesPerPowerOfTwo);
+
+		while (!blocks.empty() && m_stats.bytesCached > m_cacheLimit)
+		{
+			FreeAligned(blocks.back());
+			blocks.pop_back();
+			m_stats.bytesCached -= capacity;
+		}
+	}
+}
+
+void PixelBufferPool::Trim()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (std::vector<void*>& blocks : m_freeBlocks)
+	{
+		for (void* block : blocks)
+		{
+			FreeAligned(block);
+		}
+		blocks.clear();
+	}
+
+	m_stats.bytesCached = 0;
+}
+
+void PixelBufferPool::SetCacheLimit(size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_cacheLimit = bytes;
+	TrimToLimit();
+}
+
+PixelBufferPoolStats PixelBufferPool::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_stats;
+}
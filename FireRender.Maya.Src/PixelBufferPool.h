@@ -0,0 +1,78 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <cstddef>
+
+/** Pool statistics snapshot. */
+struct PixelBufferPoolStats
+{
+	size_t allocationCount = 0;		// total Acquire calls
+	size_t poolHitCount = 0;		// Acquire calls served from cached blocks
+	size_t systemAllocationCount = 0; // Acquire calls which went to the system allocator
+	size_t bytesInUse = 0;			// bytes of blocks currently given out
+	size_t bytesCached = 0;			// bytes of free blocks kept in the pool
+	size_t peakBytesInUse = 0;
+};
+
+/** Size-class memory pool for frame buffer pixels shared by all AOVs.
+	Blocks are 64-byte aligned (suitable for SIMD loads) and rounded up to
+	a size class, so buffers of the same resolution are recycled between
+	tiles and AOVs instead of going back to the system allocator. */
+class PixelBufferPool
+{
+public:
+	static const size_t Alignment = 64;
+
+	static PixelBufferPool& GetInstance();
+
+	PixelBufferPool(const PixelBufferPool&) = delete;
+	PixelBufferPool& operator=(const PixelBufferPool&) = delete;
+
+	/** Returns block of at least size bytes. Real block size is returned in outCapacity. */
+	void* Acquire(size_t size, size_t& outCapacity);
+
+	/** Returns block to the pool. capacity should be the value returned by Acquire. */
+	void Release(void* block, size_t capacity);
+
+	/** Frees all cached blocks. */
+	void Trim();
+
+	/** Max amount of memory kept in free blocks. Blocks above the limit are freed immediately. */
+	void SetCacheLimit(size_t bytes);
+
+	PixelBufferPoolStats GetStats() const;
+
+private:
+	PixelBufferPool();
+	~PixelBufferPool();
+
+	static size_t GetSizeClass(size_t size);
+	static size_t GetClassIndex(size_t capacity);
+
+	static void* AllocateAligned(size_t size);
+	static void FreeAligned(void* block);
+
+	void TrimToLimit();
+
+private:
+	mutable std::mutex m_mutex;
+
+	// free blocks by size class index
+	std::vector<std::vector<void*>> m_freeBlocks;
+
+	size_t m_cacheLimit;
+	PixelBufferPoolStats m_stats;
+};
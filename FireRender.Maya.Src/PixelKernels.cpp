@@ -0,0 +1,299 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "PixelKernels.h"
+
+#include <cstring>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define PIXEL_KERNELS_X86
+#endif
+
+#ifdef PIXEL_KERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define PIXEL_KERNELS_TARGET_AVX2
+#else
+#include <cpuid.h>
+#define PIXEL_KERNELS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace PixelKernels
+{
+	const size_t ComponentCount = 4;
+
+	// Images smaller than this are processed on the calling thread
+	const size_t ParallelThresholdPixels = 512 * 512;
+
+	// Pixel count processed by one task of the element-wise kernels
+	const size_t ChunkPixelCount = 64 * 1024;
+
+	// Row-level threading. Row copies are independent so rows are split between threads
+	template <typename RowFunc>
+	void ForEachRow(unsigned int rowCount, unsigned int rowPixelCount, RowFunc rowFunc)
+	{
+		bool parallel = (size_t)rowCount * rowPixelCount >= ParallelThresholdPixels;
+
+		int count = (int)rowCount;
+#pragma omp parallel for if(parallel)
+		for (int y = 0; y < count; y++)
+		{
+			rowFunc((unsigned int)y);
+		}
+	}
+
+	template <typename ChunkFunc>
+	void ForEachChunk(size_t pixelCount, ChunkFunc chunkFunc)
+	{
+		int chunkCount = (int)((pixelCount + ChunkPixelCount - 1) / ChunkPixelCount);
+		bool parallel = pixelCount >= ParallelThresholdPixels;
+
+#pragma omp parallel for if(parallel)
+		for (int chunk = 0; chunk < chunkCount; chunk++)
+		{
+			size_t first = chunk * ChunkPixelCount;
+			chunkFunc(first, std::min(ChunkPixelCount, pixelCount - first));
+		}
+	}
+
+	// Scalar reference kernels
+	// -----------------------------------------------------------------------------
+	namespace Scalar
+	{
+		void MergeOpacity(float* pixels, const float* opacityPixels, size_t pixelCount)
+		{
+			for (size_t i = 0; i < pixelCount; i++)
+			{
+				pixels[i * ComponentCount + 3] = opacityPixels[i * ComponentCount];
+			}
+		}
+	}
+
+#ifdef PIXEL_KERNELS_X86
+	// SSE kernels (SSE2 is baseline for x64)
+	// -----------------------------------------------------------------------------
+	namespace SSE
+	{
+		void MergeOpacity(float* pixels, const float* opacityPixels, size_t pixelCount)
+		{
+			const __m128 alphaMask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+
+			for (size_t i = 0; i < pixelCount; i++)
+			{
+				__m128 pixel = _mm_loadu_ps(pixels + i * ComponentCount);
+				__m128 opacity = _mm_loadu_ps(opacityPixels + i * ComponentCount);
+				__m128 alpha = _mm_shuffle_ps(opacity, opacity, _MM_SHUFFLE(0, 0, 0, 0));
+
+				pixel = _mm_or_ps(_mm_andnot_ps(alphaMask, pixel), _mm_and_ps(alphaMask, alpha));
+				_mm_storeu_ps(pixels + i * ComponentCount, pixel);
+			}
+		}
+	}
+
+	// AVX2 kernels, two pixels per register
+	// -----------------------------------------------------------------------------
+	namespace AVX2
+	{
+		PIXEL_KERNELS_TARGET_AVX2 void MergeOpacity(float* pixels, const float* opacityPixels, size_t pixelCount)
+		{
+			size_t i = 0;
+			for (; i + 2 <= pixelCount; i += 2)
+			{
+				__m256 pixel = _mm256_loadu_ps(pixels + i * ComponentCount);
+				__m256 opacity = _mm256_loadu_ps(opacityPixels + i * ComponentCount);
+				__m256 alpha = _mm256_permute_ps(opacity, _MM_SHUFFLE(0, 0, 0, 0));
+
+				_mm256_storeu_ps(pixels + i * ComponentCount, _mm256_blend_ps(pixel, alpha, 0x88));
+			}
+
+			SSE::MergeOpacity(pixels + i * ComponentCount, opacityPixels + i * ComponentCount, pixelCount - i);
+		}
+	}
+
+	InstructionSet DetectInstructionSet()
+	{
+		unsigned int regs[4] = { 0, 0, 0, 0 };
+
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		unsigned int maxLeaf = (unsigned int)info[0];
+		if (maxLeaf < 7)
+		{
+			return InstructionSet::SSE;
+		}
+
+		__cpuid(info, 1);
+		unsigned int ecx1 = (unsigned int)info[2];
+		__cpuidex(info, 7, 0);
+		unsigned int ebx7 = (unsigned int)info[1];
+#else
+		if (__get_cpuid_max(0, nullptr) < 7)
+		{
+			return InstructionSet::SSE;
+		}
+
+		__get_cpuid(1, &regs[0], &regs[1], &regs[2], &regs[3]);
+		unsigned int ecx1 = regs[2];
+		__cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+		unsigned int ebx7 = regs[1];
+#endif
+
+		bool osxsave = (ecx1 & (1u << 27)) != 0;
+		bool avx = (ecx1 & (1u << 28)) != 0;
+		bool avx2 = (ebx7 & (1u << 5)) != 0;
+
+		if (!osxsave || !avx || !avx2)
+		{
+			return InstructionSet::SSE;
+		}
+
+		// OS should save YMM registers
+#ifdef _MSC_VER
+		unsigned long long xcr0 = _xgetbv(0);
+#else
+		unsigned int xcr0Low = 0;
+		unsigned int xcr0High = 0;
+		__asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+		unsigned long long xcr0 = xcr0Low;
+#endif
+		return ((xcr0 & 0x6) == 0x6) ? InstructionSet::AVX2 : InstructionSet::SSE;
+	}
+#else
+	InstructionSet DetectInstructionSet()
+	{
+		return InstructionSet::Scalar;
+	}
+#endif
+
+	// Dispatch
+	// -----------------------------------------------------------------------------
+	struct KernelTable
+	{
+		void(*mergeOpacity)(float*, const float*, size_t);
+	};
+
+	KernelTable GetKernelTable(InstructionSet instructionSet)
+	{
+		switch (instructionSet)
+		{
+#ifdef PIXEL_KERNELS_X86
+		case InstructionSet::AVX2:
+			return { AVX2::MergeOpacity };
+		case InstructionSet::SSE:
+			return { SSE::MergeOpacity };
+#endif
+		default:
+			return { Scalar::MergeOpacity };
+		}
+	}
+
+	InstructionSet& CurrentInstructionSet()
+	{
+		static InstructionSet instructionSet = GetSupportedInstructionSet();
+		return instructionSet;
+	}
+
+	KernelTable& CurrentKernels()
+	{
+		static KernelTable kernels = GetKernelTable(CurrentInstructionSet());
+		return kernels;
+	}
+
+	InstructionSet GetSupportedInstructionSet()
+	{
+		static InstructionSet supported = DetectInstructionSet();
+		return supported;
+	}
+
+	InstructionSet GetInstructionSet()
+	{
+		return CurrentInstructionSet();
+	}
+
+	void SetInstructionSet(InstructionSet instructionSet)
+	{
+		instructionSet = std::min(instructionSet, GetSupportedInstructionSet());
+
+		CurrentInstructionSet() = instructionSet;
+		CurrentKernels() = GetKernelTable(instructionSet);
+	}
+
+	// Public kernels
+	// -----------------------------------------------------------------------------
+	void CopyRegion(float* dest, const float* source, unsigned int sourceWidth, unsigned int sourceHeight, const RenderRegion& region)
+	{
+		unsigned int regionWidth = region.getWidth();
+		unsigned int regionHeight = region.getHeight();
+
+		ForEachRow(regionHeight, regionWidth, [&](unsigned int y)
+		{
+			size_t destIndex = (size_t)y * regionWidth;
+			size_t sourceIndex = (size_t)(sourceHeight - (region.top - y) - 1) * sourceWidth + region.left;
+
+			memcpy(dest + destIndex * ComponentCount, source + sourceIndex * ComponentCount, sizeof(float) * ComponentCount * regionWidth);
+		});
+	}
+
+	void FlipRegion(float* dest, const float* source, unsigned int sourceWidth, unsigned int sourceHeight, const RenderRegion& region)
+	{
+		unsigned int destWidth = region.getWidth();
+		unsigned int destHeight = region.getHeight();
+
+		ForEachRow(destHeight, destWidth, [&](unsigned int y)
+		{
+			size_t sourceIndex;
+
+			// Case: region is subarea of bigger buffer
+			if (sourceHeight > destHeight)
+			{
+				sourceIndex = (size_t)(y + sourceHeight - region.top - 1) * sourceWidth + region.left;
+			}
+			// Case: region is the whole buffer
+			else
+			{
+				sourceIndex = (size_t)y * sourceWidth;
+			}
+
+			size_t destIndex = (size_t)(destHeight - y - 1) * destWidth;
+
+			memcpy(dest + destIndex * ComponentCount, source + sourceIndex * ComponentCount, sizeof(float) * ComponentCount * destWidth);
+		});
+	}
+
+	void PasteRegion(float* dest, const float* source, unsigned int destWidth, unsigned int destHeight, const RenderRegion& region)
+	{
+		unsigned int regionWidth = region.getWidth();
+		unsigned int regionHeight = region.getHeight();
+
+		ForEachRow(regionHeight, regionWidth, [&](unsigned int y)
+		{
+			size_t sourceIndex = (size_t)y * regionWidth;
+			size_t destIndex = region.left + (size_t)(y + destHeight - region.top - 1) * destWidth;
+
+			memcpy(dest + destIndex * ComponentCount, source + sourceIndex * ComponentCount, sizeof(float) * ComponentCount * regionWidth);
+		});
+	}
+
+	void MergeOpacity(float* pixels, const float* opacityPixels, size_t pixelCount)
+	{
+		auto kernel = CurrentKernels().mergeOpacity;
+
+		ForEachChunk(pixelCount, [&](size_t first, size_t count)
+		{
+			kernel(pixels + first * ComponentCount, opacityPixels + first * ComponentCount, count);
+		});
+	}
+}
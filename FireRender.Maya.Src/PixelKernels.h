@@ -0,0 +1,51 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include "RenderRegion.h"
+
+#include <cstddef>
+
+/** Per-pixel kernels used on the frame buffer output path.
+	All kernels work on RGBA float pixels (RV_PIXEL layout).
+	SSE and AVX2 versions are selected at runtime, scalar versions are the reference. */
+namespace PixelKernels
+{
+	enum class InstructionSet
+	{
+		Scalar,
+		SSE,
+		AVX2
+	};
+
+	/** Best instruction set supported by the CPU. */
+	InstructionSet GetSupportedInstructionSet();
+
+	/** Instruction set used by the kernels. */
+	InstructionSet GetInstructionSet();
+
+	/** Override instruction set (clamped to the supported one). Is used to compare with the scalar reference. */
+	void SetInstructionSet(InstructionSet instructionSet);
+
+	/** Copy region from the bottom-up source frame buffer into tightly packed dest (FireRenderContext::copyPixels). */
+	void CopyRegion(float* dest, const float* source, unsigned int sourceWidth, unsigned int sourceHeight, const RenderRegion& region);
+
+	/** Copy region from the source buffer into tightly packed dest flipping rows vertically (render view update). */
+	void FlipRegion(float* dest, const float* source, unsigned int sourceWidth, unsigned int sourceHeight, const RenderRegion& region);
+
+	/** Copy tightly packed region into the full frame dest buffer (PixelBuffer::overwrite). */
+	void PasteRegion(float* dest, const float* source, unsigned int destWidth, unsigned int destHeight, const RenderRegion& region);
+
+	/** Set alpha of the pixels to the red channel of the opacity pixels. */
+	void MergeOpacity(float* pixels, const float* opacityPixels, size_t pixelCount);
+}
@@ -1,4 +1,5 @@
 #include "RenderViewUpdater.h"
+#include "PixelKernels.h"
 
 std::vector<RV_PIXEL> RenderViewUpdater::m_pixelData;
 
@@ -16,28 +17,7 @@ void RenderViewUpdater::FlipAndCopyData(
 	unsigned int srcHeight,
 	const RenderRegion& region)
 {
-	//unsigned int dstOffset = 0;
-	unsigned int srcOffset = 0;
-
-	unsigned int dstWidth = region.getWidth();
-	unsigned int dstHeight = region.getHeight();
-
-	for (unsigned int y = 0; y < dstHeight; ++y)
-	{
-		//dstOffset = y * dstWidth;
-		// Case: region is subarea of bigger buffer
-		if (srcHeight > dstHeight)
-		{
-			srcOffset = (y + srcHeight - region.top - 1) * srcWidth + region.left;
-		}
-		// Case: region is the whole buffer
-		else
-		{
-			srcOffset = y * srcWidth;
-		}
-
-		std::copy(&inputPixelData[srcOffset], &inputPixelData[srcOffset + dstWidth], &m_pixelData[(dstHeight - y - 1) * dstWidth]);
-	}
+	PixelKernels::FlipRegion((float*)m_pixelData.data(), (const float*)inputPixelData, srcWidth, srcHeight, region);
 }
 
 void RenderViewUpdater::UpdateAndRefreshRegion(
@@ -37,6 +37,7 @@ bool SkyAttributes::refresh()
 	float sunGlow = m_node.getFloat("sunGlow");
 	float sunDiskSize = m_node.getFloat("sunDiskSize");
 	short sunPositionType = m_node.getShort("sunPositionType");
+	short skyModel = m_node.getShort("skyModel");
 	MColor groundColor = m_node.getColor("groundColor");
 
 	float saturation = m_node.getFloat("saturation");
@@ -68,7 +69,8 @@ bool SkyAttributes::refresh()
 		this->saturation != saturation ||
 		this->horizonHeight != horizonHeight ||
 		this->horizonBlur != horizonBlur ||
-		this->filterColor != filterColor;
+		this->filterColor != filterColor ||
+		this->skyModel != skyModel;
 
 	// If the base sky attributes have not changed,
 	// check if the analytical flag has changed.
@@ -112,6 +114,7 @@ bool SkyAttributes::refresh()
 	this->sunGlow = sunGlow;
 	this->sunDiskSize = sunDiskSize;
 	this->sunPositionType = sunPositionType;
+	this->skyModel = skyModel;
 	this->groundColor = groundColor;
 	this->saturation = saturation;
 	this->horizonHeight = horizonHeight;
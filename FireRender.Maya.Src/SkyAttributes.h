@@ -36,6 +36,7 @@ public:
 	float sunGlow = 0;
 	float sunDiskSize = 0;
 	short sunPositionType = 0;
+	short skyModel = 0;
 	MColor groundColor = MColor::kOpaqueBlack;
 	MColor filterColor = MColor::kOpaqueBlack;
 
@@ -69,6 +70,13 @@ public:
 		kTimeLocation
 	};
 
+	/** The model used for the sky radiance. */
+	enum SkyModel
+	{
+		kLegacySkyModel = 0,
+		kHosekWilkieSkyModel
+	};
+
 
 	// Public Methods
 	// -----------------------------------------------------------------------------
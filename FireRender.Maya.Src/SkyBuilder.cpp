@@ -12,6 +12,7 @@ limitations under the License.
 ********************************************************************/
 #include "SkyBuilder.h"
 #include "SkyGen.h"
+#include "SkyLayers.h"
 #include "SunPosition/SPA.h"
 #include "FireRenderMath.h"
 #include "frWrap.h" // just for SkyBuilder::updateImage
@@ -24,17 +25,13 @@ limitations under the License.
 SkyBuilder::SkyBuilder(const MObject& object, unsigned int imageWidth, unsigned int imageHeight) :
 	m_attributes(object),
 	m_imageWidth(imageWidth),
-	m_imageHeight(imageHeight),
-	m_imageBuffer()
+	m_imageHeight(imageHeight)
 {
 }
 
 // -----------------------------------------------------------------------------
 SkyBuilder::~SkyBuilder()
 {
-	// Delete the image buffer if required.
-	if (m_imageBuffer)
-		m_imageBuffer.reset();
 }
 
 
@@ -43,7 +40,8 @@ SkyBuilder::~SkyBuilder()
 bool SkyBuilder::refresh()
 {
 	// Refresh sky attributes.
-	bool changed = m_attributes.refresh();
+	bool changed = m_attributes.refresh() || m_imageSizeChanged;
+	m_imageSizeChanged = false;
 
 	// Calculate the sun position.
 	calculateSunPosition();
@@ -52,16 +50,34 @@ bool SkyBuilder::refresh()
 }
 
 // -----------------------------------------------------------------------------
-void SkyBuilder::updateImage(frw::Context& context, frw::Image& image)
+bool SkyBuilder::updateImage(frw::Context& context, frw::Image& image)
 {
 	// Create the image.
 	createSkyImage();
 
+	// Don't upload the same image again.
+	if (image && m_uploadedImage == m_image)
+		return false;
+
 	// Update the RPR image.
 	rpr_image_desc imgDesc = {};
 	imgDesc.image_width = m_imageWidth;
 	imgDesc.image_height = m_imageHeight;
-	image = frw::Image(context, { 3, RPR_COMPONENT_TYPE_FLOAT32 }, imgDesc, m_imageBuffer.get());
+	image = frw::Image(context, { 3, RPR_COMPONENT_TYPE_FLOAT32 }, imgDesc, m_image->pixels.data());
+	m_uploadedImage = m_image;
+
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+void SkyBuilder::setImageSize(unsigned int width, unsigned int height)
+{
+	if (width == m_imageWidth && height == m_imageHeight)
+		return;
+
+	m_imageWidth = width;
+	m_imageHeight = height;
+	m_imageSizeChanged = true;
 }
 
 // -----------------------------------------------------------------------------
@@ -87,7 +103,7 @@ void SkyBuilder::updateSampleImage(MImage& image)
 			// Flip the image horizontally using "-offset" so the sun moves in the correct direction.
 			// Source pointer: use (x,y) and apply offset to x
 			unsigned int i = s + (x - offset) % m_imageWidth;
-			const SkyRgbFloat32& src = m_imageBuffer.get()[i];
+			const SkyRgbFloat32& src = m_image->pixels[i];
 
 			*dst++ = static_cast<unsigned int>(fminf(src.b * scale, 255));
 			*dst++ = static_cast<unsigned int>(fminf(src.g * scale, 255));
@@ -244,33 +260,38 @@ void SkyBuilder::adjustDaylightSavingTime(int& hours, int& day, int& month, int&
 // -----------------------------------------------------------------------------
 void SkyBuilder::createSkyImage()
 {
-	// Create the image buffer if necessary.
-	if (!m_imageBuffer)
-		m_imageBuffer = std::make_unique<SkyRgbFloat32[]>(m_imageWidth * m_imageHeight);
-
-	// Initialize the sky generator.
-	SkyGen sg;
-	sg.saturation = m_attributes.saturation;
+	// Collect the generator parameters.
+	SkyImageParams params;
+	params.width = m_imageWidth;
+	params.height = m_imageHeight;
+	params.skyModel = m_attributes.skyModel;
+	params.sunDirection = m_sunDirection;
+	params.turbidity = m_attributes.turbidity;
+	params.saturation = m_attributes.saturation;
+	params.horizonHeight = m_attributes.horizonHeight;
+	params.horizonBlur = m_attributes.horizonBlur;
+	params.sunDiskSize = m_attributes.sunDiskSize;
+	params.sunGlow = m_attributes.sunGlow;
+	params.groundColor = m_attributes.groundColor;
+	params.filterColor = m_attributes.filterColor;
 #ifdef USE_DIRECTIONAL_SKY_LIGHT
-	sg.mSunIntensity = 0.01f;
+	params.sunDiskIntensity = 0.01f;
 #else
-	sg.sun_disk_intensity = 100.0f;
+	params.sunDiskIntensity = 100.0f;
 #endif
-	sg.ground_color = m_attributes.groundColor;
-	sg.horizon_height = m_attributes.horizonHeight;
-	sg.horizon_blur = m_attributes.horizonBlur;
-	sg.sun_disk_scale = m_attributes.sunDiskSize;
-	sg.sun_glow_intensity = m_attributes.sunGlow;
-	sg.multiplier = 1.0;
-	sg.filter_color = m_attributes.filterColor;
-	sg.sun_direction = m_sunDirection;
-	sg.haze = 1.f + m_attributes.turbidity * (9.0f / 50.0f);
-
-
-	// Generate the image.
-	memset(m_imageBuffer.get(), 0, sizeof(SkyRgbFloat32) * m_imageWidth * m_imageHeight);
-	sg.generate(m_imageWidth, m_imageHeight, m_imageBuffer.get());
-
-	SkyColor c = sg.computeColor(sg.sun_direction);
-	m_sunLightColor = c.asColor();
+
+	// Reuse the image if it was generated with the same parameters,
+	// otherwise generate only the layers which have changed.
+	SkyImageCache& cache = SkyImageCache::GetInstance();
+	m_image = cache.Find(params);
+	if (!m_image)
+	{
+		if (!m_layers)
+			m_layers = std::make_unique<SkyLayers>();
+
+		m_image = m_layers->Generate(params);
+		cache.Insert(params, m_image);
+	}
+
+	m_sunLightColor = m_image->sunLightColor;
 }
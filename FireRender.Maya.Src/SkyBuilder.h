@@ -29,7 +29,8 @@ namespace frw
 	class Image;
 }
 
-struct SkyRgbFloat32;
+struct SkyImage;
+class SkyLayers;
 
 /**
  * The sky builder uses the sky dependency node as input
@@ -58,8 +59,11 @@ public:
 	/** Refresh the sky. Return true if it has changed. */
 	bool refresh();
 
-	/** Update an RPR image with the sky. */
-	void updateImage(frw::Context& context, frw::Image& image);
+	/** Update an RPR image with the sky. Return true if a new RPR image was created. */
+	bool updateImage(frw::Context& context, frw::Image& image);
+
+	/** Set the size of the sky image, the next refresh reports a change if it differs. */
+	void setImageSize(unsigned int width, unsigned int height);
 
 	/** Update a Maya sample image with the sky. */
 	void updateSampleImage(MImage& image);
@@ -102,13 +106,22 @@ private:
 
 
 	/** Sky image width. */
-	const unsigned int m_imageWidth;
+	unsigned int m_imageWidth;
 
 	/** Sky image height. */
-	const unsigned int m_imageHeight;
+	unsigned int m_imageHeight;
+
+	/** True if the image size has changed since the last refresh. */
+	bool m_imageSizeChanged = false;
+
+	/** The sky image, it can be shared with other builders through the sky image cache. */
+	std::shared_ptr<const SkyImage> m_image;
+
+	/** The image the RPR image was created from. */
+	std::shared_ptr<const SkyImage> m_uploadedImage;
 
-	/** Storage space for the sky image. */
-	std::unique_ptr<SkyRgbFloat32[]> m_imageBuffer;
+	/** Layers of the last generated image, only the changed ones are generated again. */
+	std::unique_ptr<SkyLayers> m_layers;
 
 	// Private Methods
 	// -----------------------------------------------------------------------------
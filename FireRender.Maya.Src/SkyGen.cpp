@@ -12,12 +12,14 @@ limitations under the License.
 ********************************************************************/
 #include "SkyGen.h"
 
+#include <algorithm>
+
 template<class T> inline T lerp(const T& A, const T& B, float Alpha)
 {
     return A + Alpha * (B-A);
 }
 
-void SkyGen::generate(int w, int h, SkyRgbFloat32 *buffer)
+void SkyGen::adjust_sun_glow()
 {
     // Adjust sun glow value for better appearance.
     // Glow remap table. Pairs of floats. 1st value is sun disk size, 2nd value is minimal
@@ -56,6 +58,11 @@ void SkyGen::generate(int w, int h, SkyRgbFloat32 *buffer)
         }
     }
     sun_glow_intensity_adjusted = lerp(glowMinValue, 100.0f, (float)sun_glow_intensity / 100.0f);
+}
+
+void SkyGen::generate(int w, int h, SkyRgbFloat32 *buffer)
+{
+    adjust_sun_glow();
 
     float nw = 1.0f / float(w);
     float nh = 1.0f / float(h);
@@ -92,3 +99,261 @@ void SkyGen::generate(int w, int h, SkyRgbFloat32 *buffer)
         }
     }
 }
+
+void SkyGen::generateHorizonBlend(int h, std::vector<float>& blend)
+{
+    blend.resize(h);
+
+    Scalar hor_blur = horizon_blur / 10.0;
+    for (int row = 0; row < h; row++)
+    {
+        Scalar downness = row_downness(row, h);
+        if (downness > 0.0)
+        {
+            blend[row] = -1.0f;
+        }
+        else if (hor_blur > 0.0)
+        {
+            blend[row] = float(smoothstep(0.0, 1.0, -downness / hor_blur));
+        }
+        else
+        {
+            blend[row] = 1.0f;
+        }
+    }
+}
+
+void SkyGen::generateAtmosphere(int w, int h, int firstRow, int lastRow, SkyRgbFloat32* buffer)
+{
+    float nw = 1.0f / float(w);
+    float nh = 1.0f / float(h);
+
+    Scalar horiz_height = horizon_height / 10.0;
+    Scalar local_haze = fmax(2.0 + haze, 2.0);
+
+    Point3 sun_dir = sun_direction.Normalize();
+    vectortweak(sun_dir, false, horiz_height);
+
+    // The sky below the horizon fades out with the sun going down
+    Scalar factor = (sun_dir.z < 0.0) ? 1.0 + sun_dir.z : 1.0;
+
+    bool canMirrorSky = (fabs(sun_direction.y) < 0.00001f);
+    int w2 = canMirrorSky ? (w + 1) / 2 : w; // divide by 2 with rounding up
+
+#pragma omp parallel for
+    for (int row = firstRow; row < lastRow; row++)
+    {
+        float phi = float(PI * (h - row - 1) * nh);
+        float sinphi = sin(phi);
+        Scalar scale = (row_downness(row, h) > 0.0) ? GLOBAL_SCALE : GLOBAL_SCALE * factor;
+
+        SkyRgbFloat32* pixels = buffer + size_t(row) * w;
+        for (int j = 0; j < w2; j++)
+        {
+            float theta = float(2.0f * PI * j * nw);
+            Point3 dir(cos(theta) * sinphi, sin(theta) * sinphi, -cos(phi));
+            vectortweak(dir, false, horiz_height);
+            if (dir.z < 0.001)
+            {
+                dir.z = 0.001f;
+                dir = dir.Normalize();
+            }
+
+            SkyColor color = calc_env_color(sun_dir, dir, local_haze) * scale;
+
+            pixels[j].r = static_cast<float>(color.r);
+            pixels[j].g = static_cast<float>(color.g);
+            pixels[j].b = static_cast<float>(color.b);
+
+            if (canMirrorSky)
+            {
+                pixels[w - j - 1] = pixels[j];
+            }
+        }
+    }
+}
+
+void SkyGen::generateSunDisk(int w, int h, std::vector<SkySunPixel>& pixels)
+{
+    pixels.clear();
+
+    if (sun_disk_intensity <= 0.0 || sun_disk_scale <= 0.0)
+    {
+        return;
+    }
+
+    adjust_sun_glow();
+
+    float nw = 1.0f / float(w);
+    float nh = 1.0f / float(h);
+
+    Scalar horiz_height = horizon_height / 10.0;
+    Scalar local_haze = fmax(2.0 + haze, 2.0);
+
+    Point3 sun_dir = sun_direction.Normalize();
+    vectortweak(sun_dir, false, horiz_height);
+
+    SkyColor sun_color = calc_sun_color(sun_dir, local_haze);
+    Scalar sun_radius = 0.00465 * sun_disk_scale * 10.0;
+    Scalar sun_zenith_angle = acos(fmin(1.0, fmax(-1.0, sun_dir.z)));
+
+    bool canMirrorSky = (fabs(sun_direction.y) < 0.00001f);
+    int w2 = canMirrorSky ? (w + 1) / 2 : w; // divide by 2 with rounding up
+
+    for (int row = 0; row < h; row++)
+    {
+        Scalar downness = row_downness(row, h);
+        if (downness <= 0.0)
+        {
+            continue;
+        }
+
+        // All pixels of the row have the same zenith angle, so rows which are farther than the sun radius are skipped.
+        // Directions close to the horizon are clamped, a small margin covers that.
+        Scalar row_zenith_angle = acos(fmin(1.0, fmax(0.001, downness)));
+        if (fabs(row_zenith_angle - sun_zenith_angle) > sun_radius + 0.001)
+        {
+            continue;
+        }
+
+        float phi = float(PI * (h - row - 1) * nh);
+        float sinphi = sin(phi);
+
+        for (int j = 0; j < w2; j++)
+        {
+            float theta = float(2.0f * PI * j * nw);
+            Point3 dir(cos(theta) * sinphi, sin(theta) * sinphi, -cos(phi));
+            vectortweak(dir, false, horiz_height);
+            if (dir.z < 0.001)
+            {
+                dir.z = 0.001f;
+                dir = dir.Normalize();
+            }
+
+            Scalar sunAmount = sun_disk_factor(dir, sun_dir);
+            if (sunAmount <= 0.0)
+            {
+                continue;
+            }
+
+            SkySunPixel pixel;
+            pixel.index = size_t(row) * w + j;
+            pixel.color = sun_color * sunAmount;
+            pixels.push_back(pixel);
+
+            if (canMirrorSky && (w - j - 1) != j)
+            {
+                pixel.index = size_t(row) * w + (w - j - 1);
+                pixels.push_back(pixel);
+            }
+        }
+    }
+
+    std::sort(pixels.begin(), pixels.end());
+}
+
+SkyColor SkyGen::computeGroundColor()
+{
+    Scalar horiz_height = horizon_height / 10.0;
+    Scalar local_haze = fmax(2.0 + haze, 2.0);
+
+    Point3 sun_dir = sun_direction.Normalize();
+    vectortweak(sun_dir, false, horiz_height);
+
+    SkyColor ground = ground_color;
+    ground *= calc_irrad(sun_dir, local_haze) + calc_sun_color(sun_dir, local_haze) * sun_dir.z;
+
+    return ground * GLOBAL_SCALE;
+}
+
+void SkyGen::compose(int w, int h, const SkyRgbFloat32* atmosphere, const std::vector<SkySunPixel>& sunPixels,
+    const SkyColor& groundColor, const std::vector<float>& blend, SkyRgbFloat32* buffer)
+{
+    if (multiplier <= 0.0 || !on)
+    {
+        std::fill(buffer, buffer + size_t(w) * h, SkyRgbFloat32());
+        return;
+    }
+
+    Scalar local_haze = fmax(2.0 + haze, 2.0);
+    Scalar local_saturation = saturation;
+    tweak_saturation(local_saturation, local_haze);
+
+    SkyColor rgb_scale = rgb_unit_conversion;
+    if (rgb_scale.r < 0.0)
+    {
+        rgb_scale.r = rgb_scale.g = rgb_scale.b = 1.0 / 80000.0;
+    }
+    rgb_scale *= multiplier;
+
+#pragma omp parallel for
+    for (int row = 0; row < h; row++)
+    {
+        const size_t rowStart = size_t(row) * w;
+        const Scalar dness = blend[row];
+
+        // Sun pixels are sorted, so the ones of this row are a continuous range
+        SkySunPixel rowStartPixel;
+        rowStartPixel.index = rowStart;
+        auto sunPixel = std::lower_bound(sunPixels.begin(), sunPixels.end(), rowStartPixel);
+
+        for (int j = 0; j < w; j++)
+        {
+            const size_t index = rowStart + j;
+            SkyColor color;
+
+            if (dness < 0.0)
+            {
+                // Upper hemisphere
+                color = SkyColor(atmosphere[index].r, atmosphere[index].g, atmosphere[index].b);
+
+                if (sunPixel != sunPixels.end() && sunPixel->index == index)
+                {
+                    color += sunPixel->color;
+                    ++sunPixel;
+                }
+            }
+            else
+            {
+                // Lower hemisphere
+                if (dness < 1.0)
+                {
+                    color = SkyColor(atmosphere[index].r, atmosphere[index].g, atmosphere[index].b) * (1.0 - dness) + groundColor * dness;
+                }
+                else
+                {
+                    color = groundColor;
+                }
+
+                Scalar night_factor = 1.0 - dness;
+                if (night_factor > 0.0)
+                {
+                    SkyColor night = night_color;
+                    night *= night_factor;
+                    if (color.r < night.r) color.r = night.r;
+                    if (color.g < night.g) color.g = night.g;
+                    if (color.b < night.b) color.b = night.b;
+                }
+            }
+
+            color *= rgb_scale;
+            colortweak(color, local_saturation, filter_color);
+            color.sanitize();
+
+            buffer[index].r = static_cast<float>(color.r);
+            buffer[index].g = static_cast<float>(color.g);
+            buffer[index].b = static_cast<float>(color.b);
+        }
+    }
+}
+
+int SkyGen::atmosphereRowCount(const std::vector<float>& blend)
+{
+    int count = int(blend.size());
+    while (count > 0 && blend[count - 1] >= 1.0f)
+    {
+        count--;
+    }
+
+    return count;
+}
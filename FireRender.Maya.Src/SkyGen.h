@@ -86,6 +86,15 @@ struct SkyColor
 	SkyColor& operator -= (const SkyColor& v) { r -= v.r; g -= v.g; b -= v.b; return *this; }
 };
 
+// Pixel of the sun disk layer, added over the sky before the color adjustments
+struct SkySunPixel
+{
+	size_t index;
+	SkyColor color;
+
+	bool operator < (const SkySunPixel& other) const { return index < other.index; }
+};
+
 
 #ifdef MAYA_PLUGIN
 
@@ -174,7 +183,7 @@ public:
 	Scalar sun_glow_intensity = 1.0;
 	bool y_is_up = false;
 
-private:
+protected:
 
 	Scalar sun_glow_intensity_adjusted;
 
@@ -571,6 +580,64 @@ private:
 		color.b *= 1.0 + filter_color.b;
 	}
 
+	// Brightness of the sun disk and glow in the direction, zero outside of the glow
+	Scalar sun_disk_factor(const Point3& dir, const Point3& sun_dir)
+	{
+		if (sun_disk_intensity <= 0.0 || sun_disk_scale <= 0.0)
+		{
+			return 0.0;
+		}
+
+		Scalar dot = fminf(1, fmaxf(-1, DotProd(dir, sun_dir)));
+		Scalar sun_angle = acos(dot);
+		Scalar sun_radius = 0.00465 * sun_disk_scale * 10.0;
+		if (sun_angle >= sun_radius)
+		{
+			return 0.0;
+		}
+
+		static double glow_scale = 1000.0;
+		static double sun_shift = 6e-6; // offset for making sunAmount(0) == 0
+		static double base_sun_disk_value = 80.0f;
+		static double sun_mul_factor = 500.0;
+		static double p = 2.0;
+		double sun_area_scale = sun_disk_scale * sun_disk_scale;
+		if (sun_area_scale < 0.001) // don't divide by zero
+			sun_area_scale = 0.001;
+		double sun_disk_value = base_sun_disk_value / sun_area_scale; // adjust sun brightness by sun area
+		Scalar x = 1.0 - sun_angle / sun_radius; // sun factor: 1.0 = center, 0.0 = border
+		Scalar sunAmount;
+		if (x < 0.9)
+		{
+			// 0 .. 0.9 is glow
+			x = x / 0.9;
+			sunAmount = (pow(10, 1.0 - log((1.0 - x) * sun_mul_factor)) - sun_shift) * glow_scale * sun_glow_intensity_adjusted;
+			// do not glow brighter than sun
+			if (sunAmount > sun_disk_value) sunAmount = sun_disk_value;
+		}
+		else
+		{
+			// 0.9 .. 1.0 (1/10 of radius) is sun disk - filled with constant color
+			sunAmount = sun_disk_value;
+		}
+		if (sunAmount < 0) sunAmount = 0; // just in case
+		return sunAmount * sun_disk_intensity;
+	}
+
+	// Adjusts sun glow for the sun disk size, has to be called before generating the image
+	void adjust_sun_glow();
+
+	// Direction z of the lat-long image row (counted from the top) after the horizon shift,
+	// it is the same for all pixels of the row
+	Scalar row_downness(int row, int h)
+	{
+		float nh = 1.0f / float(h);
+		float phi = float(PI * (h - row - 1) * nh);
+		Point3 dir(sin(phi), 0.0f, -cos(phi));
+		vectortweak(dir, false, horizon_height / 10.0);
+		return dir.z;
+	}
+
 public:
 	SkyColor computeColor(const Point3 &direction)
 	{
@@ -675,42 +742,7 @@ public:
 				// Sky color
 				SkyColor color = calc_env_color(sun_dir, dir, local_haze) * GLOBAL_SCALE;
 				// Sun color
-				if (sun_disk_intensity > 0.0 && sun_disk_scale > 0.0)
-				{
-					Scalar dot = fminf(1, fmaxf(-1, DotProd(dir, sun_dir)));
-					Scalar sun_angle = acos(dot);
-					Scalar sun_radius = 0.00465 * sun_disk_scale * 10.0;
-					if (sun_angle < sun_radius)
-					{
-						static double glow_scale = 1000.0;
-						static double sun_shift = 6e-6; // offset for making sunAmount(0) == 0
-						static double base_sun_disk_value = 80.0f;
-						static double sun_mul_factor = 500.0;
-						static double p = 2.0;
-						double sun_area_scale = sun_disk_scale * sun_disk_scale;
-						if (sun_area_scale < 0.001) // don't divide by zero
-							sun_area_scale = 0.001;
-						double sun_disk_value = base_sun_disk_value / sun_area_scale; // adjust sun brightness by sun area
-						Scalar x = 1.0 - sun_angle / sun_radius; // sun factor: 1.0 = center, 0.0 = border
-						Scalar sunAmount;
-						if (x < 0.9)
-						{
-							// 0 .. 0.9 is glow
-							x = x / 0.9;
-							sunAmount = (pow(10, 1.0 - log((1.0 - x) * sun_mul_factor)) - sun_shift) * glow_scale * sun_glow_intensity_adjusted;
-							// do not glow brighter than sun
-							if (sunAmount > sun_disk_value) sunAmount = sun_disk_value;
-						}
-						else
-						{
-							// 0.9 .. 1.0 (1/10 of radius) is sun disk - filled with constant color
-							sunAmount = sun_disk_value;
-						}
-						if (sunAmount < 0) sunAmount = 0; // just in case
-						Scalar sun_factor = sunAmount * sun_disk_intensity;
-						color += data_sun_color * sun_factor;
-					}
-				}
+				color += data_sun_color * sun_disk_factor(dir, sun_dir);
 				out_color = color;
 			}
 
@@ -728,4 +760,27 @@ public:
 
 public:
 	void generate(int w, int h, SkyRgbFloat32 *buffer);
+
+	// Layered generation. Parts of the image depend on different parameters, so they are generated separately
+	// and only the layers with changed parameters have to be generated again. Rows are counted from the top
+	// of the lat-long image (the zenith), z axis has to be up.
+
+	// Ground weight per row: negative for the sky rows, 0..1 for the rows below the horizon
+	void generateHorizonBlend(int h, std::vector<float>& blend);
+
+	// Sky color of the rows [firstRow, lastRow) without the sun disk and the color adjustments
+	void generateAtmosphere(int w, int h, int firstRow, int lastRow, SkyRgbFloat32* buffer);
+
+	// Sun disk and glow pixels of the sky rows, sorted by index
+	void generateSunDisk(int w, int h, std::vector<SkySunPixel>& pixels);
+
+	// Color of the ground lit by the sky and the sun
+	SkyColor computeGroundColor();
+
+	// Blends the layers into the final image and applies the color adjustments
+	void compose(int w, int h, const SkyRgbFloat32* atmosphere, const std::vector<SkySunPixel>& sunPixels,
+		const SkyColor& groundColor, const std::vector<float>& blend, SkyRgbFloat32* buffer);
+
+	// Count of the top rows which need the atmosphere layer, rows below are the ground only
+	static int atmosphereRowCount(const std::vector<float>& blend);
 };
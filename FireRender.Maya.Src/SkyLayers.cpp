@@ -0,0 +1,233 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "SkyLayers.h"
+
+#include "HosekSkyGen.h"
+#include "SkyAttributes.h"
+
+namespace
+{
+	// 1024 x 1024 image is 12 MB
+	const size_t MaxCacheSizeInBytes = 256 * 1024 * 1024;
+
+	size_t ImageSizeInBytes(const SkyImage& image)
+	{
+		return sizeof(SkyImage) + image.pixels.size() * sizeof(SkyRgbFloat32);
+	}
+
+	// Parameters each layer depends on
+
+	bool SameSize(const SkyImageParams& a, const SkyImageParams& b)
+	{
+		return a.width == b.width && a.height == b.height;
+	}
+
+	bool SameAtmosphereInputs(const SkyImageParams& a, const SkyImageParams& b)
+	{
+		// Ground albedo is a parameter of the Hosek model
+		bool groundUsed = b.skyModel == SkyAttributes::kHosekWilkieSkyModel;
+
+		return SameSize(a, b) &&
+			a.skyModel == b.skyModel &&
+			a.sunDirection == b.sunDirection &&
+			a.turbidity == b.turbidity &&
+			a.horizonHeight == b.horizonHeight &&
+			(!groundUsed || a.groundColor == b.groundColor);
+	}
+
+	bool SameSunDiskInputs(const SkyImageParams& a, const SkyImageParams& b)
+	{
+		return SameSize(a, b) &&
+			a.sunDirection == b.sunDirection &&
+			a.turbidity == b.turbidity &&
+			a.horizonHeight == b.horizonHeight &&
+			a.sunDiskSize == b.sunDiskSize &&
+			a.sunDiskIntensity == b.sunDiskIntensity &&
+			a.sunGlow == b.sunGlow;
+	}
+
+	bool SameGroundInputs(const SkyImageParams& a, const SkyImageParams& b)
+	{
+		return SameSize(a, b) &&
+			a.skyModel == b.skyModel &&
+			a.sunDirection == b.sunDirection &&
+			a.turbidity == b.turbidity &&
+			a.horizonHeight == b.horizonHeight &&
+			a.groundColor == b.groundColor;
+	}
+
+	bool SameHorizonInputs(const SkyImageParams& a, const SkyImageParams& b)
+	{
+		return SameSize(a, b) &&
+			a.horizonHeight == b.horizonHeight &&
+			a.horizonBlur == b.horizonBlur;
+	}
+}
+
+void SetupSkyGenerator(SkyGen& sg, const SkyImageParams& params)
+{
+	sg.saturation = params.saturation;
+	sg.sun_disk_intensity = params.sunDiskIntensity;
+	sg.ground_color = params.groundColor;
+	sg.horizon_height = params.horizonHeight;
+	sg.horizon_blur = params.horizonBlur;
+	sg.sun_disk_scale = params.sunDiskSize;
+	sg.sun_glow_intensity = params.sunGlow;
+	sg.multiplier = 1.0;
+	sg.filter_color = params.filterColor;
+	sg.sun_direction = params.sunDirection;
+	sg.haze = 1.f + params.turbidity * (9.0f / 50.0f);
+}
+
+bool SkyImageParams::operator==(const SkyImageParams& other) const
+{
+	return SameSize(*this, other) &&
+		skyModel == other.skyModel &&
+		sunDirection == other.sunDirection &&
+		turbidity == other.turbidity &&
+		saturation == other.saturation &&
+		horizonHeight == other.horizonHeight &&
+		horizonBlur == other.horizonBlur &&
+		sunDiskSize == other.sunDiskSize &&
+		sunDiskIntensity == other.sunDiskIntensity &&
+		sunGlow == other.sunGlow &&
+		groundColor == other.groundColor &&
+		filterColor == other.filterColor;
+}
+
+std::shared_ptr<const SkyImage> SkyLayers::Generate(const SkyImageParams& params)
+{
+	// The legacy model is kept for matching older renders.
+	if (params.skyModel == SkyAttributes::kHosekWilkieSkyModel)
+	{
+		HosekSkyGen sg;
+		return Generate(sg, params);
+	}
+	else
+	{
+		SkyGen sg;
+		return Generate(sg, params);
+	}
+}
+
+template <class Generator>
+std::shared_ptr<const SkyImage> SkyLayers::Generate(Generator& sg, const SkyImageParams& params)
+{
+	SetupSkyGenerator(sg, params);
+
+	const int w = params.width;
+	const int h = params.height;
+
+	if (!SameHorizonInputs(m_horizonParams, params))
+	{
+		sg.generateHorizonBlend(h, m_horizonBlend);
+		m_horizonParams = params;
+	}
+
+	// Horizon blur change only needs the rows which weren't generated yet
+	if (!SameAtmosphereInputs(m_atmosphereParams, params))
+	{
+		m_atmosphere.resize(size_t(w) * h);
+		m_atmosphereRows = 0;
+		m_atmosphereParams = params;
+	}
+
+	int atmosphereRows = SkyGen::atmosphereRowCount(m_horizonBlend);
+	if (m_atmosphereRows < atmosphereRows)
+	{
+		sg.generateAtmosphere(w, h, m_atmosphereRows, atmosphereRows, m_atmosphere.data());
+		m_atmosphereRows = atmosphereRows;
+	}
+
+	if (!SameSunDiskInputs(m_sunDiskParams, params))
+	{
+		sg.generateSunDisk(w, h, m_sunDisk);
+		m_sunDiskParams = params;
+	}
+
+	if (!SameGroundInputs(m_groundParams, params))
+	{
+		m_groundColor = sg.computeGroundColor();
+		m_groundParams = params;
+	}
+
+	std::shared_ptr<SkyImage> image = std::make_shared<SkyImage>();
+	image->pixels.resize(size_t(w) * h);
+
+	sg.compose(w, h, m_atmosphere.data(), m_sunDisk, m_groundColor, m_horizonBlend, image->pixels.data());
+
+	SkyColor c = sg.computeColor(sg.sun_direction);
+	image->sunLightColor = c.asColor();
+
+	return image;
+}
+
+SkyImageCache& SkyImageCache::GetInstance()
+{
+	static SkyImageCache instance;
+	return instance;
+}
+
+std::shared_ptr<const SkyImage> SkyImageCache::Find(const SkyImageParams& params)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+	{
+		if (it->params == params)
+		{
+			m_entries.splice(m_entries.begin(), m_entries, it);
+			return m_entries.front().image;
+		}
+	}
+
+	return nullptr;
+}
+
+void SkyImageCache::Insert(const SkyImageParams& params, std::shared_ptr<const SkyImage> image)
+{
+	if (!image)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+	{
+		if (it->params == params)
+		{
+			m_sizeInBytes -= ImageSizeInBytes(*it->image);
+			m_entries.erase(it);
+			break;
+		}
+	}
+
+	m_sizeInBytes += ImageSizeInBytes(*image);
+	m_entries.push_front({ params, image });
+
+	// The newest image is kept even if it doesn't fit
+	while (m_sizeInBytes > MaxCacheSizeInBytes && m_entries.size() > 1)
+	{
+		m_sizeInBytes -= ImageSizeInBytes(*m_entries.back().image);
+		m_entries.pop_back();
+	}
+}
+
+void SkyImageCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	m_entries.clear();
+	m_sizeInBytes = 0;
+}
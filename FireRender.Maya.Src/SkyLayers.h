@@ -0,0 +1,127 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include "SkyGen.h"
+
+#include <maya/MColor.h>
+#include <maya/MFloatVector.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/** Everything the generated sky image depends on. */
+struct SkyImageParams
+{
+	int width = 0;
+	int height = 0;
+
+	short skyModel = 0;
+
+	/** Sun direction in the sky space (z up), sun azimuth is applied by the environment light transform. */
+	MFloatVector sunDirection;
+
+	float turbidity = 0.0f;
+	float saturation = 0.0f;
+	float horizonHeight = 0.0f;
+	float horizonBlur = 0.0f;
+	float sunDiskSize = 0.0f;
+	float sunDiskIntensity = 0.0f;
+	float sunGlow = 0.0f;
+	MColor groundColor = MColor::kOpaqueBlack;
+	MColor filterColor = MColor::kOpaqueBlack;
+
+	bool operator==(const SkyImageParams& other) const;
+};
+
+/** Copy the parameters to the generator fields. */
+void SetupSkyGenerator(SkyGen& sg, const SkyImageParams& params);
+
+/** Generated lat-long sky image. */
+struct SkyImage
+{
+	std::vector<SkyRgbFloat32> pixels;
+
+	/** Color of the sky in the sun direction. */
+	MColor sunLightColor;
+};
+
+/**
+ * Generates the sky image from the layers (see SkyGen): atmosphere, sun disk, ground and horizon blend.
+ * Layers are kept between the calls and only the layers with changed parameters are generated again,
+ * so changing the sun disk, the ground or the color adjustments doesn't evaluate the sky model.
+ */
+class SkyLayers
+{
+public:
+	std::shared_ptr<const SkyImage> Generate(const SkyImageParams& params);
+
+private:
+	template <class Generator>
+	std::shared_ptr<const SkyImage> Generate(Generator& generator, const SkyImageParams& params);
+
+private:
+	/** Parameters the layers were generated with, size is zero until the layer is generated. */
+	SkyImageParams m_atmosphereParams;
+	SkyImageParams m_sunDiskParams;
+	SkyImageParams m_groundParams;
+	SkyImageParams m_horizonParams;
+
+	/** Only the rows above the fully blended ground are generated. */
+	std::vector<SkyRgbFloat32> m_atmosphere;
+	int m_atmosphereRows = 0;
+
+	std::vector<SkySunPixel> m_sunDisk;
+	SkyColor m_groundColor;
+	std::vector<float> m_horizonBlend;
+};
+
+/**
+ * Process wide cache of recently generated sky images, keyed by the generator parameters.
+ * Switching back to previous settings or scrubbing through animated sun positions reuses the images.
+ * Least recently used images are dropped when the cache gets too big.
+ */
+class SkyImageCache
+{
+public:
+	static SkyImageCache& GetInstance();
+
+	SkyImageCache(const SkyImageCache&) = delete;
+	SkyImageCache& operator=(const SkyImageCache&) = delete;
+
+	/** Returns null if there is no image generated with the parameters. */
+	std::shared_ptr<const SkyImage> Find(const SkyImageParams& params);
+
+	void Insert(const SkyImageParams& params, std::shared_ptr<const SkyImage> image);
+
+	void Clear();
+
+private:
+	SkyImageCache() = default;
+
+private:
+	struct Entry
+	{
+		SkyImageParams params;
+		std::shared_ptr<const SkyImage> image;
+	};
+
+	std::mutex m_lock;
+
+	/** Most recently used first. */
+	std::list<Entry> m_entries;
+
+	size_t m_sizeInBytes = 0;
+};
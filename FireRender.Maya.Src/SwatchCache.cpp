@@ -0,0 +1,242 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "SwatchCache.h"
+
+#include <cstdlib>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+	// Should be changed if swatch scene or file layout is changed, so old files are not used
+	const unsigned int CacheFormatVersion = 2;
+
+	const unsigned int FileMagic = 0x48575352; // "RSWH"
+
+	const char* FileExtension = ".rprswatch";
+
+	const size_t DefaultMemoryLimit = 64 * 1024 * 1024;
+
+	struct FileHeader
+	{
+		unsigned int magic;
+		unsigned int version;
+		unsigned int width;
+		unsigned int height;
+		unsigned long long key;
+	};
+}
+
+SwatchCache& SwatchCache::GetInstance()
+{
+	static SwatchCache instance;
+	return instance;
+}
+
+SwatchCache::SwatchCache() :
+	m_memoryUsed(0),
+	m_memoryLimit(DefaultMemoryLimit)
+{
+	if (const char* path = std::getenv("RPR_MAYA_SWATCH_CACHE_PATH"))
+	{
+		m_diskCachePath = path;
+
+		if (!m_diskCachePath.empty() && m_diskCachePath.back() != '/' && m_diskCachePath.back() != '\\')
+		{
+			m_diskCachePath += '/';
+		}
+	}
+}
+
+size_t SwatchCache::GetKey(size_t materialHash, size_t settingsHash, int resolution, int iterationCount)
+{
+	// combine like boost::hash_combine
+	size_t key = materialHash;
+
+	for (size_t value : { settingsHash, (size_t)resolution, (size_t)iterationCount, (size_t)CacheFormatVersion })
+	{
+		key ^= value + 0x9e3779b97f4a7c15ull + (key << 6) + (key >> 2);
+	}
+
+	return key;
+}
+
+bool SwatchCache::Find(size_t key, std::vector<unsigned char>& outPixels, unsigned int& outWidth, unsigned int& outHeight)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	auto it = m_entryByKey.find(key);
+	if (it == m_entryByKey.end())
+	{
+		Entry entry;
+		if (!ReadFile(key, entry))
+		{
+			return false;
+		}
+
+		AddToMemory(std::move(entry));
+		it = m_entryByKey.find(key);
+	}
+	else
+	{
+		// mark as the most recently used
+		m_entries.splice(m_entries.begin(), m_entries, it->second);
+	}
+
+	const Entry& entry = *it->second;
+
+	outPixels = entry.pixels;
+	outWidth = entry.width;
+	outHeight = entry.height;
+
+	return true;
+}
+
+void SwatchCache::Add(size_t key, const unsigned char* pixels, unsigned int width, unsigned int height)
+{
+	if (pixels == nullptr || width == 0 || height == 0)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	if (m_entryByKey.find(key) != m_entryByKey.end())
+	{
+		return;
+	}
+
+	Entry entry;
+	entry.key = key;
+	entry.width = width;
+	entry.height = height;
+	entry.pixels.assign(pixels, pixels + (size_t)width * height * 4);
+
+	WriteFile(entry);
+	AddToMemory(std::move(entry));
+}
+
+void SwatchCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	// files of the previous sessions and the evicted images are removed too
+	if (!m_diskCachePath.empty())
+	{
+		namespace fs = std::filesystem;
+
+		std::error_code errorCode;
+		for (const fs::directory_entry& file : fs::directory_iterator(fs::u8path(m_diskCachePath), errorCode))
+		{
+			if (file.path().extension() == FileExtension)
+			{
+				fs::remove(file.path(), errorCode);
+			}
+		}
+	}
+
+	m_entries.clear();
+	m_entryByKey.clear();
+	m_memoryUsed = 0;
+}
+
+void SwatchCache::SetMemoryLimit(size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	m_memoryLimit = bytes;
+	Evict();
+}
+
+void SwatchCache::AddToMemory(Entry&& entry)
+{
+	m_memoryUsed += entry.pixels.size();
+
+	m_entries.push_front(std::move(entry));
+	m_entryByKey[m_entries.front().key] = m_entries.begin();
+
+	Evict();
+}
+
+void SwatchCache::Evict()
+{
+	// files are kept, evicted images are read from disk again
+	while (m_memoryUsed > m_memoryLimit && !m_entries.empty())
+	{
+		const Entry& entry = m_entries.back();
+
+		m_memoryUsed -= entry.pixels.size();
+		m_entryByKey.erase(entry.key);
+		m_entries.pop_back();
+	}
+}
+
+std::string SwatchCache::GetFilePath(size_t key) const
+{
+	char name[32] = {};
+	snprintf(name, sizeof(name), "%016llx%s", (unsigned long long)key, FileExtension);
+
+	return m_diskCachePath + name;
+}
+
+bool SwatchCache::ReadFile(size_t key, Entry& outEntry) const
+{
+	if (m_diskCachePath.empty())
+	{
+		return false;
+	}
+
+	std::ifstream file(GetFilePath(key), std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+
+	FileHeader header = {};
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+	if (!file || header.magic != FileMagic || header.version != CacheFormatVersion || header.key != key ||
+		header.width == 0 || header.height == 0)
+	{
+		return false;
+	}
+
+	outEntry.key = key;
+	outEntry.width = header.width;
+	outEntry.height = header.height;
+	outEntry.pixels.resize((size_t)header.width * header.height * 4);
+
+	file.read(reinterpret_cast<char*>(outEntry.pixels.data()), outEntry.pixels.size());
+
+	return (bool)file;
+}
+
+void SwatchCache::WriteFile(const Entry& entry) const
+{
+	if (m_diskCachePath.empty())
+	{
+		return;
+	}
+
+	std::ofstream file(GetFilePath(entry.key), std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		return;
+	}
+
+	FileHeader header = { FileMagic, CacheFormatVersion, entry.width, entry.height, (unsigned long long)entry.key };
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(entry.pixels.data()), entry.pixels.size());
+}
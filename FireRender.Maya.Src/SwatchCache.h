@@ -0,0 +1,79 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+/** Rendered swatch images (RGBA, 8 bits per channel) keyed by swatch key:
+	hash of the material network (texture file times included), swatch resolution and swatch render settings.
+	Images are kept in memory (least recently used are evicted above the limit)
+	and, if RPR_MAYA_SWATCH_CACHE_PATH environment variable is set, in that folder,
+	so unchanged materials are not rendered again in the next session. */
+class SwatchCache
+{
+public:
+	static SwatchCache& GetInstance();
+
+	SwatchCache(const SwatchCache&) = delete;
+	SwatchCache& operator=(const SwatchCache&) = delete;
+
+	static size_t GetKey(size_t materialHash, size_t settingsHash, int resolution, int iterationCount);
+
+	/** Copies cached image into outPixels. Returns false if the image is not cached. */
+	bool Find(size_t key, std::vector<unsigned char>& outPixels, unsigned int& outWidth, unsigned int& outHeight);
+
+	void Add(size_t key, const unsigned char* pixels, unsigned int width, unsigned int height);
+
+	/** Clears the cache. All swatch files in the disk cache folder are removed too. */
+	void Clear();
+
+	/** Max amount of memory used by the images. */
+	void SetMemoryLimit(size_t bytes);
+
+private:
+	SwatchCache();
+
+	struct Entry
+	{
+		size_t key;
+		unsigned int width;
+		unsigned int height;
+		std::vector<unsigned char> pixels;
+	};
+
+	typedef std::list<Entry> EntryList;
+
+	void AddToMemory(Entry&& entry);
+	void Evict();
+
+	std::string GetFilePath(size_t key) const;
+	bool ReadFile(size_t key, Entry& outEntry) const;
+	void WriteFile(const Entry& entry) const;
+
+private:
+	std::mutex m_lock;
+
+	// most recently used first
+	EntryList m_entries;
+	std::unordered_map<size_t, EntryList::iterator> m_entryByKey;
+
+	size_t m_memoryUsed;
+	size_t m_memoryLimit;
+
+	// empty if disk cache is disabled
+	std::string m_diskCachePath;
+};
@@ -0,0 +1,355 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "SyncStats.h"
+#include "JsonUtils.h"
+#include "FireRenderObjects.h"
+#include "Context/FireRenderContext.h"
+#include "Logger.h"
+
+#include <maya/MFnDependencyNode.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+
+namespace
+{
+	std::atomic<bool> statsEnabled { false };
+
+	thread_local SyncStats::ObjectSync* currentSync = nullptr;
+	thread_local SyncStats::ImageKeyCapture* currentImageKeyCapture = nullptr;
+
+	const char* RenderTypeName(RenderType renderType)
+	{
+		switch (renderType)
+		{
+		case RenderType::ProductionRender: return "production";
+		case RenderType::IPR: return "ipr";
+		case RenderType::ViewportRender: return "viewport";
+		default: return "other";
+		}
+	}
+
+	uint64_t ImageSizeInBytes(const frw::Image& image)
+	{
+		rpr_image_format format = {};
+		rpr_image_desc desc = {};
+		if (rprImageGetInfo(image.Handle(), RPR_IMAGE_FORMAT, sizeof(format), &format, nullptr) != RPR_SUCCESS ||
+			rprImageGetInfo(image.Handle(), RPR_IMAGE_DESC, sizeof(desc), &desc, nullptr) != RPR_SUCCESS)
+		{
+			return 0;
+		}
+
+		uint64_t componentSize = 0;
+		switch (format.type)
+		{
+		case RPR_COMPONENT_TYPE_UINT8: componentSize = 1; break;
+		case RPR_COMPONENT_TYPE_FLOAT16: componentSize = 2; break;
+		case RPR_COMPONENT_TYPE_FLOAT32: componentSize = 4; break;
+		default: return 0;
+		}
+
+		return uint64_t(desc.image_width) * desc.image_height * std::max<rpr_uint>(desc.image_depth, 1) * format.num_components * componentSize;
+	}
+
+	uint64_t ShapePolygonCount(const frw::Shape& shape)
+	{
+		rpr_shape mesh = static_cast<rpr_shape>(shape.Handle());
+
+		rpr_shape_type type = RPR_SHAPE_TYPE_MESH;
+		if (rprShapeGetInfo(mesh, RPR_SHAPE_TYPE, sizeof(type), &type, nullptr) != RPR_SUCCESS)
+		{
+			return 0;
+		}
+
+		// Instance renders the polygons of its source mesh
+		if (type == RPR_SHAPE_TYPE_INSTANCE &&
+			rprShapeGetInfo(mesh, RPR_INSTANCE_PARENT_SHAPE, sizeof(mesh), &mesh, nullptr) != RPR_SUCCESS)
+		{
+			return 0;
+		}
+
+		size_t count = 0;
+		if (rprMeshGetInfo(mesh, RPR_MESH_POLYGON_COUNT, sizeof(count), &count, nullptr) != RPR_SUCCESS)
+		{
+			return 0;
+		}
+
+		return count;
+	}
+
+	uint64_t ObjectPolygonCount(FireRenderObject& object)
+	{
+		FireRenderMeshCommon* mesh = dynamic_cast<FireRenderMeshCommon*>(&object);
+		if (mesh == nullptr)
+		{
+			return 0;
+		}
+
+		uint64_t count = 0;
+		for (const FrElement& element : mesh->Elements())
+		{
+			if (element.shape)
+			{
+				count += ShapePolygonCount(element.shape);
+			}
+		}
+
+		return count;
+	}
+
+	std::string ObjectName(FireRenderObject& object)
+	{
+		FireRenderNode* node = dynamic_cast<FireRenderNode*>(&object);
+		if (node != nullptr)
+		{
+			MDagPath dagPath = node->DagPath();
+			if (dagPath.isValid())
+			{
+				return dagPath.partialPathName().asUTF8();
+			}
+		}
+
+		return MFnDependencyNode(object.Object()).name().asUTF8();
+	}
+}
+
+SyncStats::ObjectSync::ObjectSync(FireRenderObject& object, bool completesSync) :
+	m_object(nullptr),
+	m_completesSync(completesSync),
+	m_previous(nullptr)
+{
+	if (!IsEnabled())
+	{
+		return;
+	}
+
+	// Swatches aren't part of the scene
+	const FireRenderContext* context = object.context();
+	if (context == nullptr || context->GetRenderType() == RenderType::Thumbnail || context->GetRenderType() == RenderType::Undefined)
+	{
+		return;
+	}
+
+	m_object = &object;
+	m_previous = currentSync;
+	m_start = std::chrono::steady_clock::now();
+	currentSync = this;
+}
+
+SyncStats::ObjectSync::~ObjectSync()
+{
+	if (m_object == nullptr)
+	{
+		return;
+	}
+
+	currentSync = m_previous;
+
+	double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+	SyncStats::GetInstance().Record(*this, elapsedMs);
+}
+
+SyncStats::ImageKeyCapture::ImageKeyCapture() :
+	m_previous(currentImageKeyCapture)
+{
+	currentImageKeyCapture = this;
+}
+
+SyncStats::ImageKeyCapture::~ImageKeyCapture()
+{
+	currentImageKeyCapture = m_previous;
+
+	if (m_previous != nullptr)
+	{
+		m_previous->m_keys.insert(m_previous->m_keys.end(), m_keys.begin(), m_keys.end());
+	}
+}
+
+SyncStats& SyncStats::GetInstance()
+{
+	static SyncStats instance;
+	return instance;
+}
+
+void SyncStats::SetEnabled(bool enabled)
+{
+	statsEnabled.store(enabled);
+}
+
+bool SyncStats::IsEnabled()
+{
+	return statsEnabled.load(std::memory_order_relaxed);
+}
+
+void SyncStats::EnableFromEnvironment()
+{
+	const char* value = std::getenv("RPR_MAYA_SYNC_STATS");
+	if (value != nullptr && std::atoi(value) != 0)
+	{
+		SetEnabled(true);
+	}
+}
+
+void SyncStats::AddImage(const std::string& key, const frw::Image& image)
+{
+	if (!image)
+	{
+		return;
+	}
+
+	// Keys are captured even with the statistics disabled, shaders cached meanwhile are attributed their images later
+	ImageKeyCapture* capture = currentImageKeyCapture;
+	if (capture != nullptr && std::find(capture->m_keys.begin(), capture->m_keys.end(), key) == capture->m_keys.end())
+	{
+		capture->m_keys.push_back(key);
+	}
+
+	ObjectSync* sync = currentSync;
+	if (sync == nullptr)
+	{
+		return;
+	}
+
+	auto sameKey = [&key](const std::pair<std::string, uint64_t>& item) { return item.first == key; };
+	if (std::find_if(sync->m_images.begin(), sync->m_images.end(), sameKey) == sync->m_images.end())
+	{
+		sync->m_images.emplace_back(key, ImageSizeInBytes(image));
+	}
+}
+
+void SyncStats::Record(ObjectSync& sync, double elapsedMs)
+{
+	FireRenderObject& object = *sync.m_object;
+	RenderType renderType = object.context()->GetRenderType();
+
+	// Maya and RPR are queried before locking
+	std::string name;
+	std::string nodeType;
+	uint64_t triangleCount = 0;
+	if (sync.m_completesSync)
+	{
+		name = ObjectName(object);
+		nodeType = MFnDependencyNode(object.Object()).typeName().asUTF8();
+		triangleCount = ObjectPolygonCount(object);
+	}
+
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	Entry& entry = m_entries[std::make_pair(int(renderType), object.uuid())];
+	entry.stats.totalSyncMs += elapsedMs;
+
+	// Images are counted once per object, whichever sync has requested them
+	for (const auto& image : sync.m_images)
+	{
+		if (entry.imageKeys.insert(image.first).second)
+		{
+			entry.stats.textureBytes += image.second;
+		}
+	}
+
+	if (!sync.m_completesSync)
+	{
+		entry.pendingMs += elapsedMs;
+		return;
+	}
+
+	entry.stats.name = name;
+	entry.stats.nodeType = nodeType;
+	entry.stats.renderType = RenderTypeName(renderType);
+	entry.stats.lastSyncMs = entry.pendingMs + elapsedMs;
+	entry.stats.triangleCount = triangleCount;
+	entry.stats.syncCount++;
+	entry.pendingMs = 0.0;
+}
+
+std::vector<ObjectSyncStats> SyncStats::GetStats(SortKey sortKey) const
+{
+	std::vector<ObjectSyncStats> result;
+
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+
+		result.reserve(m_entries.size());
+		for (const auto& it : m_entries)
+		{
+			// Reloaded but not synced yet
+			if (it.second.stats.syncCount > 0)
+			{
+				result.push_back(it.second.stats);
+			}
+		}
+	}
+
+	auto compare = [sortKey](const ObjectSyncStats& a, const ObjectSyncStats& b)
+	{
+		switch (sortKey)
+		{
+		case SortKey::LastTime: return a.lastSyncMs > b.lastSyncMs;
+		case SortKey::Triangles: return a.triangleCount > b.triangleCount;
+		case SortKey::TextureBytes: return a.textureBytes > b.textureBytes;
+		case SortKey::SyncCount: return a.syncCount > b.syncCount;
+		case SortKey::Name: return a.name < b.name;
+		default: return a.totalSyncMs > b.totalSyncMs;
+		}
+	};
+
+	std::stable_sort(result.begin(), result.end(), compare);
+
+	return result;
+}
+
+bool SyncStats::WriteJson(const std::string& path) const
+{
+	std::vector<ObjectSyncStats> stats = GetStats(SortKey::TotalTime);
+
+	std::ofstream out(path, std::ios::out | std::ios::trunc);
+	if (!out)
+	{
+		ErrorPrint("Unable to write sync statistics %s", path.c_str());
+		return false;
+	}
+
+	out << "[";
+
+	for (size_t idx = 0; idx < stats.size(); ++idx)
+	{
+		const ObjectSyncStats& row = stats[idx];
+
+		out << (idx > 0 ? ",\n" : "\n") << "{\"name\":";
+		WriteJsonString(out, row.name);
+		out << ",\"nodeType\":";
+		WriteJsonString(out, row.nodeType);
+		out << ",\"renderType\":";
+		WriteJsonString(out, row.renderType);
+		out << ",\"lastSyncMs\":" << row.lastSyncMs
+			<< ",\"totalSyncMs\":" << row.totalSyncMs
+			<< ",\"triangles\":" << row.triangleCount
+			<< ",\"textureBytes\":" << row.textureBytes
+			<< ",\"syncCount\":" << row.syncCount << "}";
+	}
+
+	out << "\n]\n";
+
+	LogPrint("Sync statistics of %zu objects written to %s", stats.size(), path.c_str());
+
+	return true;
+}
+
+void SyncStats::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	m_entries.clear();
+}
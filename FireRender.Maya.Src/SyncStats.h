@@ -0,0 +1,167 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+class FireRenderObject;
+
+namespace frw
+{
+	class Image;
+}
+
+/** Translation cost of a scene object in one render context type. */
+struct ObjectSyncStats
+{
+	/** Partial dag path of the dag nodes, node name otherwise. */
+	std::string name;
+
+	/** Maya node type, i.e. mesh or gpuCache. */
+	std::string nodeType;
+
+	/** production, ipr or viewport. */
+	std::string renderType;
+
+	/** Wall time of the last sync including the mesh reload before it. */
+	double lastSyncMs = 0.0;
+	double totalSyncMs = 0.0;
+
+	/** Polygons of the RPR shapes (meshes are triangulated by the translator), instances count their source shape. */
+	uint64_t triangleCount = 0;
+
+	/** Size of the distinct images used by the object during the session. */
+	uint64_t textureBytes = 0;
+
+	unsigned int syncCount = 0;
+};
+
+/**
+ * Per object translation statistics of FireRenderContext::Freshen (the initial scene build included),
+ * used to find the objects which make the scene slow to translate.
+ * Collected while enabled by "fireRender -syncStatsEnabled true" or the RPR_MAYA_SYNC_STATS=1 environment variable,
+ * otherwise a sync costs an atomic load.
+ * Is queried by "fireRender -syncStats" and written by "fireRender -syncStatsJson <path>".
+ */
+class SyncStats
+{
+public:
+	enum class SortKey
+	{
+		TotalTime,
+		LastTime,
+		Triangles,
+		TextureBytes,
+		SyncCount,
+		Name,
+	};
+
+	static SyncStats& GetInstance();
+
+	static void SetEnabled(bool enabled);
+	static bool IsEnabled();
+
+	/** Enable the statistics if it is requested by the environment variable. */
+	static void EnableFromEnvironment();
+
+	SyncStats(const SyncStats&) = delete;
+	SyncStats& operator=(const SyncStats&) = delete;
+
+	/**
+	 * Measures the translation of the object till the end of the scope. Images requested on the calling thread
+	 * meanwhile are attributed to the object. The mesh reload is measured with completesSync = false,
+	 * its time is added to the following sync.
+	 */
+	class ObjectSync
+	{
+	public:
+		ObjectSync(FireRenderObject& object, bool completesSync);
+		~ObjectSync();
+
+		ObjectSync(const ObjectSync&) = delete;
+		ObjectSync& operator=(const ObjectSync&) = delete;
+
+	private:
+		friend class SyncStats;
+
+		FireRenderObject* m_object;
+		bool m_completesSync;
+		ObjectSync* m_previous;
+
+		std::chrono::steady_clock::time_point m_start;
+
+		/** Image cache keys and sizes, a sync uses few images. Doesn't allocate while the statistics are disabled. */
+		std::vector<std::pair<std::string, uint64_t>> m_images;
+	};
+
+	/**
+	 * Collects the keys of the images requested on the calling thread till the end of the scope,
+	 * so that the objects getting a cached shader can be attributed its images. Nested scopes pass the keys to the outer one.
+	 */
+	class ImageKeyCapture
+	{
+	public:
+		ImageKeyCapture();
+		~ImageKeyCapture();
+
+		ImageKeyCapture(const ImageKeyCapture&) = delete;
+		ImageKeyCapture& operator=(const ImageKeyCapture&) = delete;
+
+		const std::vector<std::string>& GetKeys() const { return m_keys; }
+
+	private:
+		friend class SyncStats;
+
+		ImageKeyCapture* m_previous;
+		std::vector<std::string> m_keys;
+	};
+
+	/** Attribute the image to the object which is synced on the calling thread, if any. */
+	static void AddImage(const std::string& key, const frw::Image& image);
+
+	/** Largest first, except the name which is ascending. */
+	std::vector<ObjectSyncStats> GetStats(SortKey sortKey) const;
+
+	/** Write the statistics sorted by the total time as a JSON array. */
+	bool WriteJson(const std::string& path) const;
+
+	void Clear();
+
+private:
+	SyncStats() = default;
+
+	void Record(ObjectSync& sync, double elapsedMs);
+
+private:
+	struct Entry
+	{
+		ObjectSyncStats stats;
+
+		/** Reload time waiting for the sync. */
+		double pendingMs = 0.0;
+
+		std::unordered_set<std::string> imageKeys;
+	};
+
+	mutable std::mutex m_lock;
+
+	/** Keyed by the render type and the object uuid. */
+	std::map<std::pair<int, std::string>, Entry> m_entries;
+};
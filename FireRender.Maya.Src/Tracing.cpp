@@ -0,0 +1,281 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Tracing.h"
+#include "JsonUtils.h"
+#include "Logger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Tracing
+{
+	namespace Detail
+	{
+		std::atomic<bool> enabled { false };
+	}
+}
+
+namespace
+{
+	struct Event
+	{
+		const char* name;
+		std::string detail;
+		uint64_t start;
+		uint64_t end;
+	};
+
+	struct ThreadBuffer
+	{
+		uint32_t id = 0;
+
+		std::mutex mutex;
+		std::string name;
+		std::vector<Event> events;
+	};
+
+	struct FrameMarker
+	{
+		int frame;
+		uint64_t time;
+	};
+
+	class TraceState
+	{
+	public:
+		static TraceState& Instance()
+		{
+			static TraceState instance;
+			return instance;
+		}
+
+		std::shared_ptr<ThreadBuffer> RegisterThread()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			std::shared_ptr<ThreadBuffer> buffer = std::make_shared<ThreadBuffer>();
+			buffer->id = uint32_t(m_threads.size() + 1);
+			buffer->name = "Thread " + std::to_string(buffer->id);
+
+			// Buffers of the finished threads are kept, so their zones are written
+			m_threads.push_back(buffer);
+
+			return buffer;
+		}
+
+		void Start(const std::string& path, bool perFrame)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			for (const auto& thread : m_threads)
+			{
+				std::lock_guard<std::mutex> threadLock(thread->mutex);
+				thread->events.clear();
+			}
+
+			m_frameMarkers.clear();
+			m_path = path;
+			m_perFrame = perFrame;
+			m_sessionStart = Tracing::Detail::Now();
+
+			Tracing::Detail::enabled = true;
+
+			LogPrint("Timeline tracing started: %s%s", path.c_str(), perFrame ? " (per frame)" : "");
+		}
+
+		void Stop()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (!Tracing::Detail::enabled.exchange(false))
+			{
+				return;
+			}
+
+			Write(m_path);
+		}
+
+		void EndFrame(int frame)
+		{
+			if (!Tracing::IsEnabled())
+			{
+				return;
+			}
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			m_frameMarkers.push_back({ frame, Tracing::Detail::Now() });
+
+			if (m_perFrame)
+			{
+				Write(FramePath(frame));
+			}
+		}
+
+	private:
+		TraceState() = default;
+
+		/** <path>.<frame>.json, the frame number is inserted before the json extension. */
+		std::string FramePath(int frame) const
+		{
+			char frameStr[32];
+			snprintf(frameStr, sizeof(frameStr), ".%04d", frame);
+
+			const std::string extension = ".json";
+			if (m_path.size() > extension.size() && m_path.compare(m_path.size() - extension.size(), extension.size(), extension) == 0)
+			{
+				return m_path.substr(0, m_path.size() - extension.size()) + frameStr + extension;
+			}
+
+			return m_path + frameStr + extension;
+		}
+
+		/** Write the recorded zones and clear them. Is called with m_mutex locked. */
+		void Write(const std::string& path)
+		{
+			std::ofstream out(path, std::ios::out | std::ios::trunc);
+			if (!out)
+			{
+				ErrorPrint("Unable to write timeline trace %s", path.c_str());
+				return;
+			}
+
+			size_t eventCount = 0;
+
+			out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+			out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Radeon ProRender for Maya\"}}";
+
+			for (const auto& thread : m_threads)
+			{
+				std::vector<Event> events;
+				std::string name;
+				{
+					std::lock_guard<std::mutex> threadLock(thread->mutex);
+					events.swap(thread->events);
+					name = thread->name;
+				}
+
+				out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->id << ",\"args\":{\"name\":";
+				WriteJsonString(out, name);
+				out << "}}";
+
+				for (const Event& event : events)
+				{
+					// Zones of the previous session which were still open on start
+					if (event.start < m_sessionStart)
+					{
+						continue;
+					}
+
+					out << ",\n{\"name\":";
+					WriteJsonString(out, event.name);
+					out << ",\"cat\":\"rpr\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->id
+						<< ",\"ts\":" << (event.start - m_sessionStart)
+						<< ",\"dur\":" << (event.end - event.start);
+
+					if (!event.detail.empty())
+					{
+						out << ",\"args\":{\"detail\":";
+						WriteJsonString(out, event.detail);
+						out << "}";
+					}
+
+					out << "}";
+
+					eventCount++;
+				}
+			}
+
+			for (const FrameMarker& marker : m_frameMarkers)
+			{
+				out << ",\n{\"name\":\"Frame " << marker.frame << "\",\"cat\":\"rpr\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":"
+					<< (marker.time - m_sessionStart) << "}";
+			}
+
+			m_frameMarkers.clear();
+
+			out << "\n]}\n";
+
+			LogPrint("Timeline trace with %zu zones written to %s", eventCount, path.c_str());
+		}
+
+	private:
+		std::mutex m_mutex;
+		std::vector<std::shared_ptr<ThreadBuffer>> m_threads;
+		std::vector<FrameMarker> m_frameMarkers;
+
+		std::string m_path;
+		bool m_perFrame = false;
+		uint64_t m_sessionStart = 0;
+	};
+
+	ThreadBuffer& CurrentThreadBuffer()
+	{
+		thread_local std::shared_ptr<ThreadBuffer> buffer = TraceState::Instance().RegisterThread();
+		return *buffer;
+	}
+}
+
+uint64_t Tracing::Detail::Now()
+{
+	return (uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracing::Detail::AddZone(const char* name, std::string&& detail, uint64_t start, uint64_t end)
+{
+	ThreadBuffer& buffer = CurrentThreadBuffer();
+
+	// Only the writer competes for the mutex
+	std::lock_guard<std::mutex> lock(buffer.mutex);
+	buffer.events.push_back({ name, std::move(detail), start, end });
+}
+
+void Tracing::Start(const std::string& path, bool perFrame)
+{
+	TraceState::Instance().Start(path, perFrame);
+}
+
+void Tracing::Stop()
+{
+	TraceState::Instance().Stop();
+}
+
+void Tracing::StartFromEnvironment()
+{
+	const char* path = std::getenv("RPR_MAYA_TIMELINE_PATH");
+	if (path == nullptr || path[0] == '\0')
+	{
+		return;
+	}
+
+	const char* perFrame = std::getenv("RPR_MAYA_TIMELINE_PER_FRAME");
+	Start(path, perFrame != nullptr && std::atoi(perFrame) != 0);
+}
+
+void Tracing::EndFrame(int frame)
+{
+	TraceState::Instance().EndFrame(frame);
+}
+
+void Tracing::SetThreadName(const char* name)
+{
+	ThreadBuffer& buffer = CurrentThreadBuffer();
+
+	std::lock_guard<std::mutex> lock(buffer.mutex);
+	buffer.name = name;
+}
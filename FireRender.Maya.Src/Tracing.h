@@ -0,0 +1,97 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * Timeline of the sync and render phases written as Chrome trace JSON
+ * (open it in chrome://tracing or ui.perfetto.dev).
+ *
+ * Tracing is started by the RPR_MAYA_TIMELINE_PATH environment variable or by "fireRender -timeline <path>".
+ * Zones are recorded into per thread buffers and written either once per session (on stop)
+ * or once per rendered frame (RPR_MAYA_TIMELINE_PER_FRAME=1 or "fireRender -timelinePerFrame true").
+ * When tracing is off a zone costs a relaxed atomic load.
+ */
+namespace Tracing
+{
+	namespace Detail
+	{
+		extern std::atomic<bool> enabled;
+
+		/** Microseconds of the steady clock. */
+		uint64_t Now();
+
+		void AddZone(const char* name, std::string&& detail, uint64_t start, uint64_t end);
+	}
+
+	inline bool IsEnabled()
+	{
+		return Detail::enabled.load(std::memory_order_relaxed);
+	}
+
+	/** Start a new session, the recorded zones of the previous one are dropped. */
+	void Start(const std::string& path, bool perFrame);
+
+	/** Stop the session and write the zones which weren't written yet. */
+	void Stop();
+
+	/** Start the session if it is requested by the environment variables. */
+	void StartFromEnvironment();
+
+	/** Mark the end of the rendered frame. In the per frame mode the zones recorded so far are written to <path>.<frame>.json. */
+	void EndFrame(int frame);
+
+	/** Name of the calling thread in the timeline. */
+	void SetThreadName(const char* name);
+
+	/** Scoped zone. The name must be a string literal, the detail (object name, file path) is copied. */
+	class Zone
+	{
+	public:
+		explicit Zone(const char* name) :
+			m_name(IsEnabled() ? name : nullptr),
+			m_start(m_name ? Detail::Now() : 0)
+		{
+		}
+
+		~Zone()
+		{
+			if (m_name)
+			{
+				Detail::AddZone(m_name, std::move(m_detail), m_start, Detail::Now());
+			}
+		}
+
+		Zone(const Zone&) = delete;
+		Zone& operator=(const Zone&) = delete;
+
+		/** True if the zone is recorded, check it before computing the detail. */
+		bool IsActive() const { return m_name != nullptr; }
+
+		void SetDetail(std::string detail) { m_detail = std::move(detail); }
+
+	private:
+		const char* m_name;
+		uint64_t m_start;
+		std::string m_detail;
+	};
+}
+
+#define RPR_TRACE_CONCAT_IMPL(a, b) a##b
+#define RPR_TRACE_CONCAT(a, b) RPR_TRACE_CONCAT_IMPL(a, b)
+
+/** Zone till the end of the scope. */
+#define RPR_TRACE_ZONE(name) Tracing::Zone RPR_TRACE_CONCAT(traceZone, __LINE__)(name)
@@ -349,7 +349,45 @@ namespace FireMaya
 
 	}
 
-	bool translateLight(FrLight& frlight, Scope& scope, frw::Context frcontext, const MObject& object, const MMatrix& matrix, bool update)
+	void ReadLightData(PhysicalLightData& lightData, const MObject& object, Scope& scope, std::map<size_t, PhysicalLightData>* lightDataBatch)
+	{
+		MFnDependencyNode depNode(object);
+
+		if (depNode.typeId() != FireMaya::TypeId::FireRenderPhysicalLightLocator)
+		{
+			FillLightData(lightData, object, scope);
+			return;
+		}
+
+		size_t colorInputHash = FireRenderObject::GetUpstreamHash(depNode.findPlug(PhysicalLightAttributes::colorPicker, false));
+
+		// Lights with identical attributes and color inputs read the data once per batch
+		HashValue key;
+
+		if (lightDataBatch != nullptr)
+		{
+			key = FireRenderObject::GetAttributesHash(object);
+			key << colorInputHash;
+
+			auto it = lightDataBatch->find(key);
+			if (it != lightDataBatch->end())
+			{
+				lightData = it->second;
+				return;
+			}
+		}
+
+		FillLightData(lightData, object, scope);
+		lightData.colorInputHash = colorInputHash;
+
+		if (lightDataBatch != nullptr)
+		{
+			(*lightDataBatch)[key] = lightData;
+		}
+	}
+
+	bool translateLight(FrLight& frlight, Scope& scope, frw::Context frcontext, const MObject& object, const MMatrix& matrix, bool update,
+		std::map<size_t, PhysicalLightData>* lightDataBatch)
 	{
 		rpr_int frstatus;
 		MStatus mstatus;
@@ -367,7 +405,7 @@ namespace FireMaya
 		}
 
 		PhysicalLightData lightData;
-		FillLightData(lightData, object, scope);
+		ReadLightData(lightData, object, scope, lightDataBatch);
 
 		if (!lightData.enabled)
 		{
@@ -633,15 +671,20 @@ namespace FireMaya
 		else
 		{
             frw::MaterialSystem matSys = scope.MaterialSystem();
-			if (!frlight.emissive)
-				frlight.emissive = frw::EmissiveShader(matSys);
-
 			if (!frlight.transparent)
 				frlight.transparent = frw::EmissiveShader(matSys);
 
 			if (areaLightData.areaLightShape != PLAMesh)
 			{
-				frlight.areaLight = PhysicalLightGeometryUtility::CreateShapeForAreaLight(areaLightData.areaLightShape, frcontext);
+				// Area lights of the same shape are instances of one mesh, they differ by transform and shader only
+				frw::Shape prototype = scope.GetCachedAreaLightShape(areaLightData.areaLightShape);
+				if (!prototype)
+				{
+					prototype = PhysicalLightGeometryUtility::CreateShapeForAreaLight(areaLightData.areaLightShape, frcontext);
+					scope.SetCachedAreaLightShape(areaLightData.areaLightShape, prototype);
+				}
+
+				frlight.areaLight = prototype.CreateInstance(frcontext);
 				calculatedArea = PhysicalLightGeometryUtility::GetAreaOfMeshPrimitive(areaLightData.areaLightShape, transformMatrix);
 			}
 			else
@@ -668,7 +711,6 @@ namespace FireMaya
 				calculatedArea = PhysicalLightGeometryUtility::GetAreaOfMesh(shapeDagPath.node(), transformMatrix);
 			}
 
-			frlight.areaLight.SetShader(frlight.emissive);
 			frlight.areaLight.SetAreaLightFlag(true);
 			frlight.isAreaLight = true;
 		}
@@ -679,11 +721,10 @@ namespace FireMaya
 			ScaleMatrixFromCmToMFloats(transformMatrix, matrixfloats);
 
 			frlight.areaLight.SetTransform((rpr_float*)matrixfloats);
-			if (frlight.emissive)
-			{
-				frlight.emissive.SetValue(RPR_MATERIAL_INPUT_COLOR,
-					areaLightData.resultFrwColor * areaLightData.GetCalculatedIntensity(calculatedArea));
-			}
+
+			// Lights with the same emission share the shader, so it is replaced instead of being modified
+			frlight.emissive = scope.GetEmissiveShader(areaLightData.resultFrwColor, areaLightData.GetCalculatedIntensity(calculatedArea), areaLightData.colorInputHash);
+			frlight.areaLight.SetShader(frlight.emissive);
 
 			bool shapeVisibility = false;
 			MPlug shapeVisibilityPlug = depNode.findPlug("primaryVisibility");
@@ -789,7 +830,8 @@ namespace FireMaya
 		if (!update)
 			frlight = frcontext.CreateEnvironmentLight();
 
-		if (frImage)
+		// Setting the image rebuilds the light's importance sampling data, so it's skipped for the same image
+		if (frImage && !(frImage == frlight.GetImage()))
 			frlight.SetImage(frImage);
 
 		frlight.SetLightIntensityScale(intensity);
@@ -1086,10 +1128,9 @@ namespace FireMaya
 		}
 
 		// Update the sky image.
-		if (skyBuilder.refresh())
+		// Setting the image rebuilds the light's importance sampling data, so it's done only for a new image.
+		if (skyBuilder.refresh() && (skyBuilder.updateImage(frcontext, frImage) || !update))
 		{
-			skyBuilder.updateImage(frcontext, frImage);
-
 			// Update the environment light image.
 			envLight.SetImage(frImage);
 		}
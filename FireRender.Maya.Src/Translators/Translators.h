@@ -23,6 +23,7 @@ limitations under the License.
 #include <maya/MObjectArray.h>
 #include <maya/MFnNurbsSurface.h>
 #include <cassert>
+#include <map>
 #include <vector>
 
 #define CM_2_M 0.01
@@ -114,7 +115,9 @@ namespace FireMaya
 	bool getInputColorConnection(const MPlug& colorPlug, MPlug& connectedPlug);
 
 	bool translateCamera(frw::Camera& frcamera, const MObject& camera, const MMatrix& matrix, bool isRenderView, float aspectRatio = 0.0, bool useAspectRatio = false, int cameraType = 0);
-	bool translateLight(FrLight& frlight, Scope& scope, frw::Context frcontext, const MObject& object, const MMatrix& matrix, bool update = false);
+	// Light data of physical lights is shared by lights with identical attributes if the batch is passed
+	bool translateLight(FrLight& frlight, Scope& scope, frw::Context frcontext, const MObject& object, const MMatrix& matrix, bool update = false,
+		std::map<size_t, PhysicalLightData>* lightDataBatch = nullptr);
 
 	bool translateAreaLightInternal(FrLight& frlight, Scope& scope, frw::Context frcontext, const MObject& object,
 											const MMatrix& matrix, const MDagPath& dagPath, const PhysicalLightData& areaLightData, bool update);
@@ -129,6 +132,7 @@ namespace FireMaya
 	void ScaleMatrixFromCmToM(MMatrix& matrix);
 
 	void FillLightData(PhysicalLightData& physicalLightData, const MObject& object, Scope& scope);
+	void ReadLightData(PhysicalLightData& lightData, const MObject& object, Scope& scope, std::map<size_t, PhysicalLightData>* lightDataBatch);
 
 	void GetMatrixForTheNextFrame(const MFnDependencyNode& nodeFn, float matrixFloats[4][4], unsigned int dagPathIndex = 0);
 	void CalculateMotionBlurParams(const MFnDependencyNode& nodeFn, 
@@ -21,8 +21,7 @@ limitations under the License.
 #include "Translators/Translators.h"
 #include <functional>
 
-#include "IESLight/IESprocessor.h"
-#include "IESLight/IESLightRepresentationCalc.h"
+#include "Lights/IES/IESProfileCache.h"
 
 
 namespace FireMaya
@@ -710,15 +709,15 @@ namespace FireMaya
 			else
 			{
 				auto iesFile = data.filePath;
-				IESProcessor processor;
-				IESLightRepresentationParams params;
 
-				if (iesFile.length() && 
-					processor.Parse(params.data, iesFile.asWChar()) == IESProcessor::ErrorCode::SUCCESS)
+				// Profile is parsed once and shared by all lights using the file
+				std::shared_ptr<const IESProfile> profile = IESProfileCache::GetInstance().GetProfile(iesFile);
+
+				if (iesFile.length() && profile->parsed)
 				{
 					auto iesLight = frcontext.CreateIESLight();
 
-					rpr_int res = iesLight.SetIESData(processor.ToString(params.data).c_str(), 256, 256);
+					rpr_int res = iesLight.SetIESData(profile->iesData.c_str(), 256, 256);
 					assert(res == RPR_SUCCESS);
 
 					if (res == RPR_SUCCESS)
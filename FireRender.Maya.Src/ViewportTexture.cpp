@@ -4,8 +4,17 @@
 
 #include "ViewportTexture.h"
 
+namespace
+{
+	const unsigned int ComponentCount = 4;
+}
 
-ViewportTexture::ViewportTexture() : m_texture(nullptr)
+ViewportTexture::ViewportTexture() :
+	m_texture(nullptr),
+	m_width(0),
+	m_height(0),
+	m_backIndex(0),
+	m_hasPendingFrame(false)
 {
 
 }
@@ -15,19 +24,41 @@ ViewportTexture::~ViewportTexture()
 	Release();
 }
 
-MStatus ViewportTexture::UpdateTexture(float* externalData /* = nullptr*/)
+MStatus ViewportTexture::UpdateTexture()
+{
+	if (m_texture == nullptr)
+	{
+		return MStatus::kFailure;
+	}
+
+	std::lock_guard<std::mutex> lock(m_presentLock);
+
+	if (!m_hasPendingFrame)
+	{
+		// Nothing new was presented since the last upload
+		return MStatus::kSuccess;
+	}
+
+	m_hasPendingFrame = false;
+
+	int rowPitch = (int)(ComponentCount * sizeof(float) * m_width);
+
+	return m_texture->update(m_buffers[1 - m_backIndex].data(), false, rowPitch);
+}
+
+MStatus ViewportTexture::UpdateTexture(const float* externalData)
 {
 	if (m_texture != nullptr)
 	{
-		return m_texture->update(externalData ? externalData : m_pixels.data(), false);
+		return m_texture->update(externalData, false);
 	}
 
 	return MStatus::kFailure;
 }
 
-void ViewportTexture::ClearPixels()
+void ViewportTexture::ClearPixels(std::vector<float>& pixels)
 {
-	assert(m_pixels.size() > 0);
+	assert(pixels.size() > 0);
 
 	RV_PIXEL zero;
 	zero.r = 0;
@@ -35,14 +66,12 @@ void ViewportTexture::ClearPixels()
 	zero.b = 0;
 	zero.a = 1;
 
-	const unsigned int numComponents = 4;
-	for (unsigned int i = 0; i < m_pixels.size(); i += numComponents)
+	for (size_t i = 0; i < pixels.size(); i += ComponentCount)
 	{
-		memcpy(m_pixels.data() + i, &zero, sizeof(RV_PIXEL));
+		memcpy(pixels.data() + i, &zero, sizeof(RV_PIXEL));
 	}
 }
 
-
 void ViewportTexture::Resize(unsigned int width, unsigned int height)
 {
 	// Create the hardware backed texture if required.
@@ -62,8 +91,18 @@ void ViewportTexture::Resize(unsigned int width, unsigned int height)
 	{
 		Release();
 
-		m_pixels.resize(width * height * 4);
-		ClearPixels();
+		std::lock_guard<std::mutex> lock(m_presentLock);
+
+		m_width = width;
+		m_height = height;
+
+		for (std::vector<float>& buffer : m_buffers)
+		{
+			buffer.resize((size_t)width * height * ComponentCount);
+			ClearPixels(buffer);
+		}
+
+		m_hasPendingFrame = false;
 
 		/** The description of the texture that will receive the RPR frame buffer. */
 		MHWRender::MTextureDescription textureDesc;
@@ -76,7 +115,7 @@ void ViewportTexture::Resize(unsigned int width, unsigned int height)
 		textureDesc.fWidth = width;
 		textureDesc.fHeight = height;
 		textureDesc.fDepth = 1;
-		textureDesc.fBytesPerRow = 4 * sizeof(float) * width;
+		textureDesc.fBytesPerRow = ComponentCount * sizeof(float) * width;
 		textureDesc.fBytesPerSlice = textureDesc.fBytesPerRow * height;
 		textureDesc.fFormat = MHWRender::MRasterFormat::kR32G32B32A32_FLOAT;
 
@@ -85,7 +124,7 @@ void ViewportTexture::Resize(unsigned int width, unsigned int height)
 
 		MTextureManager* textureManager = renderer->getTextureManager();
 
-		m_texture = textureManager->acquireTexture("", textureDesc, m_pixels.data(), false);
+		m_texture = textureManager->acquireTexture("", textureDesc, m_buffers[1 - m_backIndex].data(), false);
 	}
 }
 
@@ -101,7 +140,30 @@ void ViewportTexture::Release()
 	}
 }
 
-void ViewportTexture::SetPixelData(std::vector<float> vecData)
+void ViewportTexture::PresentBackBuffer()
+{
+	if (m_width == 0 || m_height == 0)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_presentLock);
+
+	// Frame which wasn't uploaded yet is dropped, the new one replaces it completely
+	m_backIndex = 1 - m_backIndex;
+	m_hasPendingFrame = true;
+}
+
+void ViewportTexture::PresentPixelData(std::vector<float>&& pixelData)
 {
-	m_pixels = std::move(vecData);
+	if (pixelData.size() != (size_t)m_width * m_height * ComponentCount)
+	{
+		// texture size has changed or frame is empty
+		return;
+	}
+
+	// Moved instead of copied
+	std::swap(m_buffers[m_backIndex], pixelData);
+
+	PresentBackBuffer();
 }
@@ -2,15 +2,23 @@
 
 #include <maya/MShaderManager.h>
 #include <vector>
+#include <mutex>
 
+// Viewport texture with double buffered system memory pixels.
+// Render thread writes a frame into the back buffer and presents it,
+// main thread uploads the last presented frame. Viewport renders the whole frame on every iteration,
+// so frames are always uploaded whole.
 class ViewportTexture
 {
 public:
 	ViewportTexture();
 	~ViewportTexture();
 
-	// only from main thread
-	MStatus UpdateTexture(float* externalData = nullptr);
+	// only from main thread. Uploads last presented frame (if any)
+	MStatus UpdateTexture();
+
+	// only from main thread. Uploads whole texture from external memory
+	MStatus UpdateTexture(const float* externalData);
 
 	void Resize(unsigned int width, unsigned int height);
 
@@ -18,13 +26,31 @@ public:
 
 	MTexture* GetTexture() const{ return m_texture; }
 
-	float* GetPixelData() { return m_pixels.data(); }
-	void SetPixelData(std::vector<float> vecData);
+	// Buffer for the next frame, owned by the render thread until it is presented. It should be written completely
+	float* GetBackBuffer() { return m_buffers[m_backIndex].data(); }
+
+	// Publishes back buffer to the main thread
+	void PresentBackBuffer();
+
+	// Takes ownership of the frame data and publishes it. Data should have the texture size
+	void PresentPixelData(std::vector<float>&& pixelData);
 
 private:
-	void ClearPixels();
+	void ClearPixels(std::vector<float>& pixels);
 
 private:
 	MHWRender::MTexture* m_texture;
-	std::vector<float> m_pixels;
+
+	unsigned int m_width;
+	unsigned int m_height;
+
+	// front buffer is the last presented frame, back buffer is written by the render thread
+	std::vector<float> m_buffers[2];
+	int m_backIndex;
+
+	// Front buffer is not uploaded yet
+	bool m_hasPendingFrame;
+
+	// guards buffers swap and the pending flag
+	std::mutex m_presentLock;
 };
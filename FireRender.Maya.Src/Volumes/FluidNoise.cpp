@@ -0,0 +1,307 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "FluidNoise.h"
+
+#include "FastNoise.h"
+#include "ParallelFor.h"
+
+#include <maya/MPlug.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+	const int MaxOctaves = 16;
+	const int MaxWaves = 64;
+
+	// Grids smaller than that are not worth to be split between threads
+	const size_t MinVoxelsPerThread = 32 * 1024;
+
+	const float TwoPi = 6.28318530718f;
+
+	// Wispy texture is the perlin noise with distorted coordinates
+	const float WispyPerturbAmplitude = 0.5f;
+
+	float ReadFloat(const MFnDependencyNode& node, const char* plugName, float defaultValue)
+	{
+		MPlug plug = node.findPlug(plugName);
+		return plug.isNull() ? defaultValue : plug.asFloat();
+	}
+
+	int ReadInt(const MFnDependencyNode& node, const char* plugName, int defaultValue)
+	{
+		MPlug plug = node.findPlug(plugName);
+		return plug.isNull() ? defaultValue : plug.asInt();
+	}
+
+	bool ReadBool(const MFnDependencyNode& node, const char* plugName, bool defaultValue)
+	{
+		MPlug plug = node.findPlug(plugName);
+		return plug.isNull() ? defaultValue : plug.asBool();
+	}
+
+	// Evaluates the fluid texture for rows of voxels.
+	// Octaves are the outer loop and voxels of the row are the inner one. FastNoise is called per voxel,
+	// rows only keep the octave setup out of the per voxel loop.
+	class FluidNoiseEvaluator
+	{
+	public:
+		explicit FluidNoiseEvaluator(const FluidNoiseParams& params) :
+			m_params(params)
+		{
+			// Frequency is applied to the coordinates, FastNoise works with unit frequency
+			m_noise.SetFrequency(1.0f);
+			m_noise.SetInterp(FastNoise::Quintic);
+			m_noise.SetGradientPerturbAmp(WispyPerturbAmplitude);
+
+			m_octaves = std::max(1, std::min(params.octaves, MaxOctaves));
+
+			if (params.textureType == FluidTextureType::VolumeWave)
+			{
+				// Evenly distributed wave directions (golden spiral over the sphere)
+				int waveCount = std::max(1, std::min(params.numWaves, MaxWaves));
+				const float goldenAngle = 2.39996323f;
+
+				for (int waveIndex = 0; waveIndex < waveCount; ++waveIndex)
+				{
+					float z = 1.0f - (2.0f * waveIndex + 1.0f) / waveCount;
+					float radius = std::sqrt(std::max(0.0f, 1.0f - z * z));
+					float angle = goldenAngle * waveIndex;
+
+					m_waveDirections.push_back({ radius * std::cos(angle), radius * std::sin(angle), z });
+				}
+			}
+		}
+
+		// Writes texture values in [0, 1] range for count voxels
+		void EvaluateRow(const float* xs, const float* ys, const float* zs, float* out, float* octaveValues, size_t count) const
+		{
+			std::fill(out, out + count, 0.0f);
+
+			float amplitude = 1.0f;
+			float frequency = m_params.frequency;
+			float amplitudeSum = 0.0f;
+
+			for (int octave = 0; octave < m_octaves; ++octave)
+			{
+				EvaluateBasis(xs, ys, zs, frequency, octaveValues, count);
+
+				if (m_params.inflection)
+				{
+					for (size_t i = 0; i < count; ++i)
+					{
+						out[i] += amplitude * std::fabs(octaveValues[i]);
+					}
+				}
+				else
+				{
+					for (size_t i = 0; i < count; ++i)
+					{
+						out[i] += amplitude * (0.5f * octaveValues[i] + 0.5f);
+					}
+				}
+
+				amplitudeSum += amplitude;
+				amplitude *= m_params.ratio;
+				frequency *= m_params.frequencyRatio;
+			}
+
+			const float normalization = amplitudeSum > 0.0f ? 1.0f / amplitudeSum : 0.0f;
+			const float textureAmplitude = m_params.amplitude;
+			const float threshold = m_params.threshold;
+			const bool invert = m_params.invert;
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				float value = (out[i] * normalization - 0.5f) * textureAmplitude + 0.5f + threshold;
+				value = std::min(std::max(value, 0.0f), 1.0f);
+				out[i] = invert ? 1.0f - value : value;
+			}
+		}
+
+	private:
+		// Single octave of the noise in [-1, 1] range
+		void EvaluateBasis(const float* xs, const float* ys, const float* zs, float frequency, float* out, size_t count) const
+		{
+			switch (m_params.textureType)
+			{
+				case FluidTextureType::Billow:
+					for (size_t i = 0; i < count; ++i)
+					{
+						out[i] = 2.0f * std::fabs(m_noise.GetPerlin(xs[i] * frequency, ys[i] * frequency, zs[i] * frequency)) - 1.0f;
+					}
+					break;
+
+				case FluidTextureType::VolumeWave:
+				{
+					const float waveNormalization = 1.0f / m_waveDirections.size();
+					std::fill(out, out + count, 0.0f);
+
+					for (const std::array<float, 3>& direction : m_waveDirections)
+					{
+						const float dx = direction[0] * frequency * TwoPi;
+						const float dy = direction[1] * frequency * TwoPi;
+						const float dz = direction[2] * frequency * TwoPi;
+
+						for (size_t i = 0; i < count; ++i)
+						{
+							out[i] += std::cos(xs[i] * dx + ys[i] * dy + zs[i] * dz + m_params.time * TwoPi);
+						}
+					}
+
+					for (size_t i = 0; i < count; ++i)
+					{
+						out[i] *= waveNormalization;
+					}
+					break;
+				}
+
+				case FluidTextureType::Wispy:
+					for (size_t i = 0; i < count; ++i)
+					{
+						FN_DECIMAL x = xs[i] * frequency;
+						FN_DECIMAL y = ys[i] * frequency;
+						FN_DECIMAL z = zs[i] * frequency;
+						m_noise.GradientPerturb(x, y, z);
+						out[i] = m_noise.GetPerlin(x, y, z);
+					}
+					break;
+
+				case FluidTextureType::SpaceTime:
+					for (size_t i = 0; i < count; ++i)
+					{
+						out[i] = m_noise.GetSimplex(xs[i] * frequency, ys[i] * frequency, zs[i] * frequency, m_params.time);
+					}
+					break;
+
+				case FluidTextureType::PerlinNoise:
+				default:
+					for (size_t i = 0; i < count; ++i)
+					{
+						out[i] = m_noise.GetPerlin(xs[i] * frequency, ys[i] * frequency, zs[i] * frequency);
+					}
+					break;
+			}
+		}
+
+	private:
+		const FluidNoiseParams& m_params;
+
+		// Only const methods are used after construction, so it is shared by the threads
+		FastNoise m_noise;
+
+		int m_octaves;
+		std::vector<std::array<float, 3>> m_waveDirections;
+	};
+}
+
+bool FluidNoiseParams::ReadFromFluid(const MFnDependencyNode& fluidNode, const char* gainPlugName)
+{
+	MPlug textureTypePlug = fluidNode.findPlug("textureType");
+	MPlug gainPlug = fluidNode.findPlug(gainPlugName);
+
+	if (textureTypePlug.isNull() || gainPlug.isNull())
+	{
+		return false;
+	}
+
+	// Mandelbrot types are not supported, perlin noise is used instead
+	int type = textureTypePlug.asInt();
+	textureType = (type >= (int)FluidTextureType::PerlinNoise && type <= (int)FluidTextureType::SpaceTime) ?
+		static_cast<FluidTextureType>(type) : FluidTextureType::PerlinNoise;
+
+	gain = gainPlug.asFloat();
+	threshold = ReadFloat(fluidNode, "threshold", threshold);
+	amplitude = ReadFloat(fluidNode, "amplitude", amplitude);
+	ratio = ReadFloat(fluidNode, "ratio", ratio);
+	frequencyRatio = ReadFloat(fluidNode, "frequencyRatio", frequencyRatio);
+	octaves = ReadInt(fluidNode, "depthMax", octaves);
+	invert = ReadBool(fluidNode, "invertTexture", invert);
+	inflection = ReadBool(fluidNode, "inflection", inflection);
+
+	frequency = ReadFloat(fluidNode, "frequency", frequency);
+	time = ReadFloat(fluidNode, "textureTime", time);
+	numWaves = ReadInt(fluidNode, "numWaves", numWaves);
+
+	origin = { ReadFloat(fluidNode, "textureOriginX", 0.0f), ReadFloat(fluidNode, "textureOriginY", 0.0f), ReadFloat(fluidNode, "textureOriginZ", 0.0f) };
+	scale = { ReadFloat(fluidNode, "textureScaleX", 1.0f), ReadFloat(fluidNode, "textureScaleY", 1.0f), ReadFloat(fluidNode, "textureScaleZ", 1.0f) };
+	dimensions = { ReadFloat(fluidNode, "dimensionsW", 1.0f), ReadFloat(fluidNode, "dimensionsH", 1.0f), ReadFloat(fluidNode, "dimensionsD", 1.0f) };
+
+	return true;
+}
+
+void ApplyFluidNoise(std::vector<float>& values, size_t Xres, size_t Yres, size_t Zres, const FluidNoiseParams& params)
+{
+	const size_t rowCount = Yres * Zres;
+
+	if (Xres == 0 || rowCount == 0 || params.gain == 0.0f)
+	{
+		return;
+	}
+
+	assert(values.size() == Xres * rowCount);
+	if (values.size() != Xres * rowCount)
+	{
+		return;
+	}
+
+	FluidNoiseEvaluator evaluator(params);
+
+	// Voxel centers in the texture space: fluid local space is centered and has the fluid dimensions.
+	// Texture time moves 3D noise types along the diagonal, space time and wave types use it directly.
+	const bool timeAsOffset = params.textureType != FluidTextureType::SpaceTime && params.textureType != FluidTextureType::VolumeWave;
+	const float timeOffset = timeAsOffset ? params.time : 0.0f;
+
+	auto textureCoordinate = [&](size_t index, size_t resolution, int axis)
+	{
+		float local = ((index + 0.5f) / resolution - 0.5f) * params.dimensions[axis];
+		float axisScale = params.scale[axis] != 0.0f ? params.scale[axis] : 1.0f;
+
+		return local / axisScale + params.origin[axis] + timeOffset;
+	};
+
+	std::vector<float> xCoordinates(Xres);
+	for (size_t x = 0; x < Xres; ++x)
+	{
+		xCoordinates[x] = textureCoordinate(x, Xres, 0);
+	}
+
+	const float gain = std::min(std::max(params.gain, 0.0f), 1.0f);
+
+	RPR::ParallelFor(rowCount, std::max<size_t>(MinVoxelsPerThread / Xres, 1), [&](size_t firstRow, size_t lastRow)
+	{
+		std::vector<float> yCoordinates(Xres);
+		std::vector<float> zCoordinates(Xres);
+		std::vector<float> texture(Xres);
+		std::vector<float> octaveValues(Xres);
+
+		for (size_t row = firstRow; row < lastRow; ++row)
+		{
+			size_t y = row % Yres;
+			size_t z = row / Yres;
+
+			std::fill(yCoordinates.begin(), yCoordinates.end(), textureCoordinate(y, Yres, 1));
+			std::fill(zCoordinates.begin(), zCoordinates.end(), textureCoordinate(z, Zres, 2));
+
+			evaluator.EvaluateRow(xCoordinates.data(), yCoordinates.data(), zCoordinates.data(), texture.data(), octaveValues.data(), Xres);
+
+			float* rowValues = values.data() + row * Xres;
+			for (size_t x = 0; x < Xres; ++x)
+			{
+				rowValues[x] *= 1.0f - gain + gain * texture[x];
+			}
+		}
+	});
+}
@@ -0,0 +1,60 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <maya/MFnDependencyNode.h>
+
+#include <array>
+#include <vector>
+
+// Maya fluid texture types (textureType attribute of fluidShape)
+enum class FluidTextureType
+{
+	PerlinNoise = 0,
+	Billow,
+	VolumeWave,
+	Wispy,
+	SpaceTime,
+};
+
+// Textured noise settings of the fluid shape. Shared by all channels, only the gain is per channel
+struct FluidNoiseParams
+{
+	FluidTextureType textureType = FluidTextureType::PerlinNoise;
+
+	float gain = 1.0f;
+	float threshold = 0.0f;
+	float amplitude = 1.0f;
+	float ratio = 0.707f;
+	float frequencyRatio = 2.0f;
+	int octaves = 2;
+	bool invert = false;
+	bool inflection = false;
+
+	float frequency = 1.0f;
+	float time = 0.0f;
+	int numWaves = 5;
+
+	std::array<float, 3> origin = { 0.0f, 0.0f, 0.0f };
+	std::array<float, 3> scale = { 1.0f, 1.0f, 1.0f };
+
+	// fluid container size, voxel positions are in the fluid local space
+	std::array<float, 3> dimensions = { 1.0f, 1.0f, 1.0f };
+
+	// Reads texture settings from the fluid shape, gainPlugName is the channel gain (opacityTexGain, colorTexGain, incandTexGain)
+	bool ReadFromFluid(const MFnDependencyNode& fluidNode, const char* gainPlugName);
+};
+
+// Multiplies channel values by the fluid texture blended by the gain.
+// Values are in the fluid grid order (x changes fastest), evaluation is done in parallel over the grid slices.
+void ApplyFluidNoise(std::vector<float>& values, size_t Xres, size_t Yres, size_t Zres, const FluidNoiseParams& params);
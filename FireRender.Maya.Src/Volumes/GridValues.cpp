@@ -0,0 +1,113 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "GridValues.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <mutex>
+
+namespace
+{
+	// Grids smaller than that are processed on the calling thread
+	const size_t MinGridValuesPerThread = 256 * 1024;
+
+	float GetMaxGridValue(const std::vector<float>& values)
+	{
+		std::mutex maxLock;
+		float maxValue = -FLT_MAX;
+
+		RPR::ParallelFor(values.size(), MinGridValuesPerThread, [&](size_t begin, size_t end)
+		{
+			float rangeMax = *std::max_element(values.begin() + begin, values.begin() + end);
+
+			std::lock_guard<std::mutex> lock(maxLock);
+			maxValue = std::max(maxValue, rangeMax);
+		});
+
+		return maxValue;
+	}
+}
+
+bool NormalizeGridValues(const std::vector<float>& values, std::vector<float>& normalizedValues)
+{
+	if (values.empty())
+	{
+		return false;
+	}
+
+	float maxValue = GetMaxGridValue(values);
+	if (maxValue <= 1.0f)
+	{
+		return false;
+	}
+
+	normalizedValues.resize(values.size());
+
+	RPR::ParallelFor(values.size(), MinGridValuesPerThread, [&](size_t begin, size_t end)
+	{
+		const float* rangeValues = values.data() + begin;
+		float* rangeNormalizedValues = normalizedValues.data() + begin;
+		const size_t count = end - begin;
+
+		for (size_t idx = 0; idx < count; ++idx)
+		{
+			rangeNormalizedValues[idx] = rangeValues[idx] / maxValue;
+		}
+	});
+
+	return true;
+}
+
+void NormalizeGridValues(std::vector<float>& values)
+{
+	NormalizeGridValues(values, values);
+}
+
+void ApplyDensityLookupTable(std::vector<float>& values, const std::vector<float>& lookupTable)
+{
+	const size_t countCtrlPoints = lookupTable.size() / 3;
+	if (countCtrlPoints == 0)
+	{
+		return;
+	}
+
+	const float step = 1.0f / ((countCtrlPoints > 1) ? (countCtrlPoints - 1) : 1);
+
+	// averages of neighbour ctrl points, so the inner loop has a single lookup
+	std::vector<float> segmentValues(countCtrlPoints);
+	for (size_t idx = 0; idx < countCtrlPoints; ++idx)
+	{
+		size_t next = std::min(idx + 1, countCtrlPoints - 1);
+		segmentValues[idx] = (lookupTable[idx * 3] + lookupTable[next * 3]) / 2.0f;
+	}
+
+	RPR::ParallelFor(values.size(), MinGridValuesPerThread, [&](size_t begin, size_t end)
+	{
+		float* rangeValues = values.data() + begin;
+		const size_t count = end - begin;
+		const float maxSegment = (float)(countCtrlPoints - 1);
+
+		for (size_t idx = 0; idx < count; ++idx)
+		{
+			float gridVal = rangeValues[idx];
+
+			// - find 2 closest ctrl points
+			float segment = std::min(std::max(std::floor(gridVal / step), 0.0f), maxSegment);
+
+			// - interpolate values from 2 ctrl points
+			rangeValues[idx] = gridVal * segmentValues[(size_t)segment];
+		}
+	});
+}
@@ -0,0 +1,27 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <vector>
+
+// Processing of the active values of volume grids, done in parallel over value ranges. Has no Maya dependencies.
+
+// Scales grid values to [0, 1] range if there are values greater than one
+void NormalizeGridValues(std::vector<float>& values);
+
+// Same as above, but the scaled values are written to normalizedValues (can be the same vector), so shared values aren't copied first.
+// Returns false if the values are in range and nothing was written
+bool NormalizeGridValues(const std::vector<float>& values, std::vector<float>& normalizedValues);
+
+// Density lookup is not implemented in Northstar, so the lookup table (rgb triplets, red is used) is applied to the grid values
+void ApplyDensityLookupTable(std::vector<float>& values, const std::vector<float>& lookupTable);
@@ -0,0 +1,492 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "VDBGridCache.h"
+
+#pragma warning(push)
+#pragma warning(disable : 4244)
+#pragma warning(disable : 4800)
+#include <RadeonProRenderLibs/rprLibs/pluginUtils.hpp>
+#pragma warning(pop)
+
+#include "ParallelFor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <sstream>
+
+namespace
+{
+	// Leaves are split into at most one chunk per thread, chunks smaller than that aren't worth a thread.
+	// Leaf nodes are 8x8x8 voxels, so that is at least 32K voxels per thread for dense leaves
+	const size_t MinLeavesPerChunk = 64;
+
+	typedef openvdb::FloatTree::LeafNodeType FloatLeaf;
+
+	// Voxels of a range of leaf nodes
+	struct GridChunk
+	{
+		std::vector<uint32_t> indices;
+		std::vector<float> values;
+
+		// Downsampled grid only: linear index of the output voxel for each value
+		std::vector<uint64_t> cellIndices;
+	};
+
+	openvdb::CoordBBox ToCoordBBox(const VDBGridRegion& region)
+	{
+		return openvdb::CoordBBox(
+			openvdb::Coord(region.min[0], region.min[1], region.min[2]),
+			openvdb::Coord(region.max[0], region.max[1], region.max[2]));
+	}
+
+	VDBGridRegion ToRegion(const openvdb::CoordBBox& box)
+	{
+		VDBGridRegion region;
+		region.min = { box.min().x(), box.min().y(), box.min().z() };
+		region.max = { box.max().x(), box.max().y(), box.max().z() };
+
+		return region;
+	}
+
+	std::string MakeKey(const std::string& filePath, const std::string& gridName, const VDBGridReadOptions& options)
+	{
+		std::ostringstream key;
+		key << filePath << '|' << gridName << '|' << options.voxelBudget << '|' << options.downsampleFactor;
+
+		if (!options.clipRegion.IsEmpty())
+		{
+			const VDBGridRegion& region = options.clipRegion;
+			key << '|' << region.min[0] << ',' << region.min[1] << ',' << region.min[2]
+				<< '|' << region.max[0] << ',' << region.max[1] << ',' << region.max[2];
+		}
+
+		return key.str();
+	}
+
+	// Smallest integer factor which makes the downsampled region fit into the budget
+	int GetDownsampleFactor(const openvdb::Coord& dim, size_t voxelBudget)
+	{
+		if (voxelBudget == 0)
+		{
+			return 1;
+		}
+
+		auto downsampledCount = [&](int factor)
+		{
+			return size_t((dim.x() + factor - 1) / factor) * size_t((dim.y() + factor - 1) / factor) * size_t((dim.z() + factor - 1) / factor);
+		};
+
+		double ratio = double(downsampledCount(1)) / voxelBudget;
+		int factor = std::max(1, (int)std::floor(std::cbrt(ratio)));
+
+		while (downsampledCount(factor) > voxelBudget && factor < std::max(dim.x(), std::max(dim.y(), dim.z())))
+		{
+			++factor;
+		}
+
+		return factor;
+	}
+
+	// Voxels are read leaf by leaf, leaves of the file grid are loaded on access (delayed loading)
+	void ReadLeafRange(
+		const std::vector<const FloatLeaf*>& leaves,
+		size_t firstLeaf,
+		size_t lastLeaf,
+		const openvdb::CoordBBox& region,
+		int factor,
+		const openvdb::Coord& outputDim,
+		GridChunk& chunk)
+	{
+		const openvdb::Coord& origin = region.min();
+
+		for (size_t leafIndex = firstLeaf; leafIndex < lastLeaf; ++leafIndex)
+		{
+			const FloatLeaf& leaf = *leaves[leafIndex];
+
+			if (!region.hasOverlap(leaf.getNodeBoundingBox()))
+			{
+				continue;
+			}
+
+			for (auto it = leaf.cbeginValueOn(); it; ++it)
+			{
+				openvdb::Coord coord = it.getCoord();
+				if (!region.isInside(coord))
+				{
+					continue;
+				}
+
+				openvdb::Coord local = coord - origin;
+
+				if (factor == 1)
+				{
+					chunk.indices.push_back((uint32_t)local.x());
+					chunk.indices.push_back((uint32_t)local.y());
+					chunk.indices.push_back((uint32_t)local.z());
+				}
+				else
+				{
+					uint64_t x = local.x() / factor;
+					uint64_t y = local.y() / factor;
+					uint64_t z = local.z() / factor;
+					chunk.cellIndices.push_back(x + y * outputDim.x() + z * uint64_t(outputDim.x()) * outputDim.y());
+				}
+
+				chunk.values.push_back(*it);
+			}
+		}
+	}
+
+	// Box filter over factor^3 voxels, inactive voxels have the background value
+	void MergeDownsampledChunks(
+		std::vector<GridChunk>& chunks,
+		int factor,
+		float background,
+		const openvdb::Coord& outputDim,
+		VDBGrid<float>& outGrid)
+	{
+		std::vector<std::pair<uint64_t, float>> cells;
+
+		size_t totalCount = 0;
+		for (const GridChunk& chunk : chunks)
+		{
+			totalCount += chunk.values.size();
+		}
+
+		cells.reserve(totalCount);
+		for (GridChunk& chunk : chunks)
+		{
+			for (size_t idx = 0; idx < chunk.values.size(); ++idx)
+			{
+				cells.emplace_back(chunk.cellIndices[idx], chunk.values[idx]);
+			}
+
+			chunk = GridChunk();
+		}
+
+		std::sort(cells.begin(), cells.end(), [](const std::pair<uint64_t, float>& a, const std::pair<uint64_t, float>& b)
+		{
+			return a.first < b.first;
+		});
+
+		const float cellVoxelCount = float(factor) * factor * factor;
+		const uint64_t sliceSize = uint64_t(outputDim.x()) * outputDim.y();
+
+		for (size_t first = 0; first < cells.size(); )
+		{
+			uint64_t cellIndex = cells[first].first;
+
+			size_t last = first;
+			float sum = 0.0f;
+			for (; last < cells.size() && cells[last].first == cellIndex; ++last)
+			{
+				sum += cells[last].second;
+			}
+
+			float activeCount = float(last - first);
+			float value = (sum + (cellVoxelCount - activeCount) * background) / cellVoxelCount;
+
+			outGrid.gridOnIndices.push_back((uint32_t)(cellIndex % outputDim.x()));
+			outGrid.gridOnIndices.push_back((uint32_t)((cellIndex % sliceSize) / outputDim.x()));
+			outGrid.gridOnIndices.push_back((uint32_t)(cellIndex / sliceSize));
+			outGrid.gridOnValueIndices.push_back(value);
+
+			first = last;
+		}
+	}
+}
+
+VDBGridCache& VDBGridCache::GetInstance()
+{
+	static VDBGridCache instance;
+	return instance;
+}
+
+std::shared_ptr<const VDBConvertedGrid> VDBGridCache::GetGrid(
+	const std::string& filePath,
+	const std::string& gridName,
+	const VDBGridReadOptions& options,
+	std::string& errorMessage)
+{
+	namespace fs = std::filesystem;
+
+	std::error_code errorCode;
+	fs::file_time_type modificationTime = fs::last_write_time(fs::u8path(filePath), errorCode);
+	if (errorCode)
+	{
+		errorMessage = "Failed to open vdb file " + filePath;
+		return nullptr;
+	}
+
+	std::string key = MakeKey(filePath, gridName, options);
+
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+
+		auto it = m_entries.find(key);
+		if (it != m_entries.end() && it->second.modificationTime == modificationTime)
+		{
+			m_lru.splice(m_lru.begin(), m_lru, it->second.lruPosition);
+			return it->second.grid;
+		}
+	}
+
+	// Read without the lock, so cached grids are available while a big grid is loaded
+	std::shared_ptr<const VDBConvertedGrid> grid = ReadGrid(filePath, gridName, options, errorMessage);
+	if (grid)
+	{
+		Insert(key, modificationTime, grid);
+	}
+
+	return grid;
+}
+
+void VDBGridCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	m_entries.clear();
+	m_lru.clear();
+	m_sizeInBytes = 0;
+}
+
+void VDBGridCache::SetMaxSizeInBytes(size_t maxSizeInBytes)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	m_maxSizeInBytes = maxSizeInBytes;
+	Evict();
+}
+
+void VDBGridCache::Insert(const std::string& key, std::filesystem::file_time_type modificationTime, std::shared_ptr<const VDBConvertedGrid> grid)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	auto it = m_entries.find(key);
+	if (it != m_entries.end())
+	{
+		m_sizeInBytes -= it->second.sizeInBytes;
+		m_lru.erase(it->second.lruPosition);
+		m_entries.erase(it);
+	}
+
+	Entry entry;
+	entry.modificationTime = modificationTime;
+	entry.sizeInBytes = grid->grid.gridOnIndices.size() * sizeof(uint32_t) + grid->grid.gridOnValueIndices.size() * sizeof(float);
+	entry.grid = std::move(grid);
+
+	m_lru.push_front(key);
+	entry.lruPosition = m_lru.begin();
+
+	m_sizeInBytes += entry.sizeInBytes;
+	m_entries[key] = std::move(entry);
+
+	Evict();
+}
+
+void VDBGridCache::Evict()
+{
+	// Volumes which use evicted grids keep them alive until they are translated again
+	while (m_sizeInBytes > m_maxSizeInBytes && m_lru.size() > 1)
+	{
+		auto evicted = m_entries.find(m_lru.back());
+		m_sizeInBytes -= evicted->second.sizeInBytes;
+		m_entries.erase(evicted);
+		m_lru.pop_back();
+	}
+}
+
+std::shared_ptr<const VDBConvertedGrid> VDBGridCache::ReadGrid(
+	const std::string& filePath,
+	const std::string& gridName,
+	const VDBGridReadOptions& options,
+	std::string& errorMessage)
+{
+	// initialize openvdb; it is necessary to call it before beginning working with vdb
+	openvdb::initialize();
+
+	openvdb::FloatGrid::Ptr grid;
+
+	try
+	{
+		openvdb::io::File file(filePath);
+
+		// delayed loading: leaf buffers are read from the file when they are accessed
+		file.open(true);
+
+		if (!file.hasGrid(gridName))
+		{
+			errorMessage = "Grid " + gridName + " is not found in " + filePath;
+			return nullptr;
+		}
+
+		openvdb::GridBase::Ptr baseGrid;
+
+		if (options.clipRegion.IsEmpty())
+		{
+			baseGrid = file.readGrid(gridName);
+		}
+		else
+		{
+			// only leaves intersecting the clip box are loaded
+			openvdb::GridBase::ConstPtr metadata = file.readGridMetadata(gridName);
+			openvdb::BBoxd worldClipBox = metadata->transform().indexToWorld(ToCoordBBox(options.clipRegion));
+
+			baseGrid = file.readGrid(gridName, worldClipBox);
+		}
+
+		file.close();
+
+		grid = openvdb::gridPtrCast<openvdb::FloatGrid>(baseGrid);
+	}
+	catch (openvdb::Exception& ex)
+	{
+		errorMessage = ex.what();
+		return nullptr;
+	}
+
+	if (!grid)
+	{
+		errorMessage = "Grid " + gridName + " is not a float grid";
+		return nullptr;
+	}
+
+	// active tiles are rare in the volume grids, they are expanded to voxels to be read as the leaves
+	grid->tree().voxelizeActiveTiles();
+
+	openvdb::CoordBBox region = options.clipRegion.IsEmpty() ? grid->evalActiveVoxelBoundingBox() : ToCoordBBox(options.clipRegion);
+
+	auto result = std::make_shared<VDBConvertedGrid>();
+	VDBGrid<float>& outGrid = result->grid;
+
+	openvdb::Vec3d voxelSize = grid->voxelSize();
+
+	if (region.empty())
+	{
+		// no active voxels, the volume is empty
+		outGrid.size.gridSizeX = outGrid.size.gridSizeY = outGrid.size.gridSizeZ = 0;
+		outGrid.size.voxelSizeX = voxelSize[0];
+		outGrid.size.voxelSizeY = voxelSize[1];
+		outGrid.size.voxelSizeZ = voxelSize[2];
+		outGrid.minValue = outGrid.maxValue = 0.0f;
+
+		return result;
+	}
+
+	const openvdb::Coord dim = region.dim();
+	const int factor = (options.downsampleFactor > 0) ? options.downsampleFactor : GetDownsampleFactor(dim, options.voxelBudget);
+	const openvdb::Coord outputDim((dim.x() + factor - 1) / factor, (dim.y() + factor - 1) / factor, (dim.z() + factor - 1) / factor);
+
+	result->region = ToRegion(region);
+	result->downsampleFactor = factor;
+
+	outGrid.size.gridSizeX = outputDim.x();
+	outGrid.size.gridSizeY = outputDim.y();
+	outGrid.size.gridSizeZ = outputDim.z();
+	outGrid.size.voxelSizeX = voxelSize[0] * factor;
+	outGrid.size.voxelSizeY = voxelSize[1] * factor;
+	outGrid.size.voxelSizeZ = voxelSize[2] * factor;
+
+	std::vector<const FloatLeaf*> leaves;
+	leaves.reserve(grid->tree().leafCount());
+	for (auto leafIt = grid->tree().cbeginLeaf(); leafIt; ++leafIt)
+	{
+		leaves.push_back(leafIt.getLeaf());
+	}
+
+	// Chunks are merged in the leaf order, so the output doesn't depend on the thread count
+	std::mutex chunksLock;
+	std::map<size_t, GridChunk> chunksByFirstLeaf;
+	std::string readError;
+
+	RPR::ParallelFor(leaves.size(), MinLeavesPerChunk, [&](size_t firstLeaf, size_t lastLeaf)
+	{
+		GridChunk chunk;
+		std::string chunkError;
+
+		// delay loaded leaves throw if the file is damaged, exceptions must not leave worker threads
+		try
+		{
+			ReadLeafRange(leaves, firstLeaf, lastLeaf, region, factor, outputDim, chunk);
+		}
+		catch (openvdb::Exception& ex)
+		{
+			chunkError = ex.what();
+		}
+
+		std::lock_guard<std::mutex> lock(chunksLock);
+		if (!chunkError.empty())
+		{
+			readError = chunkError;
+		}
+		chunksByFirstLeaf[firstLeaf] = std::move(chunk);
+	});
+
+	if (!readError.empty())
+	{
+		errorMessage = readError;
+		return nullptr;
+	}
+
+	const float background = grid->background();
+
+	// leaves aren't needed anymore, release the file grid before merging
+	leaves.clear();
+	grid.reset();
+
+	std::vector<GridChunk> chunks;
+	chunks.reserve(chunksByFirstLeaf.size());
+	for (auto& chunk : chunksByFirstLeaf)
+	{
+		chunks.push_back(std::move(chunk.second));
+	}
+	chunksByFirstLeaf.clear();
+
+	if (factor == 1)
+	{
+		size_t totalCount = 0;
+		for (const GridChunk& chunk : chunks)
+		{
+			totalCount += chunk.values.size();
+		}
+
+		outGrid.gridOnIndices.reserve(totalCount * 3);
+		outGrid.gridOnValueIndices.reserve(totalCount);
+
+		for (GridChunk& chunk : chunks)
+		{
+			outGrid.gridOnIndices.insert(outGrid.gridOnIndices.end(), chunk.indices.begin(), chunk.indices.end());
+			outGrid.gridOnValueIndices.insert(outGrid.gridOnValueIndices.end(), chunk.values.begin(), chunk.values.end());
+
+			chunk = GridChunk();
+		}
+	}
+	else
+	{
+		MergeDownsampledChunks(chunks, factor, background, outputDim, outGrid);
+	}
+
+	if (outGrid.gridOnValueIndices.empty())
+	{
+		outGrid.minValue = outGrid.maxValue = 0.0f;
+	}
+	else
+	{
+		auto minMax = std::minmax_element(outGrid.gridOnValueIndices.begin(), outGrid.gridOnValueIndices.end());
+		outGrid.minValue = *minMax.first;
+		outGrid.maxValue = *minMax.second;
+	}
+
+	return result;
+}
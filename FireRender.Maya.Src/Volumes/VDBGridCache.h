@@ -0,0 +1,123 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <RadeonProRenderLibs/rprLibs/pluginUtils.h>
+
+#include <array>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/** Inclusive region of the vdb index space. */
+struct VDBGridRegion
+{
+	std::array<int, 3> min = { 0, 0, 0 };
+	std::array<int, 3> max = { -1, -1, -1 };
+
+	bool IsEmpty() const { return min[0] > max[0] || min[1] > max[1] || min[2] > max[2]; }
+};
+
+struct VDBGridReadOptions
+{
+	/**
+	 * Only voxels inside of the region are read and the output indices are relative to its min,
+	 * so grids read with the same region are aligned. Whole active region of the grid is read if the region is empty.
+	 */
+	VDBGridRegion clipRegion;
+
+	/** Max voxel count of the output grid, the grid is downsampled by an integer factor to fit into it. 0 - no limit. */
+	size_t voxelBudget = 0;
+
+	/** Forces the downsample factor (to match another grid), voxelBudget is ignored then. 0 - computed from the budget. */
+	int downsampleFactor = 0;
+};
+
+/** Float grid converted to the RPR layout, shared by all volumes using it. */
+struct VDBConvertedGrid
+{
+	/** Indices are relative to region.min and downsampled by downsampleFactor. */
+	VDBGrid<float> grid;
+
+	/** Region of the file grid index space which was read, pass it as clipRegion to read aligned grids. */
+	VDBGridRegion region;
+
+	int downsampleFactor = 1;
+};
+
+/**
+ * Process wide cache of vdb grids converted to the RPR layout, keyed by file path, grid name and read options.
+ * Grids are read again only if the file was modified. Only the converted grids are cached: the file grid is opened
+ * with delayed loading, so leaves outside of the clip region aren't read, but the leaves which are read stay in memory
+ * until the whole grid is converted. Least recently used grids are dropped when the cache gets bigger than the max size.
+ */
+class VDBGridCache
+{
+public:
+	static VDBGridCache& GetInstance();
+
+	VDBGridCache(const VDBGridCache&) = delete;
+	VDBGridCache& operator=(const VDBGridCache&) = delete;
+
+	/** Returns null and fills errorMessage if the grid can't be read. */
+	std::shared_ptr<const VDBConvertedGrid> GetGrid(
+		const std::string& filePath,
+		const std::string& gridName,
+		const VDBGridReadOptions& options,
+		std::string& errorMessage);
+
+	void Clear();
+
+	/** Least recently used grids are dropped right away if the cache is bigger than that. */
+	void SetMaxSizeInBytes(size_t maxSizeInBytes);
+
+	/** Default of the vdbGridCacheSize render setting. */
+	static const size_t DefaultMaxSizeInBytes = size_t(2) * 1024 * 1024 * 1024;
+
+private:
+	VDBGridCache() = default;
+
+	/** Drops least recently used grids until the cache fits into the max size, the last used grid is kept. m_lock must be held. */
+	void Evict();
+
+	void Insert(const std::string& key, std::filesystem::file_time_type modificationTime, std::shared_ptr<const VDBConvertedGrid> grid);
+
+	static std::shared_ptr<const VDBConvertedGrid> ReadGrid(
+		const std::string& filePath,
+		const std::string& gridName,
+		const VDBGridReadOptions& options,
+		std::string& errorMessage);
+
+private:
+	struct Entry
+	{
+		std::filesystem::file_time_type modificationTime;
+		std::shared_ptr<const VDBConvertedGrid> grid;
+		size_t sizeInBytes = 0;
+		std::list<std::string>::iterator lruPosition;
+	};
+
+	std::mutex m_lock;
+
+	std::unordered_map<std::string, Entry> m_entries;
+
+	/** Keys of the entries, most recently used first. */
+	std::list<std::string> m_lru;
+
+	size_t m_sizeInBytes = 0;
+
+	size_t m_maxSizeInBytes = DefaultMaxSizeInBytes;
+};
@@ -30,15 +30,23 @@ limitations under the License.
 #include <RadeonProRenderLibs/rprLibs/pluginUtils.hpp>
 #pragma warning(pop) 
 
+#include "ParallelFor.h"
+#include "VDBGridCache.h"
+
+#include <algorithm>
 #include <array>
+#include <filesystem>
 #include <fstream>
+#include <mutex>
 #include <regex>
+#include <unordered_map>
 
 
 // general
 MObject RPRVolumeAttributes::vdbFile;
 MObject RPRVolumeAttributes::namingSchema;
 MObject RPRVolumeAttributes::loadedGrids;
+MObject RPRVolumeAttributes::voxelBudget;
 
 // channels
 // - albedo
@@ -265,6 +273,12 @@ void RPRVolumeAttributes::Initialize()
 	CHECK_MSTATUS(tAttr.setWritable(true));
 	CHECK_MSTATUS(MPxNode::addAttribute(loadedGrids));
 
+	// - voxel budget (0 means full resolution)
+	voxelBudget = nAttr.create("voxelBudget", "vxbg", MFnNumericData::kInt, 0);
+	setAttribProps(nAttr, voxelBudget);
+	nAttr.setMin(0);
+	nAttr.setSoftMax(100000000);
+
 	// Albedo
 	albedoEnabled = nAttr.create("albedoEnabled", "ealb", MFnNumericData::kBoolean, 0);
 	setAttribProps(nAttr, albedoEnabled);
@@ -374,6 +388,134 @@ MDataHandle RPRVolumeAttributes::GetVolumeVoxelSize(const MFnDependencyNode& nod
 	return MDataHandle();
 }
 
+namespace
+{
+	// Grids smaller than that are processed on the calling thread
+	const size_t MinGridValuesPerThread = 256 * 1024;
+
+	typedef bool(*GridParamsReader)(const std::string& filePath, VDBGridParams& gridParams);
+
+	// Grid parameters of vdb files keyed by path, entry is valid while the file modification time is the same
+	class VDBGridParamsCache
+	{
+	public:
+		// Returns false if the file doesn't exist or can't be read
+		bool Get(const std::string& filePath, VDBGridParams& gridParams, GridParamsReader reader)
+		{
+			std::error_code errorCode;
+			std::filesystem::file_time_type modificationTime = std::filesystem::last_write_time(std::filesystem::u8path(filePath), errorCode);
+			if (errorCode)
+			{
+				gridParams.clear();
+				return false;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(m_lock);
+
+				auto it = m_entries.find(filePath);
+				if (it != m_entries.end() && it->second.modificationTime == modificationTime)
+				{
+					gridParams = it->second.gridParams;
+					return it->second.success;
+				}
+			}
+
+			// Read without the lock, so frames of a sequence can be probed in parallel
+			Entry entry;
+			entry.modificationTime = modificationTime;
+			entry.success = reader(filePath, entry.gridParams);
+
+			gridParams = entry.gridParams;
+			bool success = entry.success;
+
+			std::lock_guard<std::mutex> lock(m_lock);
+			m_entries[filePath] = std::move(entry);
+
+			return success;
+		}
+
+	private:
+		struct Entry
+		{
+			std::filesystem::file_time_type modificationTime;
+			bool success = false;
+			VDBGridParams gridParams;
+		};
+
+		std::mutex m_lock;
+		std::unordered_map<std::string, Entry> m_entries;
+	};
+
+	bool ReadGridParamsFromFile(const std::string& filePath, VDBGridParams& gridParams)
+	{
+		auto res = ReadVolumeDataFromFile(filePath, gridParams);
+		return std::get<bool>(res);
+	}
+
+	// Results of ReadVolumeDataFromFile (reads whole grids)
+	VDBGridParamsCache& GetGridParamsCache()
+	{
+		static VDBGridParamsCache cache;
+		return cache;
+	}
+
+	// Results of the header only probing, only the bounds and voxel sizes are filled
+	VDBGridParamsCache& GetGridBoundsCache()
+	{
+		static VDBGridParamsCache cache;
+		return cache;
+	}
+
+	bool ReadGridParamsCached(const std::string& filePath, VDBGridParams& gridParams)
+	{
+		return GetGridParamsCache().Get(filePath, gridParams, ReadGridParamsFromFile);
+	}
+
+	// Reads grid names, bounds and voxel sizes from the grids metadata without loading the voxels.
+	// Bounds are written by openvdb to the file metadata, whole grids are read if a file doesn't have them
+	bool ReadGridBoundsFromMetadata(const std::string& filePath, VDBGridParams& gridParams)
+	{
+		gridParams.clear();
+
+		try
+		{
+			openvdb::io::File file(filePath);
+			file.open();
+
+			openvdb::GridPtrVecPtr grids = file.readAllGridMetadata();
+			file.close();
+
+			for (const openvdb::GridBase::Ptr& grid : *grids)
+			{
+				auto bboxMax = grid->getMetadata<openvdb::Vec3IMetadata>(openvdb::GridBase::META_FILE_BBOX_MAX);
+				if (!bboxMax)
+				{
+					return ReadGridParamsCached(filePath, gridParams);
+				}
+
+				auto& params = gridParams[grid->getName()];
+				const openvdb::Vec3i& upperBound = bboxMax->value();
+				params.upperBound[0] = upperBound[0];
+				params.upperBound[1] = upperBound[1];
+				params.upperBound[2] = upperBound[2];
+
+				openvdb::Vec3d voxelSize = grid->voxelSize();
+				params.voxelSizeX = voxelSize[0];
+				params.voxelSizeY = voxelSize[1];
+				params.voxelSizeZ = voxelSize[2];
+			}
+		}
+		catch (openvdb::Exception&)
+		{
+			gridParams.clear();
+			return false;
+		}
+
+		return true;
+	}
+}
+
 bool ProcessSchema(int schemaId, int frame, std::string& filePath)
 {
 	const std::string& fileExtension ("vdb");
@@ -468,6 +610,19 @@ std::string RPRVolumeAttributes::GetVDBFilePath(const MFnDependencyNode& node)
 	return out;
 }
 
+size_t RPRVolumeAttributes::GetVoxelBudget(const MFnDependencyNode& node)
+{
+	MPlug plug = node.findPlug(RPRVolumeAttributes::voxelBudget);
+
+	// scenes saved before the attribute was added read full resolution grids
+	if (!plug.isNull())
+	{
+		return (size_t)std::max(plug.asInt(), 0);
+	}
+
+	return 0;
+}
+
 bool RPRVolumeAttributes::GetAlbedoEnabled(const MFnDependencyNode& node)
 {
 	MPlug plug = node.findPlug(RPRVolumeAttributes::albedoEnabled);
@@ -655,8 +810,7 @@ MString RPRVolumeAttributes::GetSelectedAlbedoGridName(const MFnDependencyNode&
 
 	// ensure valid grid is selected
 	VDBGridParams gridParams;
-	auto res = ReadVolumeDataFromFile(filePath, gridParams);
-	if (!std::get<bool>(res))
+	if (!ReadGridParamsCached(filePath, gridParams))
 		failed = true;
 
 	std::string stdStrValue = value.asChar();
@@ -692,8 +846,7 @@ MString RPRVolumeAttributes::GetSelectedDensityGridName(const MFnDependencyNode&
 
 	// ensure valid grid is selected
 	VDBGridParams gridParams;
-	auto res = ReadVolumeDataFromFile(filePath, gridParams);
-	if (!std::get<bool>(res))
+	if (!ReadGridParamsCached(filePath, gridParams))
 		failed = true;
 
 	std::string stdStrValue = value.asChar();
@@ -729,9 +882,8 @@ MString RPRVolumeAttributes::GetSelectedEmissionGridName(const MFnDependencyNode
 
 	// ensure valid grid is selected
 	VDBGridParams gridParams;
-	auto res = ReadVolumeDataFromFile(filePath, gridParams);
-		if (!std::get<bool>(res))
-			failed = true;
+	if (!ReadGridParamsCached(filePath, gridParams))
+		failed = true;
 	
 	std::string stdStrValue = value.asChar();
 	bool found = false;
@@ -811,13 +963,11 @@ void SetVolumeUIVoxelSize(VDBGridSize& dimValues, MPlug& plugToSet)
 	status = childPlug.setDouble(dimValues.voxelSizeZ);
 }
 
-// modify input grid to be used as density and calculate corresponing lookup table
+// process input grid values to be used as density, the source grid is shared and stays unchanged
 void ProcessDensityGrid(
-	std::vector<float>& floatGridOnValueIndices,
-	std::vector<float>& valuesLookUpTable,
+	VDBVolumeGrid& grid,
 	float minVal,
-	float maxVal,
-	float densityMultiplier)
+	float maxVal)
 {
 	float valueScale = (maxVal <= minVal) ? 1.0f : (1.0f / (maxVal - minVal));
 
@@ -827,25 +977,41 @@ void ProcessDensityGrid(
 		offset = -minVal * valueScale;
 	}
 
-	for (float& gridValue : floatGridOnValueIndices)
+	if (valueScale == 1.0f && offset == 0.0f)
+		return;
+
+	const std::vector<float>& sourceValues = grid.source->grid.gridOnValueIndices;
+	grid.processedValues.resize(sourceValues.size());
+
+	RPR::ParallelFor(sourceValues.size(), MinGridValuesPerThread, [&](size_t begin, size_t end)
 	{
-		gridValue = gridValue * valueScale + offset;
-	}
+		for (size_t idx = begin; idx < end; ++idx)
+		{
+			grid.processedValues[idx] = sourceValues[idx] * valueScale + offset;
+		}
+	});
 }
 
-// modify input grid to be used as albedo and calculate corresponing lookup table
+// process input grid values to be used as albedo, the source grid is shared and stays unchanged
 void ProcessTemperatureGrid(
-	std::vector<float>& floatGridOnValueIndices,
+	VDBVolumeGrid& grid,
 	float minVal,
-	float maxVal,
-	float temperatureColorMul = 1.0f)
+	float maxVal)
 {
 	const float temperatureOffset = (minVal < 0) ? -minVal : 0.0f;
+	if (temperatureOffset == 0.0f)
+		return;
 
-	for (float& gridValue : floatGridOnValueIndices)
+	const std::vector<float>& sourceValues = grid.source->grid.gridOnValueIndices;
+	grid.processedValues.resize(sourceValues.size());
+
+	RPR::ParallelFor(sourceValues.size(), MinGridValuesPerThread, [&](size_t begin, size_t end)
 	{
-		gridValue += temperatureOffset;
-	}
+		for (size_t idx = begin; idx < end; ++idx)
+		{
+			grid.processedValues[idx] = sourceValues[idx] + temperatureOffset;
+		}
+	});
 }
 
 void GetMaxGridSize(const std::string& filename, const MFnDependencyNode& node, VDBGridParams& maxGridParams)
@@ -860,25 +1026,47 @@ void GetMaxGridSize(const std::string& filename, const MFnDependencyNode& node,
 
 	MPlug vdbSchemaPlug = node.findPlug(RPRVolumeAttributes::namingSchema);
 	assert(!vdbSchemaPlug.isNull());
-	VDBGridParams gridParams;
-	for (unsigned int tmpFrame = startFrame; tmpFrame < endFrame; ++tmpFrame)
+	int vdbSchema = vdbSchemaPlug.asInt();
+
+	std::vector<std::string> frameFilePaths;
+	for (unsigned int tmpFrame = startFrame; tmpFrame <= endFrame; ++tmpFrame)
 	{
 		std::string tmpFilePath = filename;
 
 		// try find anim file
-		bool success = ProcessSchema(vdbSchemaPlug.asInt(), tmpFrame, tmpFilePath);
+		bool success = ProcessSchema(vdbSchema, tmpFrame, tmpFilePath);
 		if (!success)
 			continue;
 
-		std::ifstream f(tmpFilePath);
-		bool fileExists = f.good();
-		if (!fileExists)
+		frameFilePaths.push_back(tmpFilePath);
+	}
+
+	if (frameFilePaths.empty())
+		return;
+
+	// initialize openvdb; it is necessary to call it before beginning working with vdb
+	openvdb::initialize();
+
+	// probe frames in parallel, only grid metadata is read; results are cached by path and modification time
+	std::vector<VDBGridParams> frameGridParams(frameFilePaths.size());
+	std::vector<char> frameRead(frameFilePaths.size(), 0);
+
+	RPR::ParallelFor(frameFilePaths.size(), 1, [&](size_t begin, size_t end)
+	{
+		for (size_t frameIndex = begin; frameIndex < end; ++frameIndex)
+		{
+			frameRead[frameIndex] = GetGridBoundsCache().Get(frameFilePaths[frameIndex], frameGridParams[frameIndex], ReadGridBoundsFromMetadata);
+		}
+	});
+
+	const VDBGridParams* lastGridParams = nullptr;
+	for (size_t frameIndex = 0; frameIndex < frameFilePaths.size(); ++frameIndex)
+	{
+		if (!frameRead[frameIndex])
 			continue;
 
-		// read file and set grids list with grids from file
-		auto res = ReadVolumeDataFromFile(tmpFilePath, gridParams);
-		if (!std::get<bool>(res))
-			continue; 
+		const VDBGridParams& gridParams = frameGridParams[frameIndex];
+		lastGridParams = &gridParams;
 
 		for (auto it = gridParams.begin(); it != gridParams.end(); ++it)
 		{
@@ -896,8 +1084,11 @@ void GetMaxGridSize(const std::string& filename, const MFnDependencyNode& node,
 		}
 	}
 
+	if (lastGridParams == nullptr)
+		return;
+
 	// save voxel sizes
-	for (auto it = gridParams.begin(); it != gridParams.end(); ++it)
+	for (auto it = lastGridParams->begin(); it != lastGridParams->end(); ++it)
 	{
 		const std::string& gridName = it->first;
 		auto& maxGrid = maxGridParams[gridName];
@@ -923,7 +1114,7 @@ void RPRVolumeAttributes::SetupVolumeFromFile(MObject& node, VDBGridParams& grid
 	}
 
 	// read file and set grids list with grids from file
-	ReadVolumeDataFromFile(filename, gridParams);
+	ReadGridParamsCached(filename, gridParams);
 
 	// write grid names to array attribute
 	// - get array builder
@@ -1054,7 +1245,7 @@ void CopyLookupValue(std::vector<float>& lookupTableOut, const std::vector<MColo
 }
 
 template <typename MayaArrayT, typename valTypeT>
-void SetupLookupTableFromRamp(VDBGrid<float>& dataGrid, MPlug& rampPlug)
+void SetupLookupTableFromRamp(VDBVolumeGrid& dataGrid, MPlug& rampPlug)
 {
 	using MayaElementT = decltype(
 		std::declval<MayaArrayT&>()[std::declval<unsigned int>()]
@@ -1069,11 +1260,33 @@ void SetupLookupTableFromRamp(VDBGrid<float>& dataGrid, MPlug& rampPlug)
 	CopyLookupValue(dataGrid.valuesLookUpTable, remapedRampValue);
 }
 
-void CopyGridSizeValues(VDBGrid<float>& destination, const VDBGridSize& source)
+// sequence max size is in the file voxels, grid can't be made smaller than the converted one
+void CopyGridSizeValues(VDBGridSize& destination, const VDBGridSize& source, int downsampleFactor)
 {
-	destination.size.gridSizeX = source.gridSizeX;
-	destination.size.gridSizeY = source.gridSizeY;
-	destination.size.gridSizeZ = source.gridSizeZ;
+	auto downsample = [downsampleFactor](size_t size) { return (size + downsampleFactor - 1) / downsampleFactor; };
+
+	destination.gridSizeX = std::max<size_t>(destination.gridSizeX, downsample(source.gridSizeX));
+	destination.gridSizeY = std::max<size_t>(destination.gridSizeY, downsample(source.gridSizeY));
+	destination.gridSizeZ = std::max<size_t>(destination.gridSizeZ, downsample(source.gridSizeZ));
+}
+
+namespace
+{
+	// Converted grids are shared with the cache, volumes only keep their processed values
+	bool ReadConvertedGrid(VDBVolumeGrid& outGrid, const std::string& filename, const std::string& gridName, const VDBGridReadOptions& options)
+	{
+		std::string errorMessage;
+		outGrid.source = VDBGridCache::GetInstance().GetGrid(filename, gridName, options, errorMessage);
+
+		if (!outGrid.source)
+		{
+			MGlobal::displayError(MString(errorMessage.c_str()));
+			return false;
+		}
+
+		outGrid.size = outGrid.source->grid.size;
+		return true;
+	}
 }
 
 void RPRVolumeAttributes::FillVolumeData(VDBVolumeData& data, const MObject& node)
@@ -1088,161 +1301,108 @@ void RPRVolumeAttributes::FillVolumeData(VDBVolumeData& data, const MObject& nod
 	GetMaxGridSize(filename, node, maxGridParams);
 	bool treatAsAnimation = maxGridParams.size() > 0;
 
-	// process vdb file
-	// initialize openvdb; it is necessary to call it before beginning working with vdb
-	openvdb::initialize();
-
-	// create a VDB file object.
-	openvdb::io::File file(filename);
-
-	try
-	{
-		// open the file; this reads the file header, but not any grids.
-		file.open();
-	}
-	catch (openvdb::IoError ex)
-	{
-		// display error message in Maya
-		std::string err = ex.what();
-		MGlobal::displayError(MString(err.c_str()));
-
-		return;
-	}
+	// Density is read first, albedo and emission are clipped to its region and downsampled the same way:
+	// there is no volume outside of the density grid, and all grids have to be aligned
+	VDBGridReadOptions readOptions;
+	readOptions.voxelBudget = GetVoxelBudget(depNode);
 
-	try
+	// read density
+	if (GetDensityEnabled(depNode))
 	{
-		// read density
-		if (GetDensityEnabled(depNode))
+		bool failed = false;
+		std::string densityGridName = GetSelectedDensityGridName(depNode, filename, failed).asChar();
+		if (!failed)
 		{
-			bool failed = false;
-			std::string densityGridName = GetSelectedDensityGridName(depNode, filename, failed).asChar();
-			if (!failed)
+			if (ReadConvertedGrid(data.densityGrid, filename, densityGridName, readOptions))
 			{
-				ReadFileGridToVDBGrid(data.densityGrid, file, densityGridName);
+				const VDBConvertedGrid& convertedGrid = *data.densityGrid.source;
+
+				readOptions.clipRegion = convertedGrid.region;
+				readOptions.downsampleFactor = convertedGrid.downsampleFactor;
 
 				if (treatAsAnimation)
 				{
-					CopyGridSizeValues(data.densityGrid, maxGridParams[densityGridName]);
+					CopyGridSizeValues(data.densityGrid.size, maxGridParams[densityGridName], convertedGrid.downsampleFactor);
 				}
 
 				// - setup look up table values
-				ProcessDensityGrid(data.densityGrid.gridOnValueIndices, data.densityGrid.valuesLookUpTable, data.densityGrid.minValue, data.densityGrid.maxValue, GetDensityMultiplier(depNode));
+				ProcessDensityGrid(data.densityGrid, convertedGrid.grid.minValue, convertedGrid.grid.maxValue);
 				MPlug densityRampPlug = RPRVolumeAttributes::GetDensityRamp(node);
 				SetupLookupTableFromRamp<MFloatArray, float>(data.densityGrid, densityRampPlug);
-			} else {
-				MGlobal::displayWarning("invalid density grid value");
 			}
+		} else {
+			MGlobal::displayWarning("invalid density grid value");
 		}
+	}
 
-		// read albedo
-		if (GetAlbedoEnabled(depNode))
+	// read albedo
+	if (GetAlbedoEnabled(depNode))
+	{
+		bool failed = false;
+		std::string albedoGridName = GetSelectedAlbedoGridName(depNode, filename, failed).asChar();
+		if (!failed)
 		{
-			bool failed = false;
-			std::string albedoGridName = GetSelectedAlbedoGridName(depNode, filename, failed).asChar();
-			if (!failed)
+			if (ReadConvertedGrid(data.albedoGrid, filename, albedoGridName, readOptions))
 			{
-				ReadFileGridToVDBGrid(data.albedoGrid, file, albedoGridName);
+				const VDBConvertedGrid& convertedGrid = *data.albedoGrid.source;
 
 				if (treatAsAnimation)
 				{
-					CopyGridSizeValues(data.albedoGrid, maxGridParams[albedoGridName]);
+					CopyGridSizeValues(data.albedoGrid.size, maxGridParams[albedoGridName], convertedGrid.downsampleFactor);
 				}
 
 				// - setup look up table values
-				ProcessTemperatureGrid(data.albedoGrid.gridOnValueIndices, data.albedoGrid.minValue, data.albedoGrid.maxValue);
+				ProcessTemperatureGrid(data.albedoGrid, convertedGrid.grid.minValue, convertedGrid.grid.maxValue);
 				MPlug albedoRampPlug = RPRVolumeAttributes::GetAlbedoRamp(node);
 				SetupLookupTableFromRamp<MColorArray, MColor>(data.albedoGrid, albedoRampPlug);
-			} else {
-				MGlobal::displayWarning("invalid albedo grid value");
 			}
+		} else {
+			MGlobal::displayWarning("invalid albedo grid value");
 		}
+	}
 
-		// read emission
-		if (GetEmissionEnabled(depNode))
+	// read emission
+	if (GetEmissionEnabled(depNode))
+	{
+		bool failed = false;
+		std::string emissionGridName = GetSelectedEmissionGridName(depNode, filename, failed).asChar();
+		if (!failed)
 		{
-			bool failed = false;
-			std::string emissionGridName = GetSelectedEmissionGridName(depNode, filename, failed).asChar();
-			if (!failed)
+			if (ReadConvertedGrid(data.emissionGrid, filename, emissionGridName, readOptions))
 			{
-				ReadFileGridToVDBGrid(data.emissionGrid, file, emissionGridName);
-	
+				const VDBConvertedGrid& convertedGrid = *data.emissionGrid.source;
+
 				if (treatAsAnimation)
 				{
-					CopyGridSizeValues(data.emissionGrid, maxGridParams[emissionGridName]);
+					CopyGridSizeValues(data.emissionGrid.size, maxGridParams[emissionGridName], convertedGrid.downsampleFactor);
 				}
-	
+
 				// - setup look up table values
-				ProcessTemperatureGrid(data.emissionGrid.gridOnValueIndices, data.emissionGrid.minValue, data.emissionGrid.maxValue);
+				ProcessTemperatureGrid(data.emissionGrid, convertedGrid.grid.minValue, convertedGrid.grid.maxValue);
 				MPlug emissionRampPlug = RPRVolumeAttributes::GetEmissionValueRamp(node);
 				SetupLookupTableFromRamp<MColorArray, MColor>(data.emissionGrid, emissionRampPlug);
-			} else {
-				MGlobal::displayWarning("invalid emission grid value");
 			}
+		} else {
+			MGlobal::displayWarning("invalid emission grid value");
 		}
-
-		// close the file.
-		file.close();
-	}
-	catch (openvdb::Exception& ex)
-	{
-		// display error message in Maya
-		std::string err = ex.what();
-		MGlobal::displayError(MString(err.c_str()));
-
-		return;
 	}
 }
 
-template <typename T>
-bool RPRVolumeAttributes::GetSingleGridData(VDBGrid<T>& outGridData, const MObject& node, const std::string& gridName)
+std::shared_ptr<const VDBConvertedGrid> RPRVolumeAttributes::GetSingleGridData(const MObject& node, const std::string& gridName)
 {
 	MFnDependencyNode depNode(node);
 
 	std::string filename = GetVDBFilePath(depNode);
 	if (filename.empty())
-		return false;
+		return nullptr;
 
-	// process vdb file
-	// initialize openvdb; it is necessary to call it before beginning working with vdb
-	openvdb::initialize();
-
-	// create a VDB file object.
-	openvdb::io::File file(filename);
-
-	try
-	{
-		// open the file; this reads the file header, but not any grids.
-		file.open();
-	}
-	catch (openvdb::IoError ex)
-	{
-		// display error message in Maya
-		std::string err = ex.what();
-		MGlobal::displayError(MString(err.c_str()));
-
-		return false;
-	}
+	VDBGridReadOptions readOptions;
+	readOptions.voxelBudget = GetVoxelBudget(depNode);
 
-	try
-	{
-		auto res = ReadFileGridToVDBGrid(outGridData, file, gridName);
-		if (!std::get<bool>(res))
-		{
-			std::string& errMsg = std::get<std::string>(res);
-			MGlobal::displayError(MString(errMsg.c_str()));
-			return false;
-		}
-	}
-	catch (openvdb::Exception& ex)
-	{
-		// display error message in Maya
-		std::string err = ex.what();
-		MGlobal::displayError(MString(err.c_str()));
+	VDBVolumeGrid grid;
+	ReadConvertedGrid(grid, filename, gridName, readOptions);
 
-		return false;
-	}
-
-	return true;
+	return grid.source;
 }
 
 void RPRVolumeAttributes::FillVolumeData(VolumeData& data, const MObject& node, FireMaya::Scope* scope)
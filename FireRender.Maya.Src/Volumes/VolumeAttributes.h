@@ -15,6 +15,7 @@ limitations under the License.
 #include "FireMaya.h"
 #include "FireRenderUtils.h"
 #include "FireRenderVolumeLocator.h"
+#include "VDBGridCache.h"
 
 #include <maya/MObject.h>
 #include <maya/MColor.h>
@@ -27,13 +28,44 @@ limitations under the License.
 #include <vector>
 #include <array>
 
+// Grid of a vdb volume, the converted grid is shared with VDBGridCache and isn't copied
+class VDBVolumeGrid
+{
+public:
+
+	std::shared_ptr<const VDBConvertedGrid> source;
+
+	// may be bigger than the converted grid, so all frames of a sequence have the same size
+	VDBGridSize size;
+
+	// values of the source grid processed for the volume, empty if they are used as they are
+	std::vector<float> processedValues;
+
+	// rgb triplets
+	std::vector<float> valuesLookUpTable;
+
+	bool IsValid(void) const { return source && !source->grid.gridOnValueIndices.empty(); }
+
+	const std::vector<uint32_t>& GetIndices(void) const { return source->grid.gridOnIndices; }
+	const std::vector<float>& GetValues(void) const { return processedValues.empty() ? source->grid.gridOnValueIndices : processedValues; }
+
+	// values which can be changed in place, the source values are copied on the first call
+	std::vector<float>& GetProcessedValues(void)
+	{
+		if (processedValues.empty())
+			processedValues = source->grid.gridOnValueIndices;
+
+		return processedValues;
+	}
+};
+
 class VDBVolumeData // will be templatized to be able to use grids of different type, not just float grids as now
 {
 public:
 
-	VDBGrid<float> densityGrid;
-	VDBGrid<float> albedoGrid;
-	VDBGrid<float> emissionGrid;
+	VDBVolumeGrid densityGrid;
+	VDBVolumeGrid albedoGrid;
+	VDBVolumeGrid emissionGrid;
 
 	bool HasAlbedo(void)	{ return albedoGrid.IsValid();		}
 	bool HasEmission(void)	{ return emissionGrid.IsValid();	}
@@ -193,6 +225,7 @@ public:
 	static MDataHandle GetVolumeGridDimentions(const MFnDependencyNode& node);
 	static MDataHandle GetVolumeVoxelSize(const MFnDependencyNode& node);
 	static std::string GetVDBFilePath(const MFnDependencyNode& node);
+	static size_t GetVoxelBudget(const MFnDependencyNode& node);
 
 	static bool GetAlbedoEnabled(const MFnDependencyNode& node);
 	static VolumeGradient GetAlbedoGradientType(const MFnDependencyNode& node);
@@ -227,8 +260,8 @@ public:
 
 	static void FillVolumeData(VDBVolumeData& data, const MObject& node);
 
-	template <typename T>
-	static bool GetSingleGridData(VDBGrid<T>& outGridData, const MObject& node, const std::string& gridName);
+	// returns null if the grid can't be read
+	static std::shared_ptr<const VDBConvertedGrid> GetSingleGridData(const MObject& node, const std::string& gridName);
 
 public:
 	// General
@@ -236,6 +269,7 @@ public:
 	static MObject vdbFile;
 	static MObject namingSchema;
 	static MObject loadedGrids;
+	static MObject voxelBudget; // max voxel count of the grids sent to RPR, grids are downsampled to fit into it
 
 	/*
 	We will probably eventually add noise parameters to each of inputs below
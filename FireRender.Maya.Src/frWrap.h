@@ -1438,6 +1438,10 @@ namespace frw
 			checkStatus(res);
 		}
 		void SetImage(Image img);
+		Image GetImage() const
+		{
+			return data().image;
+		}
 		void AttachPortal(Shape shape);
 		void DetachPortal(Shape shape);
 		void SetAmbientLight(bool value)
@@ -40,10 +40,13 @@ limitations under the License.
 #include "FireRenderIBL.h"
 #include "FireRenderSkyLocator.h"
 #include "Lights/IES/FireRenderIESLight.h"
+#include "Lights/IES/IESProfileCache.h"
 #include "Lights/PhysicalLight/FireRenderPhysicalLightLocator.h"
 #include "Lights/PhysicalLight/FireRenderPhysicalOverride.h"
 #include "Volumes/FireRenderVolumeLocator.h"
 #include "Volumes/FireRenderVolumeOverride.h"
+#include "Volumes/VDBGridCache.h"
+#include "SkyLayers.h"
 #include "FireRenderEnvironmentLight.h"
 #include "FireRenderOverride.h"
 #include "FireRenderViewport.h"
@@ -72,11 +75,14 @@ limitations under the License.
 #include "FireRenderNoise.h"
 #include "SubsurfaceMaterial.h"
 #include "FireRenderUtils.h"
+#include "Tracing.h"
+#include "SyncStats.h"
 #include "FireRenderShadowCatcherMaterial.h"
 #include "FireRenderAO.h"
 
 #include "FireRenderImportExportXML.h"
 #include "FireRenderImageComparing.h"
+#include "FireRenderSkyBenchmarkCmd.h"
 
 #include <thread>
 #include <sstream>
@@ -197,6 +203,20 @@ void swapToDefaultRenderOverride(void* data) {
 	}
 }
 
+// Release data cached between the renders, it may be stale or unused in the next scene
+void clearSceneCaches()
+{
+	IESProfileCache::GetInstance().Clear();
+	VDBGridCache::GetInstance().Clear();
+	SkyImageCache::GetInstance().Clear();
+}
+
+void beforeNewOrOpenScene(void* data)
+{
+	swapToDefaultRenderOverride(data);
+	clearSceneCaches();
+}
+
 void mayaExiting(void* data)
 {
 	DebugPrint("mayaExiting");
@@ -304,21 +324,65 @@ void PluginUpdater()
 	MGlobal::executePythonCommand(pluginUpdatePy);
 }
 
-void DebugCallback(const char *sz)
+namespace
+{
+	// Set on the plugin initialization, Maya isn't queried from the logger thread
+	bool gIsBatchMode = false;
+
+	/**
+	 * MGlobal::displayInfo isn't thread safe and the logger calls the callbacks on its own thread
+	 * (on the logging thread after Logger::Shutdown). The text is displayed directly on the main thread only,
+	 * other threads queue it as a MEL print. Batch mode doesn't process idle commands, the text goes to the output there.
+	 */
+	void DisplayInfo(const std::string& text)
+	{
+		if (gIsBatchMode)
+		{
+			std::cout << text << std::endl;
+			return;
+		}
+
+		if (FireRenderThread::AreWeOnMainThread())
+		{
+			MGlobal::displayInfo(text.c_str());
+			return;
+		}
+
+		std::string command = "print \"";
+		for (char c : text)
+		{
+			switch (c)
+			{
+			case '\\': command += "\\\\"; break;
+			case '"': command += "\\\""; break;
+			case '\n': command += "\\n"; break;
+			case '\r': break;
+			default: command += c; break;
+			}
+		}
+		command += "\\n\";";
+
+		MGlobal::executeCommandOnIdle(command.c_str());
+	}
+}
+
+void DebugCallback(const Logger::Record& record)
 {
+	// Records are delivered on the logger thread, so the id of the thread which has logged the record is printed
 	std::stringstream ss;
-	ss << std::setbase(16) << std::setw(4) << std::this_thread::get_id() << ": " << sz << std::endl;
+	ss << std::setbase(16) << std::setw(4) << record.threadId << ": " << record.text;
 
 #ifdef _WIN32
+	ss << std::endl;
 	OutputDebugStringA(ss.str().c_str());
 #elif __linux__
-	MGlobal::displayInfo(ss.str().c_str());
+	DisplayInfo(ss.str());
 #endif
 }
 
 void InfoCallback(const char *sz)
 {
-	MGlobal::displayInfo(sz);
+	DisplayInfo(sz);
 }
 
 class FireRenderRenderPass : public MPxNode {
@@ -584,10 +648,15 @@ MStatus initializePlugin(MObject obj)
 	// We have legacy updater here which does not work. Comment this code for now becaue it breaks Maya 2022 startup.
 	//PluginUpdater();
 
+	FireMaya::gMainThreadId = std::this_thread::get_id();
+	gIsBatchMode = MGlobal::mayaState() == MGlobal::kBatch;
+
 	// Added for Linux:
 	Logger::AddCallback(InfoCallback, Logger::LevelInfo);
+	Tracing::SetThreadName("Main thread");
+	Tracing::StartFromEnvironment();
+	SyncStats::EnableFromEnvironment();
 
-	FireMaya::gMainThreadId = std::this_thread::get_id();
 	FireRenderThread::RunTheThread(true);
 
 #ifdef OSMac_
@@ -708,6 +777,7 @@ MStatus initializePlugin(MObject obj)
 	////
 
 	CHECK_MSTATUS(plugin.registerCommand(namePrefix + "ImageComparing", FireRenderImageComparing::creator, FireRenderImageComparing::newSyntax));
+	CHECK_MSTATUS(plugin.registerCommand(namePrefix + "SkyBenchmark", FireRenderSkyBenchmarkCmd::creator, FireRenderSkyBenchmarkCmd::newSyntax));
 
 	CHECK_MSTATUS(plugin.registerNode(namePrefix + "IBL", FireRenderIBL::id,
 		FireRenderIBL::creator, FireRenderIBL::initialize,
@@ -765,9 +835,9 @@ MStatus initializePlugin(MObject obj)
 
 	NewSceneBasicSetup(NULL);
 
-	beforeNewSceneCallback = MSceneMessage::addCallback(MSceneMessage::kBeforeNew, swapToDefaultRenderOverride, NULL, &status);
+	beforeNewSceneCallback = MSceneMessage::addCallback(MSceneMessage::kBeforeNew, beforeNewOrOpenScene, NULL, &status);
 	CHECK_MSTATUS(status);
-	beforeOpenSceneCallback = MSceneMessage::addCallback(MSceneMessage::kBeforeOpen, swapToDefaultRenderOverride, NULL, &status);
+	beforeOpenSceneCallback = MSceneMessage::addCallback(MSceneMessage::kBeforeOpen, beforeNewOrOpenScene, NULL, &status);
 	CHECK_MSTATUS(status);
 
 	mayaExitingCallback = MSceneMessage::addCallback(MSceneMessage::kMayaExiting, mayaExiting, NULL, &status);
@@ -1090,6 +1160,7 @@ MStatus uninitializePlugin(MObject obj)
 	//
 	MString namePrefix(FIRE_RENDER_NODE_PREFIX);
 	CHECK_MSTATUS(plugin.deregisterCommand(namePrefix + "ImageComparing"));
+	CHECK_MSTATUS(plugin.deregisterCommand(namePrefix + "SkyBenchmark"));
 	//
 
 	if (MGlobal::mayaState() != MGlobal::kBatch)
@@ -1110,6 +1181,8 @@ MStatus uninitializePlugin(MObject obj)
 	// Clean up the FireRender command.
 	FireRenderCmd::cleanUp();
 
+	clearSceneCaches();
+
 	//remove main menu
 	if (MGlobal::mayaState() != MGlobal::kBatch)
 	{
@@ -1124,5 +1197,11 @@ MStatus uninitializePlugin(MObject obj)
 	RPRRelease();
 #endif
 
+	// Write the timeline of the session if tracing is still on
+	Tracing::Stop();
+
+	// Stop the logger thread while the plugin code is still loaded
+	Logger::Shutdown();
+
 	return status;
 }
@@ -0,0 +1,196 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "stdafx.h"
+
+#include "Volumes/GridValues.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+	// Pseudo random values in [0, 4), so the grid gets normalized
+	std::vector<float> SyntheticGridValues(size_t count)
+	{
+		std::vector<float> values(count);
+		for (size_t idx = 0; idx < count; idx++)
+		{
+			values[idx] = 4.0f * (float)((idx * 2654435761u) % 1000003) / 1000003.0f;
+		}
+
+		return values;
+	}
+
+	// Rgb triplets, only red is used
+	std::vector<float> SyntheticLookupTable(size_t count)
+	{
+		std::vector<float> lookupTable(count * 3);
+		for (size_t idx = 0; idx < count; idx++)
+		{
+			float value = sqrtf(idx / (float)(count - 1));
+			lookupTable[idx * 3] = value;
+			lookupTable[idx * 3 + 1] = value;
+			lookupTable[idx * 3 + 2] = value;
+		}
+
+		return lookupTable;
+	}
+
+	// Serial normalization and lookup as they were done before the grid processing was parallel
+	void ReferenceNormalizeAndLookup(std::vector<float>& values, const std::vector<float>& lookupTable)
+	{
+		float maxValue = *std::max_element(values.begin(), values.end());
+		if (maxValue > 1.0f)
+		{
+			for (float& value : values)
+			{
+				value /= maxValue;
+			}
+		}
+
+		size_t count = lookupTable.size() / 3;
+		float step = 1.0f / (count - 1);
+
+		for (float& value : values)
+		{
+			size_t left = std::min((size_t)floorf(value / step), count - 1);
+			size_t right = std::min(left + 1, count - 1);
+
+			value = value * (lookupTable[left * 3] + lookupTable[right * 3]) / 2.0f;
+		}
+	}
+
+	float MaxError(const std::vector<float>& a, const std::vector<float>& b)
+	{
+		float maxError = 0.0f;
+		for (size_t idx = 0; idx < a.size(); idx++)
+		{
+			maxError = std::max(maxError, fabsf(a[idx] - b[idx]));
+		}
+
+		return maxError;
+	}
+}
+
+namespace FireRenderUnitTests
+{
+	TEST_CLASS(GridValuesTests)
+	{
+	public:
+		TEST_METHOD(NormalizeScalesToUnitRange)
+		{
+			std::vector<float> values = SyntheticGridValues(1000000);
+			float maxValue = *std::max_element(values.begin(), values.end());
+
+			std::vector<float> expected = values;
+			for (float& value : expected)
+			{
+				value /= maxValue;
+			}
+
+			NormalizeGridValues(values);
+
+			Assert::IsTrue(values == expected);
+		}
+
+		TEST_METHOD(NormalizeKeepsUnitRange)
+		{
+			std::vector<float> values = { 0.0f, 0.25f, 1.0f };
+
+			NormalizeGridValues(values);
+
+			Assert::IsTrue(values == std::vector<float>({ 0.0f, 0.25f, 1.0f }));
+		}
+
+		TEST_METHOD(NormalizeToSeparateVector)
+		{
+			const std::vector<float> source = SyntheticGridValues(1000000);
+
+			std::vector<float> expected = source;
+			NormalizeGridValues(expected);
+
+			std::vector<float> normalized;
+			Assert::IsTrue(NormalizeGridValues(source, normalized));
+			Assert::IsTrue(normalized == expected);
+
+			// nothing is written if the values are in range
+			std::vector<float> unchanged;
+			Assert::IsFalse(NormalizeGridValues(expected, unchanged));
+			Assert::IsTrue(unchanged.empty());
+		}
+
+		TEST_METHOD(LookupMatchesSerialReference)
+		{
+			// Small grids are processed on the calling thread, large ones are split
+			for (size_t count : { (size_t)1000, (size_t)3000000 })
+			{
+				std::vector<float> lookupTable = SyntheticLookupTable(100);
+
+				std::vector<float> expected = SyntheticGridValues(count);
+				ReferenceNormalizeAndLookup(expected, lookupTable);
+
+				std::vector<float> values = SyntheticGridValues(count);
+				NormalizeGridValues(values);
+				ApplyDensityLookupTable(values, lookupTable);
+
+				Assert::IsTrue(MaxError(values, expected) < 1e-6f);
+			}
+		}
+	};
+
+	TEST_CLASS(GridValuesBenchmark)
+	{
+	public:
+		BEGIN_TEST_CLASS_ATTRIBUTE()
+			TEST_CLASS_ATTRIBUTE(L"Category", L"Benchmark")
+		END_TEST_CLASS_ATTRIBUTE()
+
+		TEST_METHOD(NormalizeAndLookup)
+		{
+			// 256^3 grid
+			const size_t count = 256 * 256 * 256;
+
+			std::vector<float> lookupTable = SyntheticLookupTable(100);
+			std::vector<float> source = SyntheticGridValues(count);
+
+			auto measure = [](auto&& process)
+			{
+				auto start = std::chrono::steady_clock::now();
+				process();
+				return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			};
+
+			std::vector<float> expected = source;
+			double serialMs = measure([&] { ReferenceNormalizeAndLookup(expected, lookupTable); });
+
+			std::vector<float> values = source;
+			double parallelMs = measure([&]
+			{
+				NormalizeGridValues(values);
+				ApplyDensityLookupTable(values, lookupTable);
+			});
+
+			std::wstring message = L"Grid of " + std::to_wstring(count) +
+				L" values: serial " + std::to_wstring(serialMs) +
+				L" ms, parallel " + std::to_wstring(parallelMs) +
+				L" ms, max error " + std::to_wstring(MaxError(values, expected)) + L"\n";
+
+			Logger::WriteMessage(message.c_str());
+		}
+	};
+}
@@ -0,0 +1,241 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "stdafx.h"
+
+#include "HairCurvesBuilder.h"
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+	// Points, widths and strand ranges of a generated groom
+	struct SyntheticGroom
+	{
+		std::vector<float> points;
+		std::vector<float> width;
+		std::vector<float> uvCoord;
+		HairStrandsSource source;
+
+		SyntheticGroom(size_t strandCount, unsigned int minLength, unsigned int maxLength, unsigned int seed)
+		{
+			std::mt19937 generator(seed);
+			std::uniform_int_distribution<unsigned int> lengthDistribution(minLength, maxLength);
+			std::uniform_real_distribution<float> valueDistribution(0.0f, 1.0f);
+
+			unsigned int pointCount = 0;
+			for (size_t strandIdx = 0; strandIdx < strandCount; ++strandIdx)
+			{
+				unsigned int length = lengthDistribution(generator);
+
+				source.offsets.push_back(pointCount);
+				source.lengths.push_back(length);
+				source.uvOffsets.push_back(strandIdx * 2);
+				pointCount += length;
+			}
+			source.uvOffsets.push_back(strandCount * 2);
+
+			points.resize((size_t)pointCount * 3);
+			width.resize(pointCount);
+			uvCoord.resize(strandCount * 2);
+
+			for (float& value : points)
+				value = valueDistribution(generator);
+
+			for (float& value : width)
+				value = valueDistribution(generator);
+
+			for (float& value : uvCoord)
+				value = valueDistribution(generator);
+
+			source.points = points.data();
+			source.width = width.data();
+			source.uvCoord = uvCoord.data();
+		}
+	};
+
+	// Reference implementation, the per-strand push_back path which was used before the batch builder
+
+	void ProcessHairPoints(std::vector<unsigned int>& outCurveIndicesData, unsigned int offset, unsigned int length)
+	{
+		unsigned int currIdx = offset;
+		for (unsigned int idx = 0; idx < length; idx++)
+		{
+			outCurveIndicesData.push_back(currIdx++);
+
+			// duplicate index of last point in segment if necessary
+			if (outCurveIndicesData.size() % PointsPerSegment != 0)
+				continue;
+
+			if (idx < (length - 1))
+				outCurveIndicesData.push_back(outCurveIndicesData.back());
+		}
+	}
+
+	void ProcessHairTail(std::vector<unsigned int>& outCurveIndicesData)
+	{
+		unsigned int tail = outCurveIndicesData.size() % PointsPerSegment;
+		if (tail != 0)
+			tail = PointsPerSegment - tail;
+
+		for (unsigned int idx = 0; idx < tail; idx++)
+		{
+			outCurveIndicesData.push_back(outCurveIndicesData.back());
+		}
+	}
+
+	void ProcessHairWidth(std::vector<float>& outRadiuses, const float* width, const std::vector<unsigned int>& curveIndicesData)
+	{
+		const unsigned int segmentsInCurve = (unsigned int)(curveIndicesData.size()) / PointsPerSegment;
+
+		for (unsigned int idx = 0; idx < segmentsInCurve; ++idx)
+		{
+			outRadiuses.push_back(width[curveIndicesData[idx * PointsPerSegment]] * 0.5f);
+			outRadiuses.push_back(width[curveIndicesData[idx * PointsPerSegment + (PointsPerSegment - 1)]] * 0.5f);
+		}
+	}
+
+	void BuildReference(const HairStrandsSource& source, CurvesBatchData& batchData)
+	{
+		for (size_t strandIdx = 0; strandIdx < source.StrandCount(); ++strandIdx)
+		{
+			if (source.lengths[strandIdx] == 0)
+			{
+				batchData.m_numPointsPerSegment.push_back(0);
+				continue;
+			}
+
+			std::vector<unsigned int> curveIndicesData;
+			ProcessHairPoints(curveIndicesData, source.offsets[strandIdx], source.lengths[strandIdx]);
+			ProcessHairTail(curveIndicesData);
+
+			batchData.m_numPointsPerSegment.push_back((int)curveIndicesData.size() / PointsPerSegment);
+			ProcessHairWidth(batchData.m_radiuses, source.width, curveIndicesData);
+			batchData.m_indicesData.insert(batchData.m_indicesData.end(), curveIndicesData.begin(), curveIndicesData.end());
+		}
+	}
+
+	template <typename Func>
+	double MeasureMs(Func&& func)
+	{
+		auto start = std::chrono::steady_clock::now();
+		func();
+
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+namespace FireRenderUnitTests
+{
+	TEST_CLASS(HairCurvesBuilderTests)
+	{
+	public:
+		TEST_METHOD(SegmentCount)
+		{
+			Assert::AreEqual(0u, GetHairSegmentCount(0));
+			Assert::AreEqual(1u, GetHairSegmentCount(1));
+			Assert::AreEqual(1u, GetHairSegmentCount(4));
+			Assert::AreEqual(2u, GetHairSegmentCount(5));
+			Assert::AreEqual(2u, GetHairSegmentCount(7));
+			Assert::AreEqual(3u, GetHairSegmentCount(8));
+		}
+
+		TEST_METHOD(BatchMatchesReference)
+		{
+			// Empty and single point strands included
+			SyntheticGroom groom(5000, 0, 23, 1);
+
+			CurvesBatchData expected;
+			BuildReference(groom.source, expected);
+
+			CurvesBatchData actual;
+			actual.Init(groom.source, 0, groom.source.StrandCount());
+
+			Assert::IsTrue(expected.m_numPointsPerSegment == actual.m_numPointsPerSegment);
+			Assert::IsTrue(expected.m_indicesData == actual.m_indicesData);
+			Assert::IsTrue(expected.m_radiuses == actual.m_radiuses);
+			Assert::IsTrue(groom.uvCoord == actual.m_uvCoord);
+			Assert::AreEqual((size_t)groom.width.size(), (size_t)actual.m_pointCount);
+		}
+
+		TEST_METHOD(ChunkIndicesAreRelativeToChunk)
+		{
+			SyntheticGroom groom(300, 1, 9, 2);
+
+			const size_t firstStrand = 100;
+			const size_t endStrand = 200;
+
+			CurvesBatchData chunk;
+			chunk.Init(groom.source, firstStrand, endStrand);
+
+			unsigned int firstPoint = groom.source.offsets[firstStrand];
+			unsigned int endPoint = groom.source.offsets[endStrand];
+
+			Assert::IsTrue(chunk.m_points == groom.points.data() + (size_t)firstPoint * 3);
+			Assert::AreEqual(endPoint - firstPoint, chunk.m_pointCount);
+			Assert::AreEqual(endStrand - firstStrand, chunk.m_numPointsPerSegment.size());
+			Assert::AreEqual((endStrand - firstStrand) * 2, chunk.m_uvCoord.size());
+
+			for (unsigned int index : chunk.m_indicesData)
+			{
+				Assert::IsTrue(index < chunk.m_pointCount);
+			}
+		}
+	};
+
+	TEST_CLASS(HairCurvesBuilderBenchmark)
+	{
+	public:
+		BEGIN_TEST_CLASS_ATTRIBUTE()
+			TEST_CLASS_ATTRIBUTE(L"Category", L"Benchmark")
+		END_TEST_CLASS_ATTRIBUTE()
+
+		TEST_METHOD(BuildSyntheticGroom)
+		{
+			// About 10M points, several chunks
+			SyntheticGroom groom(600 * 1000, 8, 24, 3);
+
+			const size_t strandCount = groom.source.StrandCount();
+			size_t builtStrandCount = 0;
+
+			double referenceMs = MeasureMs([&]
+			{
+				CurvesBatchData batchData;
+				BuildReference(groom.source, batchData);
+			});
+
+			double builderMs = MeasureMs([&]
+			{
+				for (size_t firstStrand = 0; firstStrand < strandCount; firstStrand += StrandsPerChunk)
+				{
+					CurvesBatchData batchData;
+					batchData.Init(groom.source, firstStrand, std::min(firstStrand + StrandsPerChunk, strandCount));
+
+					builtStrandCount += batchData.m_numPointsPerSegment.size();
+				}
+			});
+
+			Assert::AreEqual(strandCount, builtStrandCount);
+
+			std::wstring message = std::to_wstring(strandCount) + L" strands, " + std::to_wstring(groom.width.size()) +
+				L" points: push_back reference " + std::to_wstring(referenceMs) +
+				L" ms, batch builder " + std::to_wstring(builderMs) + L" ms\n";
+
+			Logger::WriteMessage(message.c_str());
+		}
+	};
+}
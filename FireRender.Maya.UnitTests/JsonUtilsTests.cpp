@@ -0,0 +1,55 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "stdafx.h"
+
+#include "JsonUtils.h"
+
+#include <sstream>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+	std::string ToJsonString(const std::string& str)
+	{
+		std::ostringstream out;
+		WriteJsonString(out, str);
+		return out.str();
+	}
+}
+
+namespace FireRenderUnitTests
+{
+	TEST_CLASS(JsonUtilsTests)
+	{
+	public:
+		TEST_METHOD(PlainStringIsQuoted)
+		{
+			Assert::IsTrue(ToJsonString("pSphereShape1") == "\"pSphereShape1\"");
+			Assert::IsTrue(ToJsonString("") == "\"\"");
+		}
+
+		TEST_METHOD(SpecialCharactersAreEscaped)
+		{
+			Assert::IsTrue(ToJsonString("C:\\textures\\\"wood\".png") == "\"C:\\\\textures\\\\\\\"wood\\\".png\"");
+			Assert::IsTrue(ToJsonString("a\nb\rc\td") == "\"a\\nb\\rc\\td\"");
+			Assert::IsTrue(ToJsonString(std::string("\x01\x1f", 2)) == "\"\\u0001\\u001f\"");
+		}
+
+		TEST_METHOD(Utf8IsWrittenAsIs)
+		{
+			Assert::IsTrue(ToJsonString("\xD0\xBC\xD1\x8F\xD1\x87") == "\"\xD0\xBC\xD1\x8F\xD1\x87\"");
+		}
+	};
+}
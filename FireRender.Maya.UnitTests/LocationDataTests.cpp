@@ -0,0 +1,236 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "stdafx.h"
+
+#include "LocationData.h"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+	// Small alphabet, so that names share many trigrams
+	std::string RandomName(std::mt19937& generator)
+	{
+		static const char letters[] = "abcde fgh";
+
+		std::uniform_int_distribution<int> lengthDistribution(1, 16);
+		std::uniform_int_distribution<int> letterDistribution(0, sizeof(letters) - 2);
+
+		std::string name(lengthDistribution(generator), ' ');
+		for (char& c : name)
+		{
+			c = letters[letterDistribution(generator)];
+		}
+
+		return name;
+	}
+
+	LocationData::Point RandomPoint(std::mt19937& generator)
+	{
+		// Slightly out of the valid range to cover clamping to the border grid cells
+		std::uniform_real_distribution<float> x(-185.0f, 185.0f);
+		std::uniform_real_distribution<float> y(-95.0f, 95.0f);
+
+		return { x(generator), y(generator) };
+	}
+
+	LocationData RandomLocationData(unsigned int seed)
+	{
+		std::mt19937 generator(seed);
+
+		std::vector<LocationData::Location> locations(5000);
+		for (LocationData::Location& location : locations)
+		{
+			location = { RandomName(generator), 0.0f, 0.0f, 0.0f, 0 };
+		}
+
+		std::uniform_real_distribution<float> sizeDistribution(0.5f, 40.0f);
+		std::uniform_int_distribution<int> vertexCountDistribution(3, 12);
+
+		std::vector<LocationData::TimeZone> timeZones(400);
+		for (size_t i = 0; i < timeZones.size(); i++)
+		{
+			LocationData::TimeZone& timeZone = timeZones[i];
+			timeZone.name = std::to_string(i);
+			timeZone.utcOffset = (float)i;
+
+			LocationData::Point center = RandomPoint(generator);
+
+			if (i % 2 == 0)
+			{
+				timeZone.type = LocationData::RECTANGLE;
+				timeZone.vertices = { center, { center.x + sizeDistribution(generator), center.y - sizeDistribution(generator) } };
+			}
+			else
+			{
+				// Star shaped polygon around the center, may be self intersecting
+				timeZone.type = LocationData::POLYGON;
+
+				int vertexCount = vertexCountDistribution(generator);
+				for (int j = 0; j < vertexCount; j++)
+				{
+					float angle = 6.2831853f * j / vertexCount;
+					float radius = sizeDistribution(generator);
+					timeZone.vertices.push_back({ center.x + radius * cosf(angle), center.y + radius * sinf(angle) });
+				}
+			}
+		}
+
+		LocationData data;
+		data.set({ "country" }, std::move(locations), std::move(timeZones));
+
+		return data;
+	}
+
+	void WriteString(std::ofstream& file, const std::string& str)
+	{
+		int length = (int)str.size();
+		file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+		file.write(str.data(), length);
+	}
+
+	template <typename T>
+	void WriteValue(std::ofstream& file, T value)
+	{
+		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+}
+
+namespace FireRenderUnitTests
+{
+	TEST_CLASS(LocationDataTests)
+	{
+	public:
+		TEST_METHOD(TrigramSearchMatchesLinearSearch)
+		{
+			LocationData data = RandomLocationData(1);
+			std::mt19937 generator(2);
+
+			for (int i = 0; i < 2000; i++)
+			{
+				std::string search = RandomName(generator).substr(0, i % 7);
+
+				Assert::IsTrue(data.findLocations(search) == data.findLocationsLinear(search));
+			}
+
+			// Substrings of existing names always match
+			for (int i = 0; i < 500; i++)
+			{
+				const std::string& name = data.locations()[i].name;
+				std::string search = name.substr(i % name.size());
+
+				std::vector<int> indices = data.findLocations(search);
+
+				Assert::IsTrue(indices == data.findLocationsLinear(search));
+				Assert::IsFalse(indices.empty());
+			}
+		}
+
+		TEST_METHOD(GridTimeZoneLookupMatchesLinearLookup)
+		{
+			LocationData data = RandomLocationData(3);
+			std::mt19937 generator(4);
+
+			int found = 0;
+
+			for (int i = 0; i < 20000; i++)
+			{
+				LocationData::Point point = RandomPoint(generator);
+
+				int index = data.findTimeZone(point.x, point.y);
+				Assert::AreEqual(data.findTimeZoneLinear(point.x, point.y), index);
+
+				found += index >= 0 ? 1 : 0;
+			}
+
+			// Vertices are on the boundaries, the first matching time zone must be the same too
+			for (const LocationData::TimeZone& timeZone : data.timeZones())
+			{
+				for (const LocationData::Point& point : timeZone.vertices)
+				{
+					Assert::AreEqual(data.findTimeZoneLinear(point.x, point.y), data.findTimeZone(point.x, point.y));
+				}
+			}
+
+			Assert::IsTrue(found > 0);
+		}
+
+		TEST_METHOD(LoadDataFiles)
+		{
+			std::filesystem::path folder = std::filesystem::temp_directory_path() / "RprLocationDataTest";
+			std::filesystem::create_directories(folder);
+
+			{
+				std::ofstream file(folder / "countries.dat", std::ios::binary);
+				WriteValue(file, 2);
+				WriteString(file, "first");
+				WriteString(file, "second");
+			}
+
+			{
+				std::ofstream file(folder / "locations.dat", std::ios::binary);
+				WriteValue(file, 2);
+				WriteString(file, "new york");
+				WriteValue(file, 40.7f);
+				WriteValue(file, -74.0f);
+				WriteValue(file, -5.0f);
+				WriteValue(file, 1);
+				// country index out of range is reset to the first country
+				WriteString(file, "york");
+				WriteValue(file, 53.9f);
+				WriteValue(file, -1.1f);
+				WriteValue(file, 0.0f);
+				WriteValue(file, 7);
+			}
+
+			{
+				std::ofstream file(folder / "time_zones.dat", std::ios::binary);
+				WriteValue(file, 1);
+				WriteString(file, "eastern");
+				WriteValue(file, (int)LocationData::RECTANGLE);
+				WriteValue(file, -5.0f);
+				WriteValue(file, 2);
+				for (float value : { -80.0f, 45.0f, -70.0f, 35.0f })
+				{
+					WriteValue(file, value);
+				}
+			}
+
+			LocationData data;
+			data.load((folder / "").u8string());
+
+			std::filesystem::remove_all(folder);
+
+			Assert::AreEqual((size_t)2, data.countries().size());
+			Assert::IsTrue(data.countries()[1] == "second");
+
+			Assert::AreEqual((size_t)2, data.locations().size());
+			Assert::AreEqual(1, data.locations()[0].countryIndex);
+			Assert::AreEqual(0, data.locations()[1].countryIndex);
+			Assert::AreEqual(-74.0f, data.locations()[0].longitude);
+
+			Assert::IsTrue(data.findLocations("york") == std::vector<int>({ 0, 1 }));
+			Assert::IsTrue(data.findLocations("new") == std::vector<int>({ 0 }));
+
+			Assert::AreEqual(0, data.findTimeZone(-74.0f, 40.7f));
+			Assert::AreEqual(-1, data.findTimeZone(-1.1f, 53.9f));
+		}
+	};
+}
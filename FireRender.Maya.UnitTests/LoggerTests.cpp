@@ -0,0 +1,224 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "stdafx.h"
+
+#include "Logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The plugin Logger class would be ambiguous with the test framework Logger
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+
+namespace
+{
+	std::vector<Logger::Record> deliveredRecords;
+	std::atomic<size_t> deliveredRecordCount { 0 };
+
+	std::thread::id callbackThreadId;
+
+	void CollectRecord(const Logger::Record& record)
+	{
+		// Callbacks are called on a single thread at a time
+		deliveredRecords.push_back(record);
+		callbackThreadId = std::this_thread::get_id();
+	}
+
+	void CountRecord(const char*)
+	{
+		deliveredRecordCount++;
+	}
+
+	std::atomic<size_t> shutdownRecordCount { 0 };
+
+	void CountShutdownRecord(const char*)
+	{
+		shutdownRecordCount++;
+	}
+
+	/** Logger::Printf before the background sink, it formatted into a new 64 KB buffer and dispatched on the calling thread. */
+	template <typename... Args>
+	void LegacyPrintf(const char* format, const Args&... args)
+	{
+		std::vector<char> buf;
+		buf.resize(0x10000);
+		snprintf(buf.data(), buf.size(), format, args...);
+		CountRecord(buf.data());
+	}
+
+	template <class Func>
+	double MeasureNanosecondsPerCall(int count, Func func)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < count; i++)
+		{
+			func(i);
+		}
+
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+	}
+}
+
+namespace FireRenderUnitTests
+{
+	TEST_CLASS(LoggerTests)
+	{
+	public:
+		TEST_METHOD_CLEANUP(RemoveCallbacks)
+		{
+			Logger::RemoveCallback(CollectRecord);
+			deliveredRecords.clear();
+		}
+
+		TEST_METHOD(RecordsAreDeliveredInOrder)
+		{
+			const int count = 10000;
+
+			Logger::AddCallback(CollectRecord, Logger::LevelInfo);
+
+			Logger::Fields fields;
+			fields.frame = 3;
+			fields.object = "pSphereShape1";
+
+			for (int i = 0; i < count; i++)
+			{
+				Logger::Printf(Logger::LevelInfo, fields, "Mesh %d", i);
+			}
+
+			// Longer than the initial format buffer
+			std::string longMessage(100000, 'x');
+			Logger::Printf(Logger::LevelError, "%s", longMessage.c_str());
+
+			Logger::Flush();
+
+			Assert::AreEqual((size_t)count + 1, deliveredRecords.size());
+
+			for (int i = 0; i < count; i++)
+			{
+				const Logger::Record& record = deliveredRecords[i];
+
+				Assert::IsTrue(record.message == "Mesh " + std::to_string(i));
+				Assert::IsTrue(record.object == "pSphereShape1");
+				Assert::AreEqual(3, record.frame);
+				Assert::IsTrue(record.threadId == std::this_thread::get_id());
+			}
+
+			Assert::IsTrue(deliveredRecords.back().message == longMessage);
+
+			// Delivered by the background thread
+			Assert::IsTrue(callbackThreadId != std::this_thread::get_id());
+		}
+
+		TEST_METHOD(DisabledLevelsAreNotDelivered)
+		{
+			Logger::AddCallback(CollectRecord, Logger::LevelError);
+
+			Logger::Printf(Logger::LevelInfo, "Info");
+			Logger::Printf(Logger::LevelError, "Error");
+			Logger::Flush();
+
+			Assert::AreEqual((size_t)1, deliveredRecords.size());
+			Assert::IsTrue(deliveredRecords[0].message == "Error");
+		}
+
+		TEST_METHOD(RecordsLoggedDuringShutdownAreDelivered)
+		{
+			const int threadCount = 4;
+			const int count = 20000;
+
+			Logger::AddCallback(CountShutdownRecord, Logger::LevelInfo);
+
+			std::atomic<int> startedThreads { 0 };
+			std::vector<std::thread> threads;
+
+			for (int t = 0; t < threadCount; t++)
+			{
+				threads.emplace_back([&]()
+				{
+					startedThreads++;
+
+					for (int i = 0; i < count; i++)
+					{
+						Logger::Printf(Logger::LevelInfo, "Record %d", i);
+					}
+				});
+			}
+
+			while (startedThreads.load() < threadCount)
+			{
+				std::this_thread::yield();
+			}
+
+			// Records after this point are dispatched synchronously, none of them may stay in the queue
+			Logger::Shutdown();
+
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+
+			Logger::RemoveCallback(CountShutdownRecord);
+
+			// The following tests check the background thread
+			Logger::Restart();
+
+			Assert::AreEqual((size_t)threadCount * count, shutdownRecordCount.load());
+		}
+	};
+
+	TEST_CLASS(LoggerBenchmark)
+	{
+	public:
+		BEGIN_TEST_CLASS_ATTRIBUTE()
+			TEST_CLASS_ATTRIBUTE(L"Category", L"Benchmark")
+		END_TEST_CLASS_ATTRIBUTE()
+
+		TEST_METHOD(DisabledAndEnabledLevels)
+		{
+			const int count = 200000;
+
+			Logger::Fields fields;
+			fields.frame = 1;
+			fields.object = "pSphereShape1";
+			fields.phase = "sync";
+
+			// Nothing listens to the debug level here
+			double disabledNs = MeasureNanosecondsPerCall(count, [&](int i) { Logger::Printf(Logger::LevelDebug, fields, "Mesh %d: %d vertices", i, i * 3); });
+
+			double legacyNs = MeasureNanosecondsPerCall(count, [&](int i) { LegacyPrintf("Mesh %d: %d vertices", i, i * 3); });
+
+			Logger::AddCallback(CountRecord, Logger::LevelDebug);
+			deliveredRecordCount = 0;
+
+			auto start = std::chrono::steady_clock::now();
+			double enabledNs = MeasureNanosecondsPerCall(count, [&](int i) { Logger::Printf(Logger::LevelDebug, fields, "Mesh %d: %d vertices", i, i * 3); });
+			Logger::Flush();
+			double sinkMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			Logger::RemoveCallback(CountRecord);
+
+			Assert::AreEqual((size_t)count, deliveredRecordCount.load());
+
+			std::wstring message = L"Disabled level " + std::to_wstring(disabledNs) +
+				L" ns per call, legacy synchronous formatting " + std::to_wstring(legacyNs) +
+				L" ns per call, enabled level " + std::to_wstring(enabledNs) +
+				L" ns per call on the calling thread, " + std::to_wstring(count / (sinkMs / 1000.0)) + L" records per second\n";
+
+			Microsoft::VisualStudio::CppUnitTestFramework::Logger::WriteMessage(message.c_str());
+		}
+	};
+}
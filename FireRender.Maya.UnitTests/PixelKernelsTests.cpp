@@ -0,0 +1,286 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "stdafx.h"
+
+#include "PixelKernels.h"
+
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+	const unsigned int FrameWidth = 1937;
+	const unsigned int FrameHeight = 1091;
+
+	// Odd sizes so that the vector kernels run their scalar tails too
+	const RenderRegion SubRegion(13, 13 + 601, 17 + 333, 17);
+
+	std::vector<float> RandomPixels(size_t pixelCount, unsigned int seed)
+	{
+		std::mt19937 generator(seed);
+		std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+		std::vector<float> pixels(pixelCount * 4);
+		for (float& value : pixels)
+		{
+			value = distribution(generator);
+		}
+
+		return pixels;
+	}
+
+	// Reference implementations, the loops which were used before the kernels
+
+	void CopyRegionReference(float* dest, const float* source, unsigned int sourceWidth, unsigned int sourceHeight, const RenderRegion& region)
+	{
+		unsigned int regionWidth = region.getWidth();
+		unsigned int regionHeight = region.getHeight();
+
+		for (unsigned int y = 0; y < regionHeight; y++)
+		{
+			unsigned int destIndex = y * regionWidth;
+			unsigned int sourceIndex = (sourceHeight - (region.top - y) - 1) * sourceWidth + region.left;
+
+			memcpy(&dest[destIndex * 4], &source[sourceIndex * 4], sizeof(float) * 4 * regionWidth);
+		}
+	}
+
+	void FlipRegionReference(float* dest, const float* source, unsigned int sourceWidth, unsigned int sourceHeight, const RenderRegion& region)
+	{
+		unsigned int destWidth = region.getWidth();
+		unsigned int destHeight = region.getHeight();
+
+		for (unsigned int y = 0; y < destHeight; ++y)
+		{
+			unsigned int sourceIndex = sourceHeight > destHeight ?
+				(y + sourceHeight - region.top - 1) * sourceWidth + region.left :
+				y * sourceWidth;
+
+			memcpy(&dest[(destHeight - y - 1) * destWidth * 4], &source[sourceIndex * 4], sizeof(float) * 4 * destWidth);
+		}
+	}
+
+	void PasteRegionReference(float* dest, const float* source, unsigned int destWidth, unsigned int destHeight, const RenderRegion& region)
+	{
+		unsigned int regionWidth = region.getWidth();
+		unsigned int regionHeight = region.getHeight();
+
+		for (unsigned int y = 0; y < regionHeight; y++)
+		{
+			unsigned int sourceIndex = y * regionWidth;
+			unsigned int destIndex = region.left + (y + destHeight - region.top - 1) * destWidth;
+
+			memcpy(&dest[destIndex * 4], &source[sourceIndex * 4], sizeof(float) * 4 * regionWidth);
+		}
+	}
+
+	void MergeOpacityReference(float* pixels, const float* opacityPixels, size_t pixelCount)
+	{
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			pixels[i * 4 + 3] = opacityPixels[i * 4];
+		}
+	}
+
+	std::vector<PixelKernels::InstructionSet> SupportedInstructionSets()
+	{
+		std::vector<PixelKernels::InstructionSet> result;
+
+		for (PixelKernels::InstructionSet instructionSet : { PixelKernels::InstructionSet::Scalar, PixelKernels::InstructionSet::SSE, PixelKernels::InstructionSet::AVX2 })
+		{
+			if (instructionSet <= PixelKernels::GetSupportedInstructionSet())
+			{
+				result.push_back(instructionSet);
+			}
+		}
+
+		return result;
+	}
+
+	const wchar_t* InstructionSetName(PixelKernels::InstructionSet instructionSet)
+	{
+		switch (instructionSet)
+		{
+		case PixelKernels::InstructionSet::SSE: return L"SSE";
+		case PixelKernels::InstructionSet::AVX2: return L"AVX2";
+		default: return L"Scalar";
+		}
+	}
+
+	bool SamePixels(const std::vector<float>& a, const std::vector<float>& b)
+	{
+		return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+	}
+}
+
+namespace FireRenderUnitTests
+{
+	TEST_CLASS(PixelKernelsTests)
+	{
+	public:
+		TEST_METHOD_CLEANUP(RestoreInstructionSet)
+		{
+			PixelKernels::SetInstructionSet(PixelKernels::GetSupportedInstructionSet());
+		}
+
+		TEST_METHOD(CopyRegionMatchesReference)
+		{
+			std::vector<float> source = RandomPixels(FrameWidth * FrameHeight, 1);
+
+			for (const RenderRegion& region : { SubRegion, RenderRegion(FrameWidth, FrameHeight) })
+			{
+				std::vector<float> expected(region.getArea() * 4);
+				CopyRegionReference(expected.data(), source.data(), FrameWidth, FrameHeight, region);
+
+				for (PixelKernels::InstructionSet instructionSet : SupportedInstructionSets())
+				{
+					PixelKernels::SetInstructionSet(instructionSet);
+
+					std::vector<float> actual(region.getArea() * 4);
+					PixelKernels::CopyRegion(actual.data(), source.data(), FrameWidth, FrameHeight, region);
+
+					Assert::IsTrue(SamePixels(expected, actual), InstructionSetName(instructionSet));
+				}
+			}
+		}
+
+		TEST_METHOD(FlipRegionMatchesReference)
+		{
+			std::vector<float> source = RandomPixels(FrameWidth * FrameHeight, 2);
+
+			for (const RenderRegion& region : { SubRegion, RenderRegion(FrameWidth, FrameHeight) })
+			{
+				std::vector<float> expected(region.getArea() * 4);
+				FlipRegionReference(expected.data(), source.data(), FrameWidth, FrameHeight, region);
+
+				for (PixelKernels::InstructionSet instructionSet : SupportedInstructionSets())
+				{
+					PixelKernels::SetInstructionSet(instructionSet);
+
+					std::vector<float> actual(region.getArea() * 4);
+					PixelKernels::FlipRegion(actual.data(), source.data(), FrameWidth, FrameHeight, region);
+
+					Assert::IsTrue(SamePixels(expected, actual), InstructionSetName(instructionSet));
+				}
+			}
+		}
+
+		TEST_METHOD(PasteRegionMatchesReference)
+		{
+			std::vector<float> frame = RandomPixels(FrameWidth * FrameHeight, 3);
+			std::vector<float> source = RandomPixels(SubRegion.getArea(), 4);
+
+			std::vector<float> expected = frame;
+			PasteRegionReference(expected.data(), source.data(), FrameWidth, FrameHeight, SubRegion);
+
+			for (PixelKernels::InstructionSet instructionSet : SupportedInstructionSets())
+			{
+				PixelKernels::SetInstructionSet(instructionSet);
+
+				std::vector<float> actual = frame;
+				PixelKernels::PasteRegion(actual.data(), source.data(), FrameWidth, FrameHeight, SubRegion);
+
+				Assert::IsTrue(SamePixels(expected, actual), InstructionSetName(instructionSet));
+			}
+		}
+
+		TEST_METHOD(MergeOpacityMatchesReference)
+		{
+			// Not a multiple of the vector width
+			const size_t pixelCount = FrameWidth * FrameHeight;
+
+			std::vector<float> pixels = RandomPixels(pixelCount, 5);
+			std::vector<float> opacity = RandomPixels(pixelCount, 6);
+
+			std::vector<float> expected = pixels;
+			MergeOpacityReference(expected.data(), opacity.data(), pixelCount);
+
+			for (PixelKernels::InstructionSet instructionSet : SupportedInstructionSets())
+			{
+				PixelKernels::SetInstructionSet(instructionSet);
+
+				std::vector<float> actual = pixels;
+				PixelKernels::MergeOpacity(actual.data(), opacity.data(), pixelCount);
+
+				Assert::IsTrue(SamePixels(expected, actual), InstructionSetName(instructionSet));
+			}
+		}
+
+		TEST_METHOD(SetInstructionSetIsClampedToSupported)
+		{
+			PixelKernels::SetInstructionSet(PixelKernels::InstructionSet::AVX2);
+
+			Assert::IsTrue(PixelKernels::GetInstructionSet() <= PixelKernels::GetSupportedInstructionSet());
+		}
+	};
+
+	TEST_CLASS(PixelKernelsBenchmark)
+	{
+	public:
+		BEGIN_TEST_CLASS_ATTRIBUTE()
+			TEST_CLASS_ATTRIBUTE(L"Category", L"Benchmark")
+		END_TEST_CLASS_ATTRIBUTE()
+
+		TEST_METHOD_CLEANUP(RestoreInstructionSet)
+		{
+			PixelKernels::SetInstructionSet(PixelKernels::GetSupportedInstructionSet());
+		}
+
+		TEST_METHOD(FrameBufferKernels)
+		{
+			const int iterations = 50;
+			const RenderRegion frameRegion(FrameWidth, FrameHeight);
+			const size_t pixelCount = frameRegion.getArea();
+
+			std::vector<float> source = RandomPixels(pixelCount, 7);
+			std::vector<float> opacity = RandomPixels(pixelCount, 8);
+			std::vector<float> dest(pixelCount * 4);
+
+			auto measure = [iterations](auto&& kernel)
+			{
+				kernel();
+
+				auto start = std::chrono::steady_clock::now();
+				for (int i = 0; i < iterations; i++)
+				{
+					kernel();
+				}
+
+				return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+			};
+
+			for (PixelKernels::InstructionSet instructionSet : SupportedInstructionSets())
+			{
+				PixelKernels::SetInstructionSet(instructionSet);
+
+				double copyMs = measure([&] { PixelKernels::CopyRegion(dest.data(), source.data(), FrameWidth, FrameHeight, frameRegion); });
+				double flipMs = measure([&] { PixelKernels::FlipRegion(dest.data(), source.data(), FrameWidth, FrameHeight, frameRegion); });
+				double pasteMs = measure([&] { PixelKernels::PasteRegion(dest.data(), source.data(), FrameWidth, FrameHeight, frameRegion); });
+				double mergeMs = measure([&] { PixelKernels::MergeOpacity(dest.data(), opacity.data(), pixelCount); });
+
+				std::wstring message = std::wstring(InstructionSetName(instructionSet)) +
+					L": copy " + std::to_wstring(copyMs) +
+					L" ms, flip " + std::to_wstring(flipMs) +
+					L" ms, paste " + std::to_wstring(pasteMs) +
+					L" ms, merge opacity " + std::to_wstring(mergeMs) + L" ms\n";
+
+				Logger::WriteMessage(message.c_str());
+			}
+		}
+	};
+}